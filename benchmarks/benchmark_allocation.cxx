@@ -0,0 +1,302 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <boost/atomic.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <cstdlib>
+
+/**
+ * \file benchmark_allocation.cxx
+ *
+ * \brief Measures the cost of creating datums and stamps.
+ *
+ * Every call to the global allocator is counted so that the number of system
+ * allocations per operation is reported alongside the time.
+ */
+
+#if __cplusplus >= 201103L
+#define THROWS_BAD_ALLOC
+#define THROWS_NOTHING noexcept
+#else
+#define THROWS_BAD_ALLOC throw (std::bad_alloc)
+#define THROWS_NOTHING throw ()
+#endif
+
+static boost::atomic<uint64_t> allocation_count(0);
+
+void*
+operator new (size_t size) THROWS_BAD_ALLOC
+{
+  ++allocation_count;
+
+  void* const ptr = std::malloc(size ? size : 1);
+
+  if (!ptr)
+  {
+    throw std::bad_alloc();
+  }
+
+  return ptr;
+}
+
+void
+operator delete (void* ptr) THROWS_NOTHING
+{
+  std::free(ptr);
+}
+
+namespace
+{
+
+typedef boost::chrono::steady_clock clock_type;
+typedef uint64_t count_t;
+
+class measurement
+{
+  public:
+    measurement();
+    ~measurement();
+
+    void report(std::string const& name, count_t ops) const;
+  private:
+    clock_type::time_point const m_start;
+    uint64_t const m_allocations;
+};
+
+// A stand-in for the previous layout where each object and its reference
+// count were separate heap allocations.
+class reference_object
+{
+  public:
+    reference_object(uint64_t value_);
+    ~reference_object();
+
+    uint64_t const value;
+    uint64_t const padding;
+};
+
+}
+
+static void benchmark_reference(count_t count);
+static void benchmark_stamp(count_t count);
+static void benchmark_datum(count_t count);
+static void benchmark_control_datum(count_t count);
+static void benchmark_edge_handoff(count_t count);
+
+int
+main(int argc, char* argv[])
+{
+  count_t count = 1000000;
+
+  if (1 < argc)
+  {
+    count = boost::lexical_cast<count_t>(argv[1]);
+  }
+
+  std::cout << std::left << std::setw(24) << "benchmark"
+            << std::right << std::setw(12) << "ops"
+            << std::setw(12) << "ns/op"
+            << std::setw(12) << "allocs/op"
+            << std::endl;
+
+  benchmark_reference(count);
+  benchmark_stamp(count);
+  benchmark_datum(count);
+  benchmark_control_datum(count);
+  benchmark_edge_handoff(count);
+
+  return EXIT_SUCCESS;
+}
+
+void
+benchmark_reference(count_t count)
+{
+  measurement const m;
+
+  for (count_t i = 0; i < count; ++i)
+  {
+    boost::shared_ptr<reference_object const> const obj(new reference_object(i));
+
+    (void)obj;
+  }
+
+  m.report("shared_ptr(new T)", count);
+}
+
+void
+benchmark_stamp(count_t count)
+{
+  sprokit::stamp_t st = sprokit::stamp::new_stamp(1);
+
+  measurement const m;
+
+  for (count_t i = 0; i < count; ++i)
+  {
+    st = sprokit::stamp::incremented_stamp(st);
+  }
+
+  m.report("incremented_stamp", count);
+}
+
+void
+benchmark_datum(count_t count)
+{
+  measurement const m;
+
+  for (count_t i = 0; i < count; ++i)
+  {
+    sprokit::datum_t const dat = sprokit::datum::new_datum<count_t>(i);
+
+    (void)dat;
+  }
+
+  m.report("new_datum<uint64_t>", count);
+}
+
+void
+benchmark_control_datum(count_t count)
+{
+  measurement const m;
+
+  for (count_t i = 0; i < count; ++i)
+  {
+    sprokit::datum_t const dat = sprokit::datum::empty_datum();
+
+    (void)dat;
+  }
+
+  m.report("empty_datum", count);
+}
+
+static void produce(sprokit::edge_t const& edge, count_t count);
+static void consume(sprokit::edge_t const& edge, count_t count);
+
+void
+benchmark_edge_handoff(count_t count)
+{
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value(sprokit::edge::config_capacity, "64");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(conf);
+
+  measurement const m;
+
+  boost::thread producer(boost::bind(&produce, edge, count));
+  boost::thread consumer(boost::bind(&consume, edge, count));
+
+  producer.join();
+  consumer.join();
+
+  m.report("edge handoff (2 threads)", count);
+}
+
+void
+produce(sprokit::edge_t const& edge, count_t count)
+{
+  sprokit::stamp_t st = sprokit::stamp::new_stamp(1);
+
+  for (count_t i = 0; i < count; ++i)
+  {
+    sprokit::datum_t const dat = sprokit::datum::new_datum<count_t>(i);
+
+    edge->push_datum(sprokit::edge_datum_t(dat, st));
+
+    st = sprokit::stamp::incremented_stamp(st);
+  }
+}
+
+void
+consume(sprokit::edge_t const& edge, count_t count)
+{
+  for (count_t i = 0; i < count; ++i)
+  {
+    sprokit::edge_datum_t const edat = edge->get_datum();
+
+    (void)edat;
+  }
+}
+
+measurement
+::measurement()
+  : m_start(clock_type::now())
+  , m_allocations(allocation_count.load())
+{
+}
+
+measurement
+::~measurement()
+{
+}
+
+void
+measurement
+::report(std::string const& name, count_t ops) const
+{
+  clock_type::duration const elapsed = clock_type::now() - m_start;
+  uint64_t const allocations = allocation_count.load() - m_allocations;
+
+  double const ns = boost::chrono::duration_cast<boost::chrono::nanoseconds>(elapsed).count();
+
+  std::cout << std::left << std::setw(24) << name
+            << std::right << std::setw(12) << ops
+            << std::setw(12) << std::fixed << std::setprecision(1) << (ns / ops)
+            << std::setw(12) << std::setprecision(3) << (double(allocations) / ops)
+            << std::endl;
+}
+
+reference_object
+::reference_object(uint64_t value_)
+  : value(value_)
+  , padding(0)
+{
+}
+
+reference_object
+::~reference_object()
+{
+}
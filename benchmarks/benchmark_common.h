@@ -0,0 +1,166 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_BENCHMARKS_BENCHMARK_COMMON_H
+#define SPROKIT_BENCHMARKS_BENCHMARK_COMMON_H
+
+#include <boost/chrono/chrono.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+/**
+ * \file benchmark_common.h
+ *
+ * \brief Timing and reporting shared by the benchmarks.
+ */
+
+typedef boost::chrono::steady_clock benchmark_clock_t;
+typedef boost::uint64_t count_t;
+typedef boost::uint64_t nanoseconds_t;
+typedef std::vector<nanoseconds_t> latencies_t;
+
+inline
+nanoseconds_t
+benchmark_now()
+{
+  benchmark_clock_t::duration const now = benchmark_clock_t::now().time_since_epoch();
+
+  return nanoseconds_t(boost::chrono::duration_cast<boost::chrono::nanoseconds>(now).count());
+}
+
+class stopwatch
+{
+  public:
+    stopwatch()
+      : m_start(benchmark_now())
+    {
+    }
+
+    nanoseconds_t elapsed() const
+    {
+      return (benchmark_now() - m_start);
+    }
+  private:
+    nanoseconds_t const m_start;
+};
+
+inline
+nanoseconds_t
+percentile(latencies_t const& sorted, double pct)
+{
+  if (sorted.empty())
+  {
+    return 0;
+  }
+
+  size_t const idx = size_t(pct * double(sorted.size() - 1) / 100.);
+
+  return sorted[idx];
+}
+
+inline
+count_t
+count_from_args(int argc, char* argv[], count_t def)
+{
+  if (1 < argc)
+  {
+    return boost::lexical_cast<count_t>(argv[1]);
+  }
+
+  return def;
+}
+
+inline
+void
+print_header()
+{
+  std::cout << std::left << std::setw(40) << "benchmark"
+            << std::right << std::setw(8) << "threads"
+            << std::setw(10) << "ops"
+            << std::setw(10) << "ns/op"
+            << std::setw(10) << "Mops/s"
+            << std::setw(10) << "p50 ns"
+            << std::setw(10) << "p90 ns"
+            << std::setw(10) << "p99 ns"
+            << std::setw(12) << "p99.9 ns"
+            << std::endl;
+}
+
+/**
+ * \brief Print a row of results.
+ *
+ * \param name The name of the benchmark.
+ * \param threads The number of threads used.
+ * \param ops The number of operations completed.
+ * \param elapsed The wall time taken for all operations.
+ * \param latencies Per-operation latencies; sorted in place if given.
+ */
+inline
+void
+report(std::string const& name, size_t threads, count_t ops, nanoseconds_t elapsed, latencies_t* latencies = NULL)
+{
+  double const ns_per_op = (ops ? (double(elapsed) / double(ops)) : 0.);
+  double const mops = (elapsed ? (double(ops) * 1e3 / double(elapsed)) : 0.);
+
+  std::cout << std::left << std::setw(40) << name
+            << std::right << std::setw(8) << threads
+            << std::setw(10) << ops
+            << std::setw(10) << std::fixed << std::setprecision(1) << ns_per_op
+            << std::setw(10) << std::setprecision(3) << mops;
+
+  if (latencies && !latencies->empty())
+  {
+    std::sort(latencies->begin(), latencies->end());
+
+    std::cout << std::setw(10) << percentile(*latencies, 50.)
+              << std::setw(10) << percentile(*latencies, 90.)
+              << std::setw(10) << percentile(*latencies, 99.)
+              << std::setw(12) << percentile(*latencies, 99.9);
+  }
+  else
+  {
+    std::cout << std::setw(10) << "-"
+              << std::setw(10) << "-"
+              << std::setw(10) << "-"
+              << std::setw(12) << "-";
+  }
+
+  std::cout << std::endl;
+}
+
+#endif // SPROKIT_BENCHMARKS_BENCHMARK_COMMON_H
@@ -0,0 +1,203 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark_common.h"
+
+#include <sprokit/pipeline_util/load_pipe.h>
+#include <sprokit/pipeline_util/pipe_bakery.h>
+#include <sprokit/pipeline_util/pipe_declaration_types.h>
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+/**
+ * \file benchmark_config.cxx
+ *
+ * \brief Measures baking pipelines with many configuration keys.
+ *
+ * A pipeline of many processes with many configuration values each is baked
+ * from its declaration. The configuration is then read the way processes read
+ * it: through a view of each process' block with typed reads of every key.
+ */
+
+static size_t const keys_per_process = 20;
+static size_t const read_passes = 10;
+
+static std::string process_name(size_t i);
+static std::string key_name(size_t i);
+static std::string pipe_text(size_t processes);
+
+int
+main(int argc, char* argv[])
+{
+  size_t const processes = size_t(count_from_args(argc, argv, 1000));
+  size_t const keys = (processes * keys_per_process);
+
+  sprokit::load_known_modules();
+
+  std::istringstream istr(pipe_text(processes));
+
+  sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks(istr);
+
+  print_header();
+
+  {
+    stopwatch const watch;
+
+    sprokit::pipeline_t const pipe = sprokit::bake_pipe_blocks(blocks);
+
+    report("config bake", 1, keys, watch.elapsed());
+
+    if (pipe->process_names().size() != processes)
+    {
+      std::cerr << "Baking did not create every process" << std::endl;
+    }
+  }
+
+  sprokit::config_t const conf = sprokit::extract_configuration(blocks);
+
+  std::vector<sprokit::config_t> views;
+
+  {
+    stopwatch const watch;
+
+    for (size_t i = 0; i < processes; ++i)
+    {
+      views.push_back(conf->subblock_view(process_name(i)));
+    }
+
+    report("config view", 1, processes, watch.elapsed());
+  }
+
+  std::vector<std::string> key_names;
+
+  for (size_t i = 0; i < keys_per_process; ++i)
+  {
+    key_names.push_back(key_name(i));
+  }
+
+  {
+    size_t sum = 0;
+
+    stopwatch const watch;
+
+    for (size_t pass = 0; pass < read_passes; ++pass)
+    {
+      BOOST_FOREACH (sprokit::config_t const& view, views)
+      {
+        BOOST_FOREACH (std::string const& key, key_names)
+        {
+          sum += view->get_value<size_t>(key);
+        }
+      }
+    }
+
+    nanoseconds_t const elapsed = watch.elapsed();
+
+    size_t const expected = (read_passes * processes * keys_per_process * (keys_per_process - 1) / 2);
+
+    if (sum != expected)
+    {
+      std::cerr << "Typed reads summed to " << sum << " "
+                   "instead of " << expected << std::endl;
+    }
+
+    report("config typed read", 1, (read_passes * keys), elapsed);
+  }
+
+  {
+    size_t found = 0;
+
+    stopwatch const watch;
+
+    BOOST_FOREACH (sprokit::config_t const& view, views)
+    {
+      found += view->available_values().size();
+    }
+
+    nanoseconds_t const elapsed = watch.elapsed();
+
+    // Each process also has the values for the numbers process.
+    if (found != (keys + (2 * processes)))
+    {
+      std::cerr << "Views listed " << found << " keys" << std::endl;
+    }
+
+    report("config list", 1, processes, elapsed);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+std::string
+process_name(size_t i)
+{
+  return ("proc" + boost::lexical_cast<std::string>(i));
+}
+
+std::string
+key_name(size_t i)
+{
+  return ("key" + boost::lexical_cast<std::string>(i));
+}
+
+std::string
+pipe_text(size_t processes)
+{
+  std::ostringstream sstr;
+
+  for (size_t i = 0; i < processes; ++i)
+  {
+    sstr << "process " << process_name(i) << std::endl;
+    sstr << "  :: numbers" << std::endl;
+    sstr << "  :start 0" << std::endl;
+    sstr << "  :end " << i << std::endl;
+
+    for (size_t j = 0; j < keys_per_process; ++j)
+    {
+      sstr << "  :" << key_name(j) << " " << j << std::endl;
+    }
+
+    sstr << std::endl;
+  }
+
+  return sstr.str();
+}
@@ -0,0 +1,247 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark_common.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/ref.hpp>
+
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+/**
+ * \file benchmark_edge.cxx
+ *
+ * \brief Measures the throughput and latency of moving data through edges.
+ *
+ * Each datum carries the time at which it was pushed so that the consumer can
+ * record the time it spent within the edge.
+ */
+
+static size_t const batch_size = 64;
+static size_t const max_pairs = 8;
+
+static sprokit::edge_t create_edge(bool lock_free);
+
+static void benchmark_uncontended(count_t count, bool lock_free);
+static void benchmark_uncontended_batched(count_t count, bool lock_free);
+static void benchmark_contended(count_t count, bool lock_free);
+static void benchmark_scaling(count_t count, bool lock_free, size_t pairs);
+
+int
+main(int argc, char* argv[])
+{
+  count_t const count = count_from_args(argc, argv, 1000000);
+
+  print_header();
+
+  for (int i = 0; i < 2; ++i)
+  {
+    bool const lock_free = (i != 0);
+
+    benchmark_uncontended(count, lock_free);
+    benchmark_uncontended_batched(count, lock_free);
+    benchmark_contended(count, lock_free);
+
+    for (size_t pairs = 1; pairs <= max_pairs; pairs *= 2)
+    {
+      benchmark_scaling(count, lock_free, pairs);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static std::string edge_name(std::string const& name, bool lock_free);
+
+void
+benchmark_uncontended(count_t count, bool lock_free)
+{
+  sprokit::edge_t const edge = create_edge(lock_free);
+  sprokit::datum_t const dat = sprokit::datum::new_datum<count_t>(0);
+  sprokit::stamp_t const st = sprokit::stamp::new_stamp(1);
+  sprokit::edge_datum_t const edat(dat, st);
+
+  stopwatch const watch;
+
+  for (count_t i = 0; i < count; ++i)
+  {
+    edge->push_datum(edat);
+
+    sprokit::edge_datum_t const out = edge->get_datum();
+
+    (void)out;
+  }
+
+  report(edge_name("push/get", lock_free), 1, count, watch.elapsed());
+}
+
+void
+benchmark_uncontended_batched(count_t count, bool lock_free)
+{
+  sprokit::edge_t const edge = create_edge(lock_free);
+  sprokit::datum_t const dat = sprokit::datum::new_datum<count_t>(0);
+  sprokit::stamp_t const st = sprokit::stamp::new_stamp(1);
+  sprokit::edge_data_t const data(batch_size, sprokit::edge_datum_t(dat, st));
+
+  count_t const batches = count / batch_size;
+
+  stopwatch const watch;
+
+  for (count_t i = 0; i < batches; ++i)
+  {
+    edge->push_data(data);
+
+    sprokit::edge_data_t const out = edge->get_data(batch_size);
+
+    (void)out;
+  }
+
+  std::string const name = "push_data/get_data x" + boost::lexical_cast<std::string>(batch_size);
+
+  report(edge_name(name, lock_free), 1, batches * batch_size, watch.elapsed());
+}
+
+static void produce(sprokit::edge_t const& edge, count_t count);
+static void consume(sprokit::edge_t const& edge, count_t count, latencies_t& latencies);
+
+void
+benchmark_contended(count_t count, bool lock_free)
+{
+  sprokit::edge_t const edge = create_edge(lock_free);
+
+  latencies_t latencies;
+
+  latencies.reserve(count);
+
+  stopwatch const watch;
+
+  boost::thread producer(boost::bind(&produce, edge, count));
+  boost::thread consumer(boost::bind(&consume, edge, count, boost::ref(latencies)));
+
+  producer.join();
+  consumer.join();
+
+  report(edge_name("producer/consumer", lock_free), 2, count, watch.elapsed(), &latencies);
+}
+
+void
+benchmark_scaling(count_t count, bool lock_free, size_t pairs)
+{
+  std::vector<sprokit::edge_t> edges;
+  std::vector<latencies_t> latencies(pairs);
+
+  for (size_t i = 0; i < pairs; ++i)
+  {
+    edges.push_back(create_edge(lock_free));
+    latencies[i].reserve(count);
+  }
+
+  boost::thread_group threads;
+
+  stopwatch const watch;
+
+  for (size_t i = 0; i < pairs; ++i)
+  {
+    threads.create_thread(boost::bind(&produce, edges[i], count));
+    threads.create_thread(boost::bind(&consume, edges[i], count, boost::ref(latencies[i])));
+  }
+
+  threads.join_all();
+
+  nanoseconds_t const elapsed = watch.elapsed();
+
+  latencies_t all_latencies;
+
+  all_latencies.reserve(pairs * count);
+
+  for (size_t i = 0; i < pairs; ++i)
+  {
+    all_latencies.insert(all_latencies.end(), latencies[i].begin(), latencies[i].end());
+  }
+
+  std::string const name = "independent pairs x" + boost::lexical_cast<std::string>(pairs);
+
+  report(edge_name(name, lock_free), 2 * pairs, pairs * count, elapsed, &all_latencies);
+}
+
+void
+produce(sprokit::edge_t const& edge, count_t count)
+{
+  sprokit::stamp_t st = sprokit::stamp::new_stamp(1);
+
+  for (count_t i = 0; i < count; ++i)
+  {
+    sprokit::datum_t const dat = sprokit::datum::new_datum<nanoseconds_t>(benchmark_now());
+
+    edge->push_datum(sprokit::edge_datum_t(dat, st));
+
+    st = sprokit::stamp::incremented_stamp(st);
+  }
+}
+
+void
+consume(sprokit::edge_t const& edge, count_t count, latencies_t& latencies)
+{
+  for (count_t i = 0; i < count; ++i)
+  {
+    sprokit::edge_datum_t const edat = edge->get_datum();
+    nanoseconds_t const pushed = edat.datum->get_datum<nanoseconds_t>();
+
+    latencies.push_back(benchmark_now() - pushed);
+  }
+}
+
+sprokit::edge_t
+create_edge(bool lock_free)
+{
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value(sprokit::edge::config_capacity, boost::lexical_cast<sprokit::config::value_t>(batch_size));
+  conf->set_value(sprokit::edge::config_lock_free, (lock_free ? "true" : "false"));
+
+  return boost::make_shared<sprokit::edge>(conf);
+}
+
+std::string
+edge_name(std::string const& name, bool lock_free)
+{
+  return ((lock_free ? "lock_free " : "mutex ") + name);
+}
@@ -0,0 +1,463 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark_common.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/process_cluster.h>
+#include <sprokit/pipeline/process_registry.h>
+#include <sprokit/pipeline/scheduler.h>
+#include <sprokit/pipeline/scheduler_exception.h>
+#include <sprokit/pipeline/scheduler_registry.h>
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/ref.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+/**
+ * \file benchmark_pipeline.cxx
+ *
+ * \brief Measures end-to-end throughput and latency of synthetic pipelines.
+ *
+ * Every registered scheduler is run over a linear chain, a wide fan-out and
+ * fan-in through \c distribute and \c collate, and deeply nested clusters.
+ * The source records when each datum is emitted and the sink records how
+ * long it took to arrive.
+ */
+
+namespace
+{
+
+class latency_record
+{
+  public:
+    latency_record(count_t count);
+    ~latency_record();
+
+    latencies_t emitted;
+    latencies_t latencies;
+};
+
+class latency_source
+  : public sprokit::process
+{
+  public:
+    latency_source(sprokit::config_t const& config, latency_record& record);
+    ~latency_source();
+  protected:
+    void _step();
+  private:
+    latency_record& m_record;
+    int32_t m_current;
+};
+
+class latency_sink
+  : public sprokit::process
+{
+  public:
+    latency_sink(sprokit::config_t const& config, latency_record& record);
+    ~latency_sink();
+  protected:
+    void _step();
+  private:
+    latency_record& m_record;
+};
+
+class benchmark_cluster
+  : public sprokit::process_cluster
+{
+  public:
+    benchmark_cluster(sprokit::config_t const& config);
+    ~benchmark_cluster();
+
+    static type_t const type;
+    static sprokit::config::key_t const config_depth;
+};
+
+typedef boost::function<void (sprokit::pipeline_t const&)> topology_t;
+
+}
+
+static size_t const edge_capacity = 16;
+static size_t const chain_length = 8;
+static size_t const fan_width = 8;
+static size_t const cluster_depth = 8;
+static size_t const max_threads = 8;
+
+static sprokit::process::name_t const source_name = sprokit::process::name_t("source");
+static sprokit::process::name_t const sink_name = sprokit::process::name_t("sink");
+static sprokit::process::port_t const pass_port = sprokit::process::port_t("pass");
+
+static void benchmark_scheduler(count_t count, sprokit::scheduler_registry::type_t const& type);
+static void benchmark_topology(count_t count, sprokit::scheduler_registry::type_t const& type,
+                               sprokit::config_t const& conf, size_t threads,
+                               std::string const& name, topology_t const& topology);
+
+static void linear_chain(sprokit::pipeline_t const& pipe, size_t length);
+static void fan_out_in(sprokit::pipeline_t const& pipe, size_t width);
+static void nested_clusters(sprokit::pipeline_t const& pipe, size_t depth);
+
+int
+main(int argc, char* argv[])
+{
+  count_t const count = count_from_args(argc, argv, 100000);
+
+  sprokit::load_known_modules();
+
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  reg->register_process(benchmark_cluster::type, "A cluster of nested clusters.", sprokit::create_process<benchmark_cluster>);
+
+  print_header();
+
+  sprokit::scheduler_registry::types_t const types = sprokit::scheduler_registry::self()->types();
+
+  BOOST_FOREACH (sprokit::scheduler_registry::type_t const& type, types)
+  {
+    benchmark_scheduler(count, type);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static std::string topology_name(std::string const& topology, size_t size, std::string const& scheduler);
+
+void
+benchmark_scheduler(count_t count, sprokit::scheduler_registry::type_t const& type)
+{
+  typedef std::pair<topology_t, std::string> named_topology_t;
+  typedef std::vector<named_topology_t> topologies_t;
+
+  topologies_t topologies;
+
+  topologies.push_back(named_topology_t(boost::bind(&linear_chain, _1, chain_length),
+                                        topology_name("chain", chain_length, type)));
+  topologies.push_back(named_topology_t(boost::bind(&fan_out_in, _1, fan_width),
+                                        topology_name("fan", fan_width, type)));
+  topologies.push_back(named_topology_t(boost::bind(&nested_clusters, _1, cluster_depth),
+                                        topology_name("clusters", cluster_depth, type)));
+
+  BOOST_FOREACH (named_topology_t const& topology, topologies)
+  {
+    sprokit::config_t const conf = sprokit::config::empty_config();
+
+    if (type == "thread_pool")
+    {
+      // Report a scaling curve over the size of the pool.
+      for (size_t threads = 1; threads <= max_threads; threads *= 2)
+      {
+        conf->set_value("num_threads", boost::lexical_cast<sprokit::config::value_t>(threads));
+
+        benchmark_topology(count, type, conf, threads, topology.second, topology.first);
+      }
+    }
+    else
+    {
+      // Other schedulers are assumed to use a thread for each process.
+      size_t const threads = ((type == "sync") ? 1 : 0);
+
+      benchmark_topology(count, type, conf, threads, topology.second, topology.first);
+    }
+  }
+}
+
+void
+benchmark_topology(count_t count, sprokit::scheduler_registry::type_t const& type,
+                   sprokit::config_t const& conf, size_t threads,
+                   std::string const& name, topology_t const& topology)
+{
+  latency_record record(count);
+
+  sprokit::config_t const pipe_conf = sprokit::config::empty_config();
+
+  pipe_conf->set_value(sprokit::config::key_t("_edge") + sprokit::config::block_sep + sprokit::edge::config_capacity,
+                       boost::lexical_cast<sprokit::config::value_t>(edge_capacity));
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(pipe_conf);
+
+  sprokit::config_t const source_conf = sprokit::config::empty_config();
+  sprokit::config_t const sink_conf = sprokit::config::empty_config();
+
+  source_conf->set_value(sprokit::process::config_name, source_name);
+  sink_conf->set_value(sprokit::process::config_name, sink_name);
+
+  pipe->add_process(boost::make_shared<latency_source>(source_conf, boost::ref(record)));
+  pipe->add_process(boost::make_shared<latency_sink>(sink_conf, boost::ref(record)));
+
+  topology(pipe);
+
+  pipe->setup_pipeline();
+
+  if (!threads)
+  {
+    threads = pipe->process_names().size();
+  }
+
+  sprokit::scheduler_t scheduler;
+
+  try
+  {
+    scheduler = sprokit::scheduler_registry::self()->create_scheduler(type, pipe, conf);
+  }
+  catch (sprokit::incompatible_pipeline_exception const&)
+  {
+    std::cout << std::left << std::setw(40) << name
+              << " (not supported by the scheduler)" << std::endl;
+
+    return;
+  }
+
+  stopwatch const watch;
+
+  scheduler->start();
+  scheduler->wait();
+
+  report(name, threads, count, watch.elapsed(), &record.latencies);
+}
+
+void
+linear_chain(sprokit::pipeline_t const& pipe, size_t length)
+{
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::name_t upstream = source_name;
+  sprokit::process::port_t upstream_port = sprokit::process::port_t("number");
+
+  for (size_t i = 0; i < length; ++i)
+  {
+    sprokit::process::name_t const name = "pass" + boost::lexical_cast<sprokit::process::name_t>(i);
+
+    pipe->add_process(reg->create_process("pass", name));
+    pipe->connect(upstream, upstream_port,
+                  name, pass_port);
+
+    upstream = name;
+    upstream_port = pass_port;
+  }
+
+  pipe->connect(upstream, upstream_port,
+                sink_name, sprokit::process::port_t("number"));
+}
+
+void
+fan_out_in(sprokit::pipeline_t const& pipe, size_t width)
+{
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::name_t const dist_name = sprokit::process::name_t("distribute");
+  sprokit::process::name_t const coll_name = sprokit::process::name_t("collate");
+
+  pipe->add_process(reg->create_process("distribute", dist_name));
+  pipe->add_process(reg->create_process("collate", coll_name));
+
+  // The status port must be connected first so the tag is known.
+  pipe->connect(dist_name, "status/a",
+                coll_name, "status/a");
+  pipe->connect(source_name, "number",
+                dist_name, "src/a");
+
+  for (size_t i = 0; i < width; ++i)
+  {
+    std::string const group = boost::lexical_cast<std::string>(i);
+    sprokit::process::name_t const name = "pass" + group;
+
+    pipe->add_process(reg->create_process("pass", name));
+    pipe->connect(dist_name, "dist/a/" + group,
+                  name, pass_port);
+    pipe->connect(name, pass_port,
+                  coll_name, "coll/a/" + group);
+  }
+
+  pipe->connect(coll_name, "res/a",
+                sink_name, "number");
+}
+
+void
+nested_clusters(sprokit::pipeline_t const& pipe, size_t depth)
+{
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::name_t const name = sprokit::process::name_t("cluster");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value(benchmark_cluster::config_depth, boost::lexical_cast<sprokit::config::value_t>(depth));
+
+  pipe->add_process(reg->create_process(benchmark_cluster::type, name, conf));
+  pipe->connect(source_name, "number",
+                name, pass_port);
+  pipe->connect(name, pass_port,
+                sink_name, "number");
+}
+
+std::string
+topology_name(std::string const& topology, size_t size, std::string const& scheduler)
+{
+  return (scheduler + " " + topology + " x" + boost::lexical_cast<std::string>(size));
+}
+
+latency_record
+::latency_record(count_t count)
+  : emitted(count)
+  , latencies()
+{
+  latencies.reserve(count);
+}
+
+latency_record
+::~latency_record()
+{
+}
+
+latency_source
+::latency_source(sprokit::config_t const& config, latency_record& record)
+  : sprokit::process(config)
+  , m_record(record)
+  , m_current(0)
+{
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_output_port("number", "integer", required, port_description_t("The sequence number of the datum."));
+}
+
+latency_source
+::~latency_source()
+{
+}
+
+void
+latency_source
+::_step()
+{
+  if (size_t(m_current) == m_record.emitted.size())
+  {
+    mark_process_as_complete();
+    push_datum_to_port("number", sprokit::datum::complete_datum());
+  }
+  else
+  {
+    m_record.emitted[m_current] = benchmark_now();
+    push_to_port_as<int32_t>("number", m_current);
+
+    ++m_current;
+  }
+
+  process::_step();
+}
+
+latency_sink
+::latency_sink(sprokit::config_t const& config, latency_record& record)
+  : sprokit::process(config)
+  , m_record(record)
+{
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_input_port("number", "integer", required, port_description_t("The sequence number of the datum."));
+}
+
+latency_sink
+::~latency_sink()
+{
+}
+
+void
+latency_sink
+::_step()
+{
+  int32_t const seq = grab_from_port_as<int32_t>("number");
+
+  m_record.latencies.push_back(benchmark_now() - m_record.emitted[seq]);
+
+  process::_step();
+}
+
+sprokit::process::type_t const benchmark_cluster::type = sprokit::process::type_t("benchmark_cluster");
+sprokit::config::key_t const benchmark_cluster::config_depth = sprokit::config::key_t("depth");
+
+benchmark_cluster
+::benchmark_cluster(sprokit::config_t const& config)
+  : sprokit::process_cluster(config)
+{
+  declare_configuration_key(
+    config_depth,
+    "1",
+    sprokit::config::description_t("The number of clusters to nest."));
+
+  port_flags_t const none;
+
+  declare_input_port(pass_port, type_any, none, port_description_t("The input to the innermost process."));
+  declare_output_port(pass_port, type_any, none, port_description_t("The output of the innermost process."));
+
+  size_t const depth = config->get_value<size_t>(config_depth, 1);
+
+  name_t const name = name_t("inner");
+
+  if (1 < depth)
+  {
+    sprokit::config_t const conf = sprokit::config::empty_config();
+
+    conf->set_value(config_depth, boost::lexical_cast<sprokit::config::value_t>(depth - 1));
+
+    add_process(name, type, conf);
+  }
+  else
+  {
+    add_process(name, "pass");
+  }
+
+  map_input(pass_port, name, pass_port);
+  map_output(pass_port, name, pass_port);
+}
+
+benchmark_cluster
+::~benchmark_cluster()
+{
+}
@@ -0,0 +1,241 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark_common.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/process_registry.h>
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/function.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+/**
+ * \file benchmark_setup.cxx
+ *
+ * \brief Measures building, setting up, and querying large pipelines.
+ *
+ * Synthetic pipelines of many processes are built, set up, and then every
+ * process is asked for its neighbors and edges. This is the work done by
+ * schedulers and tools before any data moves.
+ */
+
+namespace
+{
+
+typedef boost::function<void (sprokit::pipeline_t const&, size_t)> topology_t;
+
+}
+
+static sprokit::process::port_t const pass_port = sprokit::process::port_t("pass");
+
+static void benchmark_topology(size_t size, std::string const& name, topology_t const& topology);
+
+static void linear_chain(sprokit::pipeline_t const& pipe, size_t size);
+static void reduction_tree(sprokit::pipeline_t const& pipe, size_t size);
+
+int
+main(int argc, char* argv[])
+{
+  size_t const size = size_t(count_from_args(argc, argv, 10000));
+
+  sprokit::load_known_modules();
+
+  print_header();
+
+  // Smaller sizes show how the cost grows with the size of the pipeline.
+  for (size_t cur_size = 1000; cur_size <= size; cur_size *= 10)
+  {
+    benchmark_topology(cur_size, "chain", linear_chain);
+    benchmark_topology(cur_size, "tree", reduction_tree);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static std::string phase_name(std::string const& topology, size_t size, std::string const& phase);
+
+void
+benchmark_topology(size_t size, std::string const& name, topology_t const& topology)
+{
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>();
+
+  {
+    stopwatch const watch;
+
+    topology(pipe, size);
+
+    report(phase_name(name, size, "build"), 1, size, watch.elapsed());
+  }
+
+  {
+    stopwatch const watch;
+
+    pipe->setup_pipeline();
+
+    report(phase_name(name, size, "setup"), 1, size, watch.elapsed());
+  }
+
+  {
+    sprokit::process::names_t const names = pipe->process_names();
+
+    size_t found = 0;
+
+    stopwatch const watch;
+
+    BOOST_FOREACH (sprokit::process::name_t const& proc_name, names)
+    {
+      found += pipe->upstream_for_process(proc_name).size();
+      found += pipe->downstream_for_process(proc_name).size();
+      found += pipe->input_edges_for_process(proc_name).size();
+      found += pipe->output_edges_for_process(proc_name).size();
+    }
+
+    nanoseconds_t const elapsed = watch.elapsed();
+
+    // Every connection is seen from both ends as a process and as an edge.
+    if (found != (4 * (names.size() - 1)))
+    {
+      std::cerr << "Queries on the " << name << " pipeline found "
+                << found << " neighbors and edges" << std::endl;
+    }
+
+    report(phase_name(name, size, "query"), 1, names.size(), elapsed);
+  }
+}
+
+void
+linear_chain(sprokit::pipeline_t const& pipe, size_t size)
+{
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::name_t const source_name = sprokit::process::name_t("source");
+  sprokit::process::name_t const sink_name = sprokit::process::name_t("sink");
+
+  pipe->add_process(reg->create_process("numbers", source_name));
+  pipe->add_process(reg->create_process("sink", sink_name));
+
+  sprokit::process::name_t upstream = source_name;
+  sprokit::process::port_t upstream_port = sprokit::process::port_t("number");
+
+  // The types of the pass processes are only known once they are propagated
+  // from the source.
+  for (size_t i = 2; i < size; ++i)
+  {
+    sprokit::process::name_t const name = "pass" + boost::lexical_cast<sprokit::process::name_t>(i);
+
+    pipe->add_process(reg->create_process("pass", name));
+    pipe->connect(upstream, upstream_port,
+                  name, pass_port);
+
+    upstream = name;
+    upstream_port = pass_port;
+  }
+
+  pipe->connect(upstream, upstream_port,
+                sink_name, sprokit::process::port_t("sink"));
+}
+
+void
+reduction_tree(sprokit::pipeline_t const& pipe, size_t size)
+{
+  typedef std::vector<sprokit::process::port_addr_t> level_t;
+
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::port_t const number_port = sprokit::process::port_t("number");
+  sprokit::process::port_t const product_port = sprokit::process::port_t("product");
+
+  level_t level;
+
+  // A tree with n leaves has n - 1 inner nodes.
+  size_t const leaves = (size / 2);
+
+  for (size_t i = 0; i < leaves; ++i)
+  {
+    sprokit::process::name_t const name = "leaf" + boost::lexical_cast<sprokit::process::name_t>(i);
+
+    pipe->add_process(reg->create_process("numbers", name));
+
+    level.push_back(sprokit::process::port_addr_t(name, number_port));
+  }
+
+  size_t count = 0;
+
+  while (1 < level.size())
+  {
+    level_t next_level;
+
+    for (size_t i = 0; (i + 1) < level.size(); i += 2)
+    {
+      sprokit::process::name_t const name = "node" + boost::lexical_cast<sprokit::process::name_t>(count++);
+
+      pipe->add_process(reg->create_process("multiplication", name));
+      pipe->connect(level[i].first, level[i].second,
+                    name, sprokit::process::port_t("factor1"));
+      pipe->connect(level[i + 1].first, level[i + 1].second,
+                    name, sprokit::process::port_t("factor2"));
+
+      next_level.push_back(sprokit::process::port_addr_t(name, product_port));
+    }
+
+    // An odd process out waits for the next level.
+    if (level.size() % 2)
+    {
+      next_level.push_back(level.back());
+    }
+
+    level = next_level;
+  }
+
+  sprokit::process::name_t const sink_name = sprokit::process::name_t("sink");
+
+  pipe->add_process(reg->create_process("sink", sink_name));
+  pipe->connect(level[0].first, level[0].second,
+                sink_name, sprokit::process::port_t("sink"));
+}
+
+std::string
+phase_name(std::string const& topology, size_t size, std::string const& phase)
+{
+  return ("setup " + topology + " x" + boost::lexical_cast<std::string>(size) + " " + phase);
+}
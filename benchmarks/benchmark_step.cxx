@@ -0,0 +1,200 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark_common.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/process_registry.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+
+#include <string>
+
+#include <cstdlib>
+
+/**
+ * \file benchmark_step.cxx
+ *
+ * \brief Measures the overhead of \ref sprokit::process::step.
+ *
+ * The upstream and downstream processes are stepped separately so that only
+ * the steps of the process under test are timed.
+ */
+
+namespace
+{
+
+class step_process
+  : public sprokit::process
+{
+  public:
+    step_process(sprokit::config_t const& config, data_check_t check);
+    ~step_process();
+  protected:
+    void _step();
+};
+
+}
+
+static count_t const round_size = 1000;
+
+static void benchmark_step(count_t count, sprokit::process::data_check_t check, std::string const& name);
+
+int
+main(int argc, char* argv[])
+{
+  count_t const count = count_from_args(argc, argv, 1000000);
+
+  sprokit::load_known_modules();
+
+  print_header();
+
+  benchmark_step(count, sprokit::process::check_none, "step (check_none)");
+  benchmark_step(count, sprokit::process::check_sync, "step (check_sync)");
+  benchmark_step(count, sprokit::process::check_valid, "step (check_valid)");
+
+  return EXIT_SUCCESS;
+}
+
+static sprokit::process_t create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config = sprokit::config::empty_config());
+
+void
+benchmark_step(count_t count, sprokit::process::data_check_t check, std::string const& name)
+{
+  count_t const rounds = count / round_size;
+  count_t const steps = rounds * round_size;
+
+  sprokit::config_t const source_conf = sprokit::config::empty_config();
+
+  // The sources must never complete while being measured.
+  source_conf->set_value("start", "0");
+  source_conf->set_value("end", boost::lexical_cast<sprokit::config::value_t>(steps + 1));
+
+  sprokit::process_t const source1 = create_process("numbers", "source1", source_conf);
+  sprokit::process_t const source2 = create_process("numbers", "source2", source_conf);
+  sprokit::process_t const sink = create_process("sink", "sink");
+
+  sprokit::config_t const step_conf = sprokit::config::empty_config();
+
+  step_conf->set_value(sprokit::process::config_name, "step");
+
+  sprokit::process_t const proc = boost::make_shared<step_process>(step_conf, check);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipe->add_process(source1);
+  pipe->add_process(source2);
+  pipe->add_process(proc);
+  pipe->add_process(sink);
+
+  pipe->connect("source1", "number",
+                "step", "input1");
+  pipe->connect("source2", "number",
+                "step", "input2");
+  pipe->connect("step", "output",
+                "sink", "sink");
+
+  pipe->setup_pipeline();
+
+  nanoseconds_t elapsed = 0;
+
+  for (count_t r = 0; r < rounds; ++r)
+  {
+    for (count_t i = 0; i < round_size; ++i)
+    {
+      source1->step();
+      source2->step();
+    }
+
+    {
+      stopwatch const watch;
+
+      for (count_t i = 0; i < round_size; ++i)
+      {
+        proc->step();
+      }
+
+      elapsed += watch.elapsed();
+    }
+
+    for (count_t i = 0; i < round_size; ++i)
+    {
+      sink->step();
+    }
+  }
+
+  report(name, 1, steps, elapsed);
+}
+
+sprokit::process_t
+create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config)
+{
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  return reg->create_process(type, name, config);
+}
+
+step_process
+::step_process(sprokit::config_t const& config, data_check_t check)
+  : sprokit::process(config)
+{
+  set_data_checking_level(check);
+
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_input_port("input1", "integer", required, port_description_t("The first input."));
+  declare_input_port("input2", "integer", required, port_description_t("The second input."));
+  declare_output_port("output", "integer", required, port_description_t("The sum of the inputs."));
+}
+
+step_process
+::~step_process()
+{
+}
+
+void
+step_process
+::_step()
+{
+  int32_t const a = grab_from_port_as<int32_t>("input1");
+  int32_t const b = grab_from_port_as<int32_t>("input2");
+
+  push_to_port_as<int32_t>("output", a + b);
+
+  process::_step();
+}
@@ -77,9 +77,14 @@ BOOST_PYTHON_MODULE(edge)
       , "Returns True if the edge cannot hold anymore data, False otherwise.")
     .def("datum_count", &sprokit::edge::datum_count
       , "Returns the number of data packets within the edge.")
+    .def("buffered_bytes", &sprokit::edge::buffered_bytes
+      , "Returns the memory held by the data within the edge if it is counted.")
     .def("push_datum", &sprokit::edge::push_datum
       , (arg("datum"))
       , "Pushes a datum packet into the edge.")
+    .def("try_push_datum", &sprokit::edge::try_push_datum
+      , (arg("datum"))
+      , "Pushes a datum packet into the edge if it has space and returns True if it was accepted.")
     .def("get_datum", &sprokit::edge::get_datum
       , "Returns the next datum packet from the edge, removing it in the process.")
     .def("peek_datum", &sprokit::edge::peek_datum
@@ -99,5 +104,7 @@ BOOST_PYTHON_MODULE(edge)
       , "Returns True if the downstream process is complete, False otherwise.")
     .def_readonly("config_dependency", &sprokit::edge::config_dependency)
     .def_readonly("config_capacity", &sprokit::edge::config_capacity)
+    .def_readonly("config_capacity_bytes", &sprokit::edge::config_capacity_bytes)
+    .def_readonly("config_overflow_policy", &sprokit::edge::config_overflow_policy)
   ;
 }
@@ -32,6 +32,7 @@
 #include <sprokit/pipeline/process.h>
 #include <sprokit/pipeline/stamp.h>
 
+#include <sprokit/python/util/python_allow_threads.h>
 #include <sprokit/python/util/python_exceptions.h>
 #include <sprokit/python/util/python_gil.h>
 #include <sprokit/python/util/python_wrap_const_shared_ptr.h>
@@ -39,11 +40,13 @@
 
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 #include <boost/python/args.hpp>
+#include <boost/python/call.hpp>
 #include <boost/python/class.hpp>
 #include <boost/python/enum.hpp>
 #include <boost/python/implicit.hpp>
 #include <boost/python/module.hpp>
 #include <boost/python/operators.hpp>
+#include <boost/scoped_ptr.hpp>
 
 /**
  * \file process.cxx
@@ -55,6 +58,9 @@ using namespace boost::python;
 
 /// \todo How to do grab_input_as<>?
 
+static sprokit::process::frequency_component_t frequency_numerator(sprokit::process::port_frequency_t const& self);
+static sprokit::process::frequency_component_t frequency_denominator(sprokit::process::port_frequency_t const& self);
+
 class wrap_process
   : public sprokit::process
   , public wrapper<sprokit::process>
@@ -165,6 +171,14 @@ class wrap_process
     void _set_data_checking_level(data_check_t check);
 
     data_info_t _edge_data_info(sprokit::edge_data_t const& data);
+  private:
+    class priv;
+
+    void resolve_overrides();
+    bool may_override(int method) const;
+    object lookup_override(int method) const;
+
+    boost::scoped_ptr<priv> d;
 };
 
 BOOST_PYTHON_MODULE(process)
@@ -208,9 +222,9 @@ BOOST_PYTHON_MODULE(process)
     , no_init)
     .def(init<sprokit::process::frequency_component_t>())
     .def(init<sprokit::process::frequency_component_t, sprokit::process::frequency_component_t>())
-    .def("numerator", &sprokit::process::port_frequency_t::numerator
+    .def("numerator", &frequency_numerator
       , "The numerator of the frequency.")
-    .def("denominator", &sprokit::process::port_frequency_t::denominator
+    .def("denominator", &frequency_denominator
       , "The denominator of the frequency.")
     .def(self <  self)
     .def(self <= self)
@@ -294,6 +308,12 @@ BOOST_PYTHON_MODULE(process)
       , "Resets the process.")
     .def("step", &sprokit::process::step
       , "Steps the process for one iteration.")
+    .def("ready", &sprokit::process::ready
+      , "Returns True if the process can be stepped without blocking, False otherwise.")
+    .def("try_step", &sprokit::process::try_step
+      , "Steps the process if it is ready and returns True if it stepped.")
+    .def("is_reentrant", &sprokit::process::is_reentrant
+      , "Returns True if the process may be stepped from multiple threads at once, False otherwise.")
     .def("properties", &sprokit::process::properties
       , "Returns the properties on the process.")
     .def("connect_input_port", &sprokit::process::connect_input_port
@@ -333,9 +353,11 @@ BOOST_PYTHON_MODULE(process)
     .def_readonly("property_no_reentrancy", &sprokit::process::property_no_reentrancy)
     .def_readonly("property_unsync_input", &sprokit::process::property_unsync_input)
     .def_readonly("property_unsync_output", &sprokit::process::property_unsync_output)
+    .def_readonly("property_replicable", &sprokit::process::property_replicable)
     .def_readonly("port_heartbeat", &sprokit::process::port_heartbeat)
     .def_readonly("config_name", &sprokit::process::config_name)
     .def_readonly("config_type", &sprokit::process::config_type)
+    .def_readonly("config_replicas", &sprokit::process::config_replicas)
     .def_readonly("type_any", &sprokit::process::type_any)
     .def_readonly("type_none", &sprokit::process::type_none)
     .def_readonly("type_data_dependent", &sprokit::process::type_data_dependent)
@@ -503,9 +525,72 @@ BOOST_PYTHON_MODULE(process)
   ;
 }
 
+class wrap_process::priv
+{
+  public:
+    priv();
+    ~priv();
+
+    typedef enum
+    {
+      method_configure,
+      method_init,
+      method_reset,
+      method_flush,
+      method_step,
+      method_reconfigure,
+      method_properties,
+      method_input_ports,
+      method_output_ports,
+      method_input_port_info,
+      method_output_port_info,
+      method_set_input_port_type,
+      method_set_output_port_type,
+      method_available_config,
+      method_config_info,
+      method_count
+    } method_t;
+
+    typedef enum
+    {
+      // Look the override up on every call.
+      override_unknown,
+      // The Python class does not override the method.
+      override_none,
+      // The Python class overrides the method with the cached function.
+      override_function
+    } override_t;
+
+    static char const* const names[method_count];
+
+    override_t state[method_count];
+    // Unbound functions from the class; bound methods would keep the instance alive.
+    handle<> funcs[method_count];
+};
+
+char const* const wrap_process::priv::names[wrap_process::priv::method_count] =
+{
+  "_configure",
+  "_init",
+  "_reset",
+  "_flush",
+  "_step",
+  "_reconfigure",
+  "_properties",
+  "_input_ports",
+  "_output_ports",
+  "_input_port_info",
+  "_output_port_info",
+  "_set_input_port_type",
+  "_set_output_port_type",
+  "_available_config",
+  "_config_info"
+};
+
 wrap_process
 ::wrap_process(sprokit::config_t const& config)
   : sprokit::process(config)
+  , d(new priv)
 {
 }
 
@@ -514,6 +599,63 @@ wrap_process
 {
 }
 
+void
+wrap_process
+::resolve_overrides()
+{
+  sprokit::python::python_gil const gil;
+
+  (void)gil;
+
+  PyObject* const self = detail::wrapper_base_::get_owner(*this);
+
+  for (size_t i = 0; i < priv::method_count; ++i)
+  {
+    override const f = get_override(priv::names[i]);
+
+    d->funcs[i] = handle<>();
+
+    if (!f)
+    {
+      d->state[i] = priv::override_none;
+    }
+    else if (PyMethod_Check(f.ptr()) &&
+             (PyMethod_GET_SELF(f.ptr()) == self) &&
+             Py_TYPE(PyMethod_GET_FUNCTION(f.ptr()))->tp_descr_get)
+    {
+      d->funcs[i] = handle<>(borrowed(PyMethod_GET_FUNCTION(f.ptr())));
+      d->state[i] = priv::override_function;
+    }
+    else
+    {
+      // Instance attributes and other callables are not cached.
+      d->state[i] = priv::override_unknown;
+    }
+  }
+}
+
+bool
+wrap_process
+::may_override(int method) const
+{
+  return (d->state[method] != priv::override_none);
+}
+
+object
+wrap_process
+::lookup_override(int method) const
+{
+  if (d->state[method] == priv::override_function)
+  {
+    PyObject* const self = detail::wrapper_base_::get_owner(*this);
+    PyObject* const func = d->funcs[method].get();
+
+    return object(handle<>(Py_TYPE(func)->tp_descr_get(func, self, reinterpret_cast<PyObject*>(Py_TYPE(self)))));
+  }
+
+  return get_override(priv::names[method]);
+}
+
 void
 wrap_process
 ::_base_configure()
@@ -629,16 +771,19 @@ void
 wrap_process
 ::_configure()
 {
+  resolve_overrides();
+
+  if (may_override(priv::method_configure))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_configure");
+    object const f = lookup_override(priv::method_configure);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(call<void>(f.ptr()))
 
       return;
     }
@@ -651,16 +796,19 @@ void
 wrap_process
 ::_init()
 {
+  resolve_overrides();
+
+  if (may_override(priv::method_init))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_init");
+    object const f = lookup_override(priv::method_init);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(call<void>(f.ptr()))
 
       return;
     }
@@ -673,16 +821,17 @@ void
 wrap_process
 ::_reset()
 {
+  if (may_override(priv::method_reset))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_reset");
+    object const f = lookup_override(priv::method_reset);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(call<void>(f.ptr()))
 
       return;
     }
@@ -695,16 +844,17 @@ void
 wrap_process
 ::_flush()
 {
+  if (may_override(priv::method_flush))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_flush");
+    object const f = lookup_override(priv::method_flush);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(call<void>(f.ptr()))
 
       return;
     }
@@ -717,16 +867,17 @@ void
 wrap_process
 ::_step()
 {
+  if (may_override(priv::method_step))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_step");
+    object const f = lookup_override(priv::method_step);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(call<void>(f.ptr()))
 
       return;
     }
@@ -739,16 +890,17 @@ void
 wrap_process
 ::_reconfigure(sprokit::config_t const& conf)
 {
+  if (may_override(priv::method_reconfigure))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_reconfigure");
+    object const f = lookup_override(priv::method_reconfigure);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(f(conf))
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(call<void>(f.ptr(), conf))
 
       return;
     }
@@ -761,16 +913,17 @@ sprokit::process::properties_t
 wrap_process
 ::_properties() const
 {
+  if (may_override(priv::method_properties))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_properties");
+    object const f = lookup_override(priv::method_properties);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<properties_t>(f.ptr()))
     }
   }
 
@@ -781,16 +934,17 @@ sprokit::process::ports_t
 wrap_process
 ::_input_ports() const
 {
+  if (may_override(priv::method_input_ports))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_input_ports");
+    object const f = lookup_override(priv::method_input_ports);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<ports_t>(f.ptr()))
     }
   }
 
@@ -801,16 +955,17 @@ sprokit::process::ports_t
 wrap_process
 ::_output_ports() const
 {
+  if (may_override(priv::method_output_ports))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_output_ports");
+    object const f = lookup_override(priv::method_output_ports);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<ports_t>(f.ptr()))
     }
   }
 
@@ -821,16 +976,17 @@ sprokit::process::port_info_t
 wrap_process
 ::_input_port_info(port_t const& port)
 {
+  if (may_override(priv::method_input_port_info))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_input_port_info");
+    object const f = lookup_override(priv::method_input_port_info);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f(port))
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<port_info_t>(f.ptr(), port))
     }
   }
 
@@ -841,16 +997,17 @@ sprokit::process::port_info_t
 wrap_process
 ::_output_port_info(port_t const& port)
 {
+  if (may_override(priv::method_output_port_info))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_output_port_info");
+    object const f = lookup_override(priv::method_output_port_info);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f(port))
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<port_info_t>(f.ptr(), port))
     }
   }
 
@@ -861,16 +1018,17 @@ bool
 wrap_process
 ::_set_input_port_type(port_t const& port, port_type_t const& new_type)
 {
+  if (may_override(priv::method_set_input_port_type))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_set_input_port_type");
+    object const f = lookup_override(priv::method_set_input_port_type);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f(port, new_type))
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<bool>(f.ptr(), port, new_type))
     }
   }
 
@@ -881,16 +1039,17 @@ bool
 wrap_process
 ::_set_output_port_type(port_t const& port, port_type_t const& new_type)
 {
+  if (may_override(priv::method_set_output_port_type))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_set_output_port_type");
+    object const f = lookup_override(priv::method_set_output_port_type);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f(port, new_type))
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<bool>(f.ptr(), port, new_type))
     }
   }
 
@@ -901,16 +1060,17 @@ sprokit::config::keys_t
 wrap_process
 ::_available_config() const
 {
+  if (may_override(priv::method_available_config))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_available_config");
+    object const f = lookup_override(priv::method_available_config);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f())
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<sprokit::config::keys_t>(f.ptr()))
     }
   }
 
@@ -921,16 +1081,17 @@ sprokit::process::conf_info_t
 wrap_process
 ::_config_info(sprokit::config::key_t const& key)
 {
+  if (may_override(priv::method_config_info))
   {
     sprokit::python::python_gil const gil;
 
     (void)gil;
 
-    override const f = get_override("_config_info");
+    object const f = lookup_override(priv::method_config_info);
 
-    if (f)
+    if (!f.is_none())
     {
-      SPROKIT_PYTHON_HANDLE_EXCEPTION(return f(key))
+      SPROKIT_PYTHON_HANDLE_EXCEPTION(return call<conf_info_t>(f.ptr(), key))
     }
   }
 
@@ -1052,6 +1213,13 @@ sprokit::edge_datum_t
 wrap_process
 ::_peek_at_port(port_t const& port, size_t idx) const
 {
+  // The GIL may or may not be held here; make sure it is before releasing it.
+  sprokit::python::python_gil const gil;
+  sprokit::python::python_allow_threads const allow(true);
+
+  (void)gil;
+  (void)allow;
+
   return peek_at_port(port, idx);
 }
 
@@ -1059,6 +1227,12 @@ sprokit::datum_t
 wrap_process
 ::_peek_at_datum_on_port(port_t const& port, size_t idx) const
 {
+  sprokit::python::python_gil const gil;
+  sprokit::python::python_allow_threads const allow(true);
+
+  (void)gil;
+  (void)allow;
+
   return peek_at_datum_on_port(port, idx);
 }
 
@@ -1066,6 +1240,12 @@ sprokit::edge_datum_t
 wrap_process
 ::_grab_from_port(port_t const& port) const
 {
+  sprokit::python::python_gil const gil;
+  sprokit::python::python_allow_threads const allow(true);
+
+  (void)gil;
+  (void)allow;
+
   return grab_from_port(port);
 }
 
@@ -1073,6 +1253,12 @@ sprokit::datum_t
 wrap_process
 ::_grab_datum_from_port(port_t const& port) const
 {
+  sprokit::python::python_gil const gil;
+  sprokit::python::python_allow_threads const allow(true);
+
+  (void)gil;
+  (void)allow;
+
   return grab_datum_from_port(port);
 }
 
@@ -1081,10 +1267,14 @@ wrap_process
 ::_grab_value_from_port(port_t const& port) const
 {
   sprokit::python::python_gil const gil;
+  sprokit::python::python_allow_threads allow(true);
 
   (void)gil;
 
   sprokit::datum_t const dat = grab_datum_from_port(port);
+
+  allow.release();
+
   boost::any const any = dat->get_datum<boost::any>();
 
   return object(any);
@@ -1094,6 +1284,12 @@ void
 wrap_process
 ::_push_to_port(port_t const& port, sprokit::edge_datum_t const& dat) const
 {
+  sprokit::python::python_gil const gil;
+  sprokit::python::python_allow_threads const allow(true);
+
+  (void)gil;
+  (void)allow;
+
   return push_to_port(port, dat);
 }
 
@@ -1101,6 +1297,12 @@ void
 wrap_process
 ::_push_datum_to_port(port_t const& port, sprokit::datum_t const& dat) const
 {
+  sprokit::python::python_gil const gil;
+  sprokit::python::python_allow_threads const allow(true);
+
+  (void)gil;
+  (void)allow;
+
   return push_datum_to_port(port, dat);
 }
 
@@ -1115,6 +1317,10 @@ ::_push_value_to_port(port_t const& port, object const& obj) const
   boost::any const any = extract<boost::any>(obj)();
   sprokit::datum_t const dat = sprokit::datum::new_datum(any);
 
+  sprokit::python::python_allow_threads const allow(true);
+
+  (void)allow;
+
   return push_datum_to_port(port, dat);
 }
 
@@ -1145,3 +1351,51 @@ ::_edge_data_info(sprokit::edge_data_t const& data)
 {
   return edge_data_info(data);
 }
+
+wrap_process::priv
+::priv()
+{
+  for (size_t i = 0; i < method_count; ++i)
+  {
+    state[i] = override_unknown;
+  }
+}
+
+wrap_process::priv
+::~priv()
+{
+  bool cached = false;
+
+  for (size_t i = 0; i < method_count; ++i)
+  {
+    cached = cached || funcs[i];
+  }
+
+  if (!cached)
+  {
+    return;
+  }
+
+  sprokit::python::python_gil const gil;
+
+  (void)gil;
+
+  for (size_t i = 0; i < method_count; ++i)
+  {
+    funcs[i].reset();
+  }
+}
+
+sprokit::process::frequency_component_t
+frequency_numerator(sprokit::process::port_frequency_t const& self)
+{
+  // Newer versions of Boost.Rational return a reference which cannot be
+  // wrapped without a return value policy.
+  return self.numerator();
+}
+
+sprokit::process::frequency_component_t
+frequency_denominator(sprokit::process::port_frequency_t const& self)
+{
+  return self.denominator();
+}
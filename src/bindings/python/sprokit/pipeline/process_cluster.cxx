@@ -113,6 +113,7 @@ BOOST_PYTHON_MODULE(process_cluster)
     .def_readonly("property_no_reentrancy", &sprokit::process::property_no_reentrancy)
     .def_readonly("property_unsync_input", &sprokit::process::property_unsync_input)
     .def_readonly("property_unsync_output", &sprokit::process::property_unsync_output)
+    .def_readonly("property_replicable", &sprokit::process::property_replicable)
     .def_readonly("type_any", &sprokit::process::type_any)
     .def_readonly("type_none", &sprokit::process::type_none)
     .def_readonly("type_data_dependent", &sprokit::process::type_data_dependent)
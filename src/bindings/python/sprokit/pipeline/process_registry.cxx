@@ -73,6 +73,12 @@ BOOST_PYTHON_MODULE(process_registry)
       , "Resets the process.")
     .def("step", &sprokit::process::step
       , "Steps the process for one iteration.")
+    .def("ready", &sprokit::process::ready
+      , "Returns True if the process can be stepped without blocking, False otherwise.")
+    .def("try_step", &sprokit::process::try_step
+      , "Steps the process if it is ready and returns True if it stepped.")
+    .def("is_reentrant", &sprokit::process::is_reentrant
+      , "Returns True if the process may be stepped from multiple threads at once, False otherwise.")
     .def("properties", &sprokit::process::properties
       , "Returns the properties on the process.")
     .def("connect_input_port", &sprokit::process::connect_input_port
@@ -112,9 +118,11 @@ BOOST_PYTHON_MODULE(process_registry)
     .def_readonly("property_no_reentrancy", &sprokit::process::property_no_reentrancy)
     .def_readonly("property_unsync_input", &sprokit::process::property_unsync_input)
     .def_readonly("property_unsync_output", &sprokit::process::property_unsync_output)
+    .def_readonly("property_replicable", &sprokit::process::property_replicable)
     .def_readonly("port_heartbeat", &sprokit::process::port_heartbeat)
     .def_readonly("config_name", &sprokit::process::config_name)
     .def_readonly("config_type", &sprokit::process::config_type)
+    .def_readonly("config_replicas", &sprokit::process::config_replicas)
     .def_readonly("type_any", &sprokit::process::type_any)
     .def_readonly("type_none", &sprokit::process::type_none)
     .def_readonly("type_data_dependent", &sprokit::process::type_data_dependent)
@@ -16,15 +16,17 @@
 # include <boost/python/converter/pytype_function.hpp>
 #endif
 # include <boost/shared_ptr.hpp>
+# include <memory>
 
 namespace boost { namespace python { namespace converter {
 
-template <class T>
+// Newer Boost.Python also registers std::shared_ptr through the second parameter.
+template <class T, template <typename> class SP = shared_ptr>
 struct shared_ptr_from_python
 {
     shared_ptr_from_python()
     {
-        converter::registry::insert(&convertible, &construct, type_id<shared_ptr<T> >()
+        converter::registry::insert(&convertible, &construct, type_id<SP<T> >()
 #ifndef BOOST_PYTHON_NO_PY_SIGNATURES
                       , &converter::expected_from_python_type_direct<T>::get_pytype
 #endif
@@ -48,16 +50,16 @@ struct shared_ptr_from_python
         sprokit::python::python_gil gil;
         (void)gil;
 
-        void* const storage = ((converter::rvalue_from_python_storage<shared_ptr<T> >*)data)->storage.bytes;
+        void* const storage = ((converter::rvalue_from_python_storage<SP<T> >*)data)->storage.bytes;
         // Deal with the "None" case.
         if (data->convertible == source)
-            new (storage) shared_ptr<T>();
+            new (storage) SP<T>();
         else
         {
-            boost::shared_ptr<void> hold_convertible_ref_count(
+            SP<void> hold_convertible_ref_count(
               (void*)0, threaded_shared_ptr_deleter(handle<>(borrowed(source))) );
             // use aliasing constructor
-            new (storage) shared_ptr<T>(
+            new (storage) SP<T>(
                 hold_convertible_ref_count,
                 static_cast<T*>(data->convertible));
         }
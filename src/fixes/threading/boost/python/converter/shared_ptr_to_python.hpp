@@ -11,6 +11,7 @@
 # include <boost/python/converter/shared_ptr_deleter.hpp>
 # include <boost/shared_ptr.hpp>
 # include <boost/get_pointer.hpp>
+# include <memory>
 
 namespace boost { namespace python { namespace converter {
 
@@ -28,6 +29,22 @@ PyObject* shared_ptr_to_python(shared_ptr<T> const& x)
         return converter::registered<shared_ptr<T> const&>::converters.to_python(&x);
 }
 
+#if !defined(BOOST_NO_CXX11_SMART_PTR)
+template <class T>
+PyObject* shared_ptr_to_python(std::shared_ptr<T> const& x)
+{
+    sprokit::python::python_gil gil;
+    (void)gil;
+
+    if (!x)
+        return python::detail::none();
+    else if (shared_ptr_deleter* d = std::get_deleter<shared_ptr_deleter>(x))
+        return incref( get_pointer( d->owner ) );
+    else
+        return converter::registered<std::shared_ptr<T> const&>::converters.to_python(&x);
+}
+#endif
+
 }}} // namespace boost::python::converter
 
 #endif // SHARED_PTR_TO_PYTHON_DWA2003224_HPP
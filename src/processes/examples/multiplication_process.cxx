@@ -52,6 +52,10 @@ class multiplication_process::priv
     static port_t const port_factor1;
     static port_t const port_factor2;
     static port_t const port_output;
+
+    port_handle factor1;
+    port_handle factor2;
+    port_handle output;
 };
 
 process::port_t const multiplication_process::priv::port_factor1 = port_t("factor1");
@@ -89,22 +93,49 @@ multiplication_process
 {
 }
 
+void
+multiplication_process
+::_init()
+{
+  d->factor1 = input_port_handle(priv::port_factor1);
+  d->factor2 = input_port_handle(priv::port_factor2);
+  d->output = output_port_handle(priv::port_output);
+
+  process::_init();
+}
+
 void
 multiplication_process
 ::_step()
 {
-  priv::number_t const factor1 = grab_from_port_as<priv::number_t>(priv::port_factor1);
-  priv::number_t const factor2 = grab_from_port_as<priv::number_t>(priv::port_factor2);
+  priv::number_t const factor1 = grab_from_port_as<priv::number_t>(d->factor1);
+  priv::number_t const factor2 = grab_from_port_as<priv::number_t>(d->factor2);
 
   priv::number_t const product = factor1 * factor2;
 
-  push_to_port_as<priv::number_t>(priv::port_output, product);
+  push_to_port_as<priv::number_t>(d->output, product);
 
   process::_step();
 }
 
+process::properties_t
+multiplication_process
+::_properties() const
+{
+  properties_t consts = process::_properties();
+
+  // Each step only looks at its own inputs.
+  consts.erase(property_no_reentrancy);
+  consts.insert(property_replicable);
+
+  return consts;
+}
+
 multiplication_process::priv
 ::priv()
+  : factor1()
+  , factor2()
+  , output()
 {
 }
 
@@ -83,10 +83,20 @@ class SPROKIT_PROCESSES_EXAMPLES_NO_EXPORT multiplication_process
      */
     ~multiplication_process();
   protected:
+    /**
+     * \brief Initialize the process.
+     */
+    void _init();
+
     /**
      * \brief Step the process.
      */
     void _step();
+
+    /**
+     * \brief The properties on the process.
+     */
+    properties_t _properties() const;
   private:
     class priv;
     boost::scoped_ptr<priv> d;
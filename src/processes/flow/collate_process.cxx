@@ -38,8 +38,11 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+#include <deque>
 #include <map>
 #include <string>
+#include <vector>
 
 /**
  * \file collate_process.cxx
@@ -58,6 +61,27 @@ class collate_process::priv
 
     typedef port_t tag_t;
 
+    typedef enum
+    {
+      mode_lockstep,
+      mode_reorder
+    } mode_t;
+
+    // A stamp waiting for its result in the reorder window.
+    class pending
+    {
+      public:
+        pending(stamp_t const& stamp_, size_t port_);
+        ~pending();
+
+        stamp_t stamp;
+        size_t port;
+        bool control;
+        bool ready;
+        edge_datum_t edat;
+    };
+    typedef std::deque<pending> window_t;
+
     class tag_info
     {
       public:
@@ -66,19 +90,38 @@ class collate_process::priv
 
         ports_t ports;
         ports_t::const_iterator cur_port;
+        window_t window;
     };
     typedef std::map<tag_t, tag_info> tag_data_t;
 
     tag_data_t tag_data;
+    mode_t mode;
+    size_t window_size;
 
     tag_t tag_for_coll_port(port_t const& port) const;
 
+    // Reordering.
+    pending pending_for_status(tag_t const& tag, tag_info& info, edge_datum_t const& status_edat) const;
+    bool reorder(collate_process& proc, tag_t const& tag, tag_info& info) const;
+
+    static size_t const no_port;
+    static config::key_t const config_mode;
+    static config::key_t const config_window;
+    static config::value_t const mode_lockstep_name;
+    static config::value_t const mode_reorder_name;
+    static config::value_t const default_window;
     static port_t const res_sep;
     static port_t const port_res_prefix;
     static port_t const port_status_prefix;
     static port_t const port_coll_prefix;
 };
 
+size_t const collate_process::priv::no_port = size_t(-1);
+config::key_t const collate_process::priv::config_mode = config::key_t("mode");
+config::key_t const collate_process::priv::config_window = config::key_t("reorder_window");
+config::value_t const collate_process::priv::mode_lockstep_name = config::value_t("lockstep");
+config::value_t const collate_process::priv::mode_reorder_name = config::value_t("reorder");
+config::value_t const collate_process::priv::default_window = config::value_t("16");
 process::port_t const collate_process::priv::res_sep = port_t("/");
 process::port_t const collate_process::priv::port_res_prefix = port_t("res") + res_sep;
 process::port_t const collate_process::priv::port_status_prefix = port_t("status") + res_sep;
@@ -131,6 +174,16 @@ ::collate_process(config_t const& config)
 {
   // This process manages its own inputs.
   set_data_checking_level(check_none);
+
+  declare_configuration_key(
+    priv::config_mode,
+    priv::mode_lockstep_name,
+    config::description_t("How to collect results. \"lockstep\" waits on the inputs in turn "
+                          "while \"reorder\" takes results from any input as they arrive."));
+  declare_configuration_key(
+    priv::config_window,
+    priv::default_window,
+    config::description_t("The number of stamps which may be outstanding in \"reorder\" mode."));
 }
 
 collate_process
@@ -138,6 +191,40 @@ collate_process
 {
 }
 
+void
+collate_process
+::_configure()
+{
+  config::value_t const mode = config_value<config::value_t>(priv::config_mode);
+
+  if (mode == priv::mode_lockstep_name)
+  {
+    d->mode = priv::mode_lockstep;
+  }
+  else if (mode == priv::mode_reorder_name)
+  {
+    d->mode = priv::mode_reorder;
+  }
+  else
+  {
+    static std::string const reason = "Unknown collation mode";
+
+    throw invalid_configuration_value_exception(name(), priv::config_mode, mode, reason);
+  }
+
+  d->window_size = config_value<size_t>(priv::config_window);
+
+  if (!d->window_size)
+  {
+    static std::string const reason = "The reorder window must hold at least one stamp";
+    config::value_t const value = config_value<config::value_t>(priv::config_window);
+
+    throw invalid_configuration_value_exception(name(), priv::config_window, value, reason);
+  }
+
+  process::_configure();
+}
+
 void
 collate_process
 ::_init()
@@ -209,6 +296,16 @@ ::_step()
     port_t const status_port = priv::port_status_prefix + tag;
     priv::tag_info& info = tag_data.second;
 
+    if (d->mode == priv::mode_reorder)
+    {
+      if (d->reorder(*this, tag, info))
+      {
+        complete_ports.push_back(tag);
+      }
+
+      continue;
+    }
+
     edge_datum_t const status_edat = grab_from_port(status_port);
     datum_t const& status_dat = status_edat.datum;
 
@@ -232,6 +329,29 @@ ::_step()
         continue;
       }
     }
+    else if (status_type == datum::data)
+    {
+      // The distributor named the group the stamp was sent to.
+      port_t const group = status_dat->get_datum<port_t>();
+      port_t const port = priv::port_coll_prefix + tag + priv::res_sep + group;
+
+      if (std::find(info.ports.begin(), info.ports.end(), port) == info.ports.end())
+      {
+        static datum::error_t const err_string = datum::error_t("Unknown group for the stamp: ");
+
+        datum_t const err_dat = datum::error_datum(err_string + group);
+
+        push_to_port(output_port, edge_datum_t(err_dat, status_edat.stamp));
+      }
+      else
+      {
+        edge_datum_t const coll_dat = grab_from_port(port);
+
+        push_to_port(output_port, coll_dat);
+      }
+
+      continue;
+    }
     else
     {
       edge_datum_t const coll_dat = grab_from_port(*info.cur_port);
@@ -307,18 +427,23 @@ ::_input_port_info(port_t const& port)
   if (!tag.empty())
   {
     priv::tag_info& info = d->tag_data[tag];
+    ports_t& ports = info.ports;
 
-    info.ports.push_back(port);
+    // The port may be queried many times; only declare it once.
+    if (std::find(ports.begin(), ports.end(), port) == ports.end())
+    {
+      ports.push_back(port);
 
-    port_flags_t required;
+      port_flags_t required;
 
-    required.insert(flag_required);
+      required.insert(flag_required);
 
-    declare_input_port(
-      port,
-      type_flow_dependent + tag,
-      required,
-      port_description_t("An input for the " + tag + " data."));
+      declare_input_port(
+        port,
+        type_flow_dependent + tag,
+        required,
+        port_description_t("An input for the " + tag + " data."));
+    }
   }
 
   return process::_input_port_info(port);
@@ -327,6 +452,8 @@ ::_input_port_info(port_t const& port)
 collate_process::priv
 ::priv()
   : tag_data()
+  , mode(mode_lockstep)
+  , window_size(0)
 {
 }
 
@@ -358,10 +485,183 @@ ::tag_for_coll_port(port_t const& port) const
   return tag_t();
 }
 
+collate_process::priv::pending
+collate_process::priv
+::pending_for_status(tag_t const& tag, tag_info& info, edge_datum_t const& status_edat) const
+{
+  datum_t const& status_dat = status_edat.datum;
+  datum::type_t const status_type = status_dat->type();
+
+  if ((status_type == datum::complete) || (status_type == datum::flush))
+  {
+    pending entry(status_edat.stamp, no_port);
+
+    entry.control = true;
+    entry.ready = true;
+    entry.edat = status_edat;
+
+    // Keep in step with the distributor which also moves on here.
+    ++info.cur_port;
+
+    if (info.cur_port == info.ports.end())
+    {
+      info.cur_port = info.ports.begin();
+    }
+
+    return entry;
+  }
+
+  if (status_type == datum::data)
+  {
+    // The distributor named the group the stamp was sent to.
+    port_t const group = status_dat->get_datum<port_t>();
+    port_t const port = port_coll_prefix + tag + res_sep + group;
+
+    ports_t::const_iterator const i = std::find(info.ports.begin(), info.ports.end(), port);
+
+    if (i == info.ports.end())
+    {
+      static datum::error_t const err_string = datum::error_t("Unknown group for the stamp: ");
+
+      pending entry(status_edat.stamp, no_port);
+
+      entry.ready = true;
+      entry.edat = edge_datum_t(datum::error_datum(err_string + group), status_edat.stamp);
+
+      return entry;
+    }
+
+    return pending(status_edat.stamp, i - info.ports.begin());
+  }
+
+  size_t const port = info.cur_port - info.ports.begin();
+
+  ++info.cur_port;
+
+  if (info.cur_port == info.ports.end())
+  {
+    info.cur_port = info.ports.begin();
+  }
+
+  return pending(status_edat.stamp, port);
+}
+
+bool
+collate_process::priv
+::reorder(collate_process& proc, tag_t const& tag, tag_info& info) const
+{
+  port_t const output_port = port_res_prefix + tag;
+  port_t const status_port = port_status_prefix + tag;
+  ports_t const& ports = info.ports;
+  window_t& window = info.window;
+
+  // Take in as many stamps as the window allows.
+  size_t available = proc.input_port_datum_count(status_port);
+
+  if (window.empty() && !available)
+  {
+    // Nothing is outstanding, so wait for the next stamp.
+    available = 1;
+  }
+
+  while (available && (window.size() < window_size))
+  {
+    edge_datum_t const status_edat = proc.grab_from_port(status_port);
+
+    window.push_back(pending_for_status(tag, info, status_edat));
+
+    --available;
+  }
+
+  // Take any results which have already arrived. Each input delivers its
+  // results in the order its stamps were sent to it.
+  std::vector<size_t> counts;
+
+  counts.reserve(ports.size());
+
+  BOOST_FOREACH (port_t const& port, ports)
+  {
+    counts.push_back(proc.input_port_datum_count(port));
+  }
+
+  BOOST_FOREACH (pending& entry, window)
+  {
+    // Inputs are not aligned past a control datum until it is handled.
+    if (entry.control)
+    {
+      break;
+    }
+
+    if (entry.ready || !counts[entry.port])
+    {
+      continue;
+    }
+
+    entry.edat = proc.grab_from_port(ports[entry.port]);
+    entry.ready = true;
+
+    --counts[entry.port];
+  }
+
+  // Nothing can be sent until the oldest stamp has its result.
+  pending& head = window.front();
+
+  if (!head.ready)
+  {
+    head.edat = proc.grab_from_port(ports[head.port]);
+    head.ready = true;
+  }
+
+  while (!window.empty() && window.front().ready)
+  {
+    pending const entry = window.front();
+
+    window.pop_front();
+
+    if (entry.control)
+    {
+      proc.push_to_port(output_port, entry.edat);
+
+      BOOST_FOREACH (port_t const& port, ports)
+      {
+        (void)proc.grab_from_port(port);
+      }
+
+      if (entry.edat.datum->type() == datum::complete)
+      {
+        return true;
+      }
+
+      continue;
+    }
+
+    // Results leave with the stamp of the original stream.
+    proc.push_to_port(output_port, edge_datum_t(entry.edat.datum, entry.stamp));
+  }
+
+  return false;
+}
+
+collate_process::priv::pending
+::pending(stamp_t const& stamp_, size_t port_)
+  : stamp(stamp_)
+  , port(port_)
+  , control(false)
+  , ready(false)
+  , edat()
+{
+}
+
+collate_process::priv::pending
+::~pending()
+{
+}
+
 collate_process::priv::tag_info
 ::tag_info()
   : ports()
   , cur_port()
+  , window()
 {
 }
 
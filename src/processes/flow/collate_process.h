@@ -60,7 +60,10 @@ namespace sprokit
  *
  * \iports
  *
- * \iport{status/\portvar{tag}} The status of the result \portvar{tag}.
+ * \iport{status/\portvar{tag}} The status of the result \portvar{tag}. When
+ *                              it carries a \portvar{group}, the datum
+ *                              for the stamp is taken from that group
+ *                              rather than the next one in turn.
  * \iport{coll/\portvar{tag}/\portvar{group}} A port to collate data for
  *                                            \portvar{tag} from. Data is
  *                                            collated from ports in
@@ -70,6 +73,15 @@ namespace sprokit
  *
  * \oport{res/\portvar{tag}} The collated result \portvar{tag}.
  *
+ * \configs
+ *
+ * \config{mode} How results are collected. With \c lockstep, each result
+ *               is waited for in turn. With \c reorder, results are taken
+ *               from any input as they arrive and held until every earlier
+ *               stamp has been sent.
+ * \config{reorder_window} The number of stamps which may be outstanding in
+ *                         \c reorder mode.
+ *
  * \reqs
  *
  * \req Each input port \port{status/\portvar{tag}} must be connected.
@@ -96,6 +108,11 @@ class SPROKIT_PROCESSES_FLOW_NO_EXPORT collate_process
      */
     ~collate_process();
   protected:
+    /**
+     * \brief Configure the process.
+     */
+    void _configure();
+
     /**
      * \brief Initialize the process.
      */
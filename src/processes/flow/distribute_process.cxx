@@ -38,8 +38,10 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 /**
  * \file distribute_process.cxx
@@ -58,6 +60,14 @@ class distribute_process::priv
 
     typedef port_t group_t;
     typedef port_t tag_t;
+    typedef std::vector<group_t> groups_t;
+
+    typedef enum
+    {
+      mode_round_robin,
+      mode_shortest_queue,
+      mode_first_free
+    } mode_t;
 
     class tag_info
     {
@@ -66,22 +76,35 @@ class distribute_process::priv
         ~tag_info();
 
         ports_t ports;
+        groups_t groups;
         ports_t::const_iterator cur_port;
     };
     typedef std::map<tag_t, tag_info> tag_data_t;
 
     tag_data_t tag_data;
+    mode_t mode;
+
+    // Output selection.
+    size_t choose_port(distribute_process const& proc, tag_info const& info) const;
 
     // Port name break down.
     tag_t tag_for_dist_port(port_t const& port) const;
     group_t group_for_dist_port(port_t const& port) const;
 
+    static config::key_t const config_mode;
+    static config::value_t const mode_round_robin_name;
+    static config::value_t const mode_shortest_queue_name;
+    static config::value_t const mode_first_free_name;
     static port_t const src_sep;
     static port_t const port_src_prefix;
     static port_t const port_status_prefix;
     static port_t const port_dist_prefix;
 };
 
+config::key_t const distribute_process::priv::config_mode = config::key_t("mode");
+config::value_t const distribute_process::priv::mode_round_robin_name = config::value_t("round_robin");
+config::value_t const distribute_process::priv::mode_shortest_queue_name = config::value_t("shortest_queue");
+config::value_t const distribute_process::priv::mode_first_free_name = config::value_t("first_free");
 process::port_t const distribute_process::priv::src_sep = port_t("/");
 process::port_t const distribute_process::priv::port_src_prefix = port_t("src") + src_sep;
 process::port_t const distribute_process::priv::port_status_prefix = port_t("status") + src_sep;
@@ -134,6 +157,12 @@ ::distribute_process(config_t const& config)
 {
   // This process manages its own inputs.
   set_data_checking_level(check_none);
+
+  declare_configuration_key(
+    priv::config_mode,
+    priv::mode_round_robin_name,
+    config::description_t("How to choose the output for each datum. Must be one of "
+                          "\"round_robin\", \"shortest_queue\", or \"first_free\"."));
 }
 
 distribute_process
@@ -141,6 +170,34 @@ distribute_process
 {
 }
 
+void
+distribute_process
+::_configure()
+{
+  config::value_t const mode = config_value<config::value_t>(priv::config_mode);
+
+  if (mode == priv::mode_round_robin_name)
+  {
+    d->mode = priv::mode_round_robin;
+  }
+  else if (mode == priv::mode_shortest_queue_name)
+  {
+    d->mode = priv::mode_shortest_queue;
+  }
+  else if (mode == priv::mode_first_free_name)
+  {
+    d->mode = priv::mode_first_free;
+  }
+  else
+  {
+    static std::string const reason = "Unknown distribution mode";
+
+    throw invalid_configuration_value_exception(name(), priv::config_mode, mode, reason);
+  }
+
+  process::_configure();
+}
+
 void
 distribute_process
 ::_init()
@@ -237,6 +294,20 @@ ::_step()
         continue;
       }
     }
+    else if (d->mode != priv::mode_round_robin)
+    {
+      size_t const idx = d->choose_port(*this, info);
+
+      // Tell the collation side which group the stamp was sent to.
+      datum_t const status_dat = datum::new_datum(info.groups[idx]);
+      edge_datum_t const status_edat = edge_datum_t(status_dat, src_stamp);
+
+      push_to_port(status_port, status_edat);
+      push_to_port(info.ports[idx], src_edat);
+
+      // Start the search for the next datum after the chosen port.
+      info.cur_port = info.ports.begin() + idx;
+    }
     else
     {
       edge_datum_t const status_edat = edge_datum_t(datum::empty_datum(), src_stamp);
@@ -314,18 +385,24 @@ ::_output_port_info(port_t const& port)
   {
     port_t const group = d->group_for_dist_port(port);
     priv::tag_info& info = d->tag_data[tag];
+    ports_t& ports = info.ports;
 
-    info.ports.push_back(port);
+    // The port may be queried many times; only declare it once.
+    if (std::find(ports.begin(), ports.end(), port) == ports.end())
+    {
+      ports.push_back(port);
+      info.groups.push_back(group);
 
-    port_flags_t required;
+      port_flags_t required;
 
-    required.insert(flag_required);
+      required.insert(flag_required);
 
-    declare_output_port(
-      port,
-      type_flow_dependent + tag,
-      required,
-      port_description_t("An output for the " + tag + " data."));
+      declare_output_port(
+        port,
+        type_flow_dependent + tag,
+        required,
+        port_description_t("An output for the " + tag + " data."));
+    }
   }
 
   return process::_output_port_info(port);
@@ -334,6 +411,7 @@ ::_output_port_info(port_t const& port)
 distribute_process::priv
 ::priv()
   : tag_data()
+  , mode(mode_round_robin)
 {
 }
 
@@ -390,9 +468,41 @@ ::group_for_dist_port(port_t const& port) const
   return group_t();
 }
 
+size_t
+distribute_process::priv
+::choose_port(distribute_process const& proc, tag_info const& info) const
+{
+  size_t const count = info.ports.size();
+  size_t const start = info.cur_port - info.ports.begin();
+
+  size_t best = start;
+  size_t best_space = 0;
+
+  // Search in round robin order so that ties are spread over the outputs.
+  for (size_t i = 0; i < count; ++i)
+  {
+    size_t const idx = (start + i) % count;
+    size_t const space = proc.output_port_free_space(info.ports[idx]);
+
+    if ((mode == mode_first_free) && space)
+    {
+      return idx;
+    }
+
+    if (best_space < space)
+    {
+      best = idx;
+      best_space = space;
+    }
+  }
+
+  return best;
+}
+
 distribute_process::priv::tag_info
 ::tag_info()
   : ports()
+  , groups()
   , cur_port()
 {
 }
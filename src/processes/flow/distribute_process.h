@@ -69,6 +69,15 @@ namespace sprokit
  *                                            \portvar{tag} to. Data is
  *                                            distributed in ASCII-betical order.
  *
+ * \configs
+ *
+ * \config{mode} How to choose the output for each datum. \c round_robin uses
+ *               each output in turn, \c shortest_queue uses the output with the
+ *               most free space, and \c first_free uses the next output in turn
+ *               which has space, falling back to the one with the most space.
+ *               In the latter two modes, the datum on the status port is the
+ *               \portvar{group} chosen for the stamp.
+ *
  * \reqs
  *
  * \req Each input port \port{src/\portvar{tag}} must be connected.
@@ -95,6 +104,11 @@ class SPROKIT_PROCESSES_FLOW_NO_EXPORT distribute_process
      */
     ~distribute_process();
   protected:
+    /**
+     * \brief Configure the process.
+     */
+    void _configure();
+
     /**
      * \brief Initialize the process.
      */
@@ -53,6 +53,9 @@ class pass_process::priv
     static port_t const port_input;
     static port_t const port_output;
     static tag_t const tag;
+
+    port_handle input;
+    port_handle output;
 };
 
 process::port_t const pass_process::priv::port_input = port_t("pass");
@@ -89,14 +92,24 @@ pass_process
 {
 }
 
+void
+pass_process
+::_init()
+{
+  d->input = input_port_handle(priv::port_input);
+  d->output = output_port_handle(priv::port_output);
+
+  process::_init();
+}
+
 void
 pass_process
 ::_step()
 {
-  datum_t const dat = grab_datum_from_port(priv::port_input);
+  datum_t const dat = grab_datum_from_port(d->input);
   bool const complete = (dat->type() == datum::complete);
 
-  push_datum_to_port(priv::port_output, dat);
+  push_datum_to_port(d->output, dat);
 
   if (complete)
   {
@@ -106,8 +119,21 @@ ::_step()
   process::_step();
 }
 
+process::properties_t
+pass_process
+::_properties() const
+{
+  properties_t consts = process::_properties();
+
+  consts.insert(property_replicable);
+
+  return consts;
+}
+
 pass_process::priv
 ::priv()
+  : input()
+  , output()
 {
 }
 
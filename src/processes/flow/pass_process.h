@@ -82,10 +82,20 @@ class SPROKIT_PROCESSES_FLOW_NO_EXPORT pass_process
      */
     ~pass_process();
   protected:
+    /**
+     * \brief Initialize the process.
+     */
+    void _init();
+
     /**
      * \brief Step the process.
      */
     void _step();
+
+    /**
+     * \brief The properties on the process.
+     */
+    properties_t _properties() const;
   private:
     class priv;
     boost::scoped_ptr<priv> d;
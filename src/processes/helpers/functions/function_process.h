@@ -71,6 +71,7 @@ class SPROKIT_NO_EXPORT CLASS_NAME(name)               \
   protected:                                         \
     void _configure();                               \
     void _step();                                    \
+    properties_t _properties() const;                \
   private:                                           \
     class priv;                                      \
     boost::scoped_ptr<priv> d;                       \
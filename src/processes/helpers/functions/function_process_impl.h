@@ -491,6 +491,8 @@
  * </dl>
  *
  * It is highly recommended that all ports are marked as \flag{required}.
+ * Since \p func is expected to be pure, the process is reentrant and may be
+ * stepped concurrently when all of its ports are required.
  *
  * \note The types of ports are recommended to have cheap copy constructors
  * since that is what is called when grabbing from ports and pushing them.
@@ -592,6 +594,17 @@ ::_step()                                                             \
   process::_step();                                                   \
 }                                                                     \
                                                                       \
+sprokit::process::properties_t                                        \
+CLASS_NAME(name)                                                      \
+::_properties() const                                                 \
+{                                                                     \
+  properties_t consts = process::_properties();                       \
+                                                                      \
+  consts.erase(property_no_reentrancy);                               \
+                                                                      \
+  return consts;                                                      \
+}                                                                     \
+                                                                      \
 CLASS_NAME(name)::priv                                                \
 ::priv(conf(CONFIG_DECLARE_ARGS, ARGS))                               \
   conf(CONF_INIT_PRIV, INIT)                                          \
@@ -45,12 +45,14 @@
 #include <boost/thread/thread.hpp>
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
-#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
 
 #include <deque>
 #include <iterator>
 #include <map>
 #include <queue>
+#include <set>
+#include <vector>
 
 /**
  * \file sync_scheduler.cxx
@@ -66,24 +68,37 @@ static thread_name_t const thread_name = thread_name_t("sync_scheduler");
 class sync_scheduler::priv
 {
   public:
-    priv();
+    priv(bool fuse_chains_, cpu_ids_t const& cpus_);
     ~priv();
 
+    typedef std::vector<process_t> chain_t;
+
     void run(pipeline_t const& pipe);
 
+    bool const fuse_chains;
+    cpu_ids_t const cpus;
+
     boost::thread thread;
 
     typedef boost::shared_mutex mutex_t;
     typedef boost::shared_lock<mutex_t> shared_lock_t;
 
     mutable mutex_t mut;
+
+    static config::key_t const config_fuse_chains;
 };
 
+config::key_t const sync_scheduler::priv::config_fuse_chains = config::key_t("fuse_chains");
+
 sync_scheduler
 ::sync_scheduler(pipeline_t const& pipe, config_t const& config)
   : scheduler(pipe, config)
-  , d(new priv)
+  , d()
 {
+  bool const fuse_chains = config->get_value<bool>(priv::config_fuse_chains, true);
+
+  d.reset(new priv(fuse_chains, affinity()));
+
   pipeline_t const p = pipeline();
   process::names_t const names = p->process_names();
 
@@ -152,8 +167,10 @@ ::_stop()
 }
 
 sync_scheduler::priv
-::priv()
-  : thread()
+::priv(bool fuse_chains_, cpu_ids_t const& cpus_)
+  : fuse_chains(fuse_chains_)
+  , cpus(cpus_)
+  , thread()
   , mut()
 {
 }
@@ -164,7 +181,27 @@ sync_scheduler::priv
 }
 
 static process::names_t sorted_names(pipeline_t const& pipe);
-static config_t monitor_edge_config();
+static edge_t fusable_edge(pipeline_t const& pipe, process::name_t const& name, process::name_t& downstream_name);
+
+namespace
+{
+
+/**
+ * \class inline_edges
+ *
+ * \brief Makes edges inline for as long as it exists.
+ */
+class inline_edges
+  : boost::noncopyable
+{
+  public:
+    inline_edges(edges_t const& edges_);
+    ~inline_edges();
+  private:
+    edges_t const edges;
+};
+
+}
 
 void
 sync_scheduler::priv
@@ -172,24 +209,66 @@ ::run(pipeline_t const& pipe)
 {
   name_thread(thread_name);
 
+  if (!cpus.empty())
+  {
+    pin_thread(cpus);
+  }
+
   process::names_t const names = sorted_names(pipe);
-  std::queue<process_t> processes;
-  std::map<process::name_t, edge_t> monitor_edges;
+  std::vector<chain_t> chains;
+  edges_t fused_edges;
 
-  config_t const edge_conf = monitor_edge_config();
+  // Each process starts a chain unless it was already fused onto the end of
+  // an earlier one.
+  std::set<process::name_t> fused;
 
   BOOST_FOREACH (process::name_t const& name, names)
   {
-    process_t const proc = pipe->process_by_name(name);
-    edge_t const monitor_edge = boost::make_shared<edge>(edge_conf);
+    if (fused.count(name))
+    {
+      continue;
+    }
+
+    chain_t chain;
+    process::name_t cur_name = name;
+
+    while (true)
+    {
+      chain.push_back(pipe->process_by_name(cur_name));
+
+      if (!fuse_chains)
+      {
+        break;
+      }
+
+      process::name_t downstream_name;
+      edge_t const edge = fusable_edge(pipe, cur_name, downstream_name);
+
+      if (!edge)
+      {
+        break;
+      }
 
-    proc->connect_output_port(process::port_heartbeat, monitor_edge);
-    monitor_edges[name] = monitor_edge;
+      cur_name = downstream_name;
+      fused.insert(cur_name);
+      fused_edges.push_back(edge);
+    }
 
-    processes.push(proc);
+    chains.push_back(chain);
   }
 
-  while (!processes.empty())
+  inline_edges const inlined(fused_edges);
+
+  (void)inlined;
+
+  std::queue<size_t> pending;
+
+  for (size_t i = 0; i < chains.size(); ++i)
+  {
+    pending.push(i);
+  }
+
+  while (!pending.empty())
   {
     shared_lock_t const lock(mut);
 
@@ -197,33 +276,30 @@ ::run(pipeline_t const& pipe)
 
     boost::this_thread::interruption_point();
 
-    process_t proc = processes.front();
-    processes.pop();
-
-    edge_t monitor_edge = monitor_edges[proc->name()];
-
-    proc->step();
+    size_t const idx = pending.front();
+    chain_t const& chain = chains[idx];
+    pending.pop();
 
-    bool proc_complete = false;
+    bool complete = true;
 
-    while (monitor_edge->has_data())
+    BOOST_FOREACH (process_t const& proc, chain)
     {
-      edge_datum_t const edat = monitor_edge->get_datum();
-      datum_t const dat = edat.datum;
+      if (proc->is_complete())
+      {
+        continue;
+      }
 
-      if (dat->type() == datum::complete)
+      proc->step();
+
+      if (!proc->is_complete())
       {
-        proc_complete = true;
+        complete = false;
       }
     }
 
-    if (proc_complete)
-    {
-      monitor_edges.erase(proc->name());
-    }
-    else
+    if (!complete)
     {
-      processes.push(proc);
+      pending.push(idx);
     }
   }
 }
@@ -316,12 +392,85 @@ sorted_names(pipeline_t const& pipe)
   return names;
 }
 
-config_t
-monitor_edge_config()
+edge_t
+fusable_edge(pipeline_t const& pipe, process::name_t const& name, process::name_t& downstream_name)
 {
-  config_t conf = config::empty_config();
+  process_t const proc = pipe->process_by_name(name);
+  edges_t const out_edges = pipe->output_edges_for_process(name);
+
+  if (out_edges.size() != 1)
+  {
+    return edge_t();
+  }
+
+  edge_t const edge = out_edges[0];
+
+  if (!edge->makes_dependency())
+  {
+    return edge_t();
+  }
+
+  process::port_t port;
+
+  BOOST_FOREACH (process::port_t const& oport, proc->output_ports())
+  {
+    if (!pipe->output_edges_for_port(name, oport).empty())
+    {
+      port = oport;
+
+      break;
+    }
+  }
+
+  process::port_addrs_t const receivers = pipe->receivers_for_port(name, port);
+  process::port_addr_t const& receiver = receivers[0];
+
+  downstream_name = receiver.first;
+  process::port_t const& downstream_port = receiver.second;
+
+  process_t const downstream = pipe->process_by_name(downstream_name);
+
+  if (pipe->input_edges_for_process(downstream_name).size() != 1)
+  {
+    return edge_t();
+  }
+
+  process::port_frequency_t const up_freq = proc->output_port_info(port)->frequency;
+  process::port_frequency_t const down_freq = downstream->input_port_info(downstream_port)->frequency;
+
+  process::port_frequency_t const one = process::port_frequency_t(1);
+
+  // Each step of the upstream process must feed exactly one step downstream.
+  if ((up_freq != one) || (down_freq != one))
+  {
+    return edge_t();
+  }
+
+  return edge;
+}
+
+namespace
+{
+
+inline_edges
+::inline_edges(edges_t const& edges_)
+  : edges(edges_)
+{
+  BOOST_FOREACH (edge_t const& edge, edges)
+  {
+    edge->set_inline(true);
+  }
+}
+
+inline_edges
+::~inline_edges()
+{
+  BOOST_FOREACH (edge_t const& edge, edges)
+  {
+    edge->set_inline(false);
+  }
+}
 
-  return conf;
 }
 
 }
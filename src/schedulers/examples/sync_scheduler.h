@@ -52,6 +52,18 @@ namespace sprokit
  * \brief A scheduler which runs the entire pipeline in one thread.
  *
  * \scheduler Run the pipeline in one thread.
+ *
+ * Chains of processes where each link is the only output of the upstream
+ * process and the only input of the downstream process, with both ports at
+ * the same frequency, are fused: the processes in a chain are stepped back to
+ * back and the edges between them are made \link edge::set_inline
+ * inline\endlink for the duration of the run.
+ *
+ * \configs
+ *
+ * \config{fuse_chains} Whether to fuse linear chains of processes.
+ *
+ * The \key{affinity} setting applies to the single thread.
  */
 class SPROKIT_SCHEDULERS_EXAMPLES_NO_EXPORT sync_scheduler
   : public scheduler
@@ -41,7 +41,6 @@
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/foreach.hpp>
-#include <boost/make_shared.hpp>
 
 /**
  * \file thread_per_process_scheduler.cxx
@@ -58,7 +57,7 @@ class thread_per_process_scheduler::priv
     priv();
     ~priv();
 
-    void run_process(process_t const& process);
+    void run_process(process_t const& process, cpu_ids_t const& cpus);
 
     boost::scoped_ptr<boost::thread_group> process_threads;
 
@@ -109,8 +108,9 @@ ::_start()
   BOOST_FOREACH (process::name_t const& name, names)
   {
     process_t const process = pipeline()->process_by_name(name);
+    cpu_ids_t const cpus = affinity(name);
 
-    d->process_threads->create_thread(boost::bind(&priv::run_process, d.get(), process));
+    d->process_threads->create_thread(boost::bind(&priv::run_process, d.get(), process, cpus));
   }
 }
 
@@ -154,22 +154,18 @@ thread_per_process_scheduler::priv
 {
 }
 
-static config_t monitor_edge_config();
-
 void
 thread_per_process_scheduler::priv
-::run_process(process_t const& process)
+::run_process(process_t const& process, cpu_ids_t const& cpus)
 {
-  config_t const edge_conf = monitor_edge_config();
-
   name_thread(process->name());
-  edge_t monitor_edge = boost::make_shared<edge>(edge_conf);
 
-  process->connect_output_port(process::port_heartbeat, monitor_edge);
-
-  bool complete = false;
+  if (!cpus.empty())
+  {
+    pin_thread(cpus);
+  }
 
-  while (!complete)
+  while (!process->is_complete())
   {
     shared_lock_t const lock(mut);
 
@@ -178,26 +174,6 @@ ::run_process(process_t const& process)
     boost::this_thread::interruption_point();
 
     process->step();
-
-    while (monitor_edge->has_data())
-    {
-      edge_datum_t const edat = monitor_edge->get_datum();
-      datum_t const dat = edat.datum;
-
-      if (dat->type() == datum::complete)
-      {
-        complete = true;
-      }
-    }
   }
 }
-
-config_t
-monitor_edge_config()
-{
-  config_t conf = config::empty_config();
-
-  return conf;
-}
-
 }
@@ -52,6 +52,8 @@ namespace sprokit
  * \brief A scheduler which runs each process in its own thread.
  *
  * \scheduler Run a thread for each process.
+ *
+ * The \key{affinity} settings apply to the thread for each process.
  */
 class SPROKIT_SCHEDULERS_EXAMPLES_NO_EXPORT thread_per_process_scheduler
   : public scheduler
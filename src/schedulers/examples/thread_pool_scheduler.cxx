@@ -31,8 +31,23 @@
 #include "thread_pool_scheduler.h"
 
 #include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/utils.h>
 
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <vector>
 
 /**
  * \file thread_pool_scheduler.cxx
@@ -43,18 +58,105 @@
 namespace sprokit
 {
 
+static thread_name_t const thread_name = thread_name_t("thread_pool");
+
 class thread_pool_scheduler::priv
 {
   public:
-    priv(size_t num_threads_);
+    priv(size_t num_threads_, cpu_ids_t const& cpus_);
     ~priv();
 
+    typedef size_t task_t;
+    typedef std::vector<task_t> tasks_t;
+    typedef std::deque<task_t> task_queue_t;
+
+    typedef enum
+    {
+      state_idle,
+      state_queued,
+      state_running,
+      state_complete
+    } process_state_t;
+
+    class process_info
+    {
+      public:
+        process_info(process_t const& process_, size_t worker_);
+        ~process_info();
+
+        void stepped(bool complete);
+
+        process_t const process;
+        // Set by the step callback; guarded by the mutex.
+        bool stepped_complete;
+
+        tasks_t upstream;
+        tasks_t downstream;
+
+        bool pinned;
+        size_t const worker;
+
+        // Reentrant processes stay idle while running; their steps are
+        // counted against the pool instead.
+        bool reentrant;
+
+        process_state_t state;
+        boost::mutex mut;
+    };
+    typedef boost::ptr_vector<process_info> process_infos_t;
+
+    class worker_queue
+    {
+      public:
+        worker_queue();
+        ~worker_queue();
+
+        task_queue_t tasks;
+        task_queue_t pinned_tasks;
+
+        size_t pinned_pending;
+
+        boost::mutex mut;
+    };
+    typedef boost::ptr_vector<worker_queue> worker_queues_t;
+
+    void setup(pipeline_t const& pipe);
+    void run_worker(size_t idx);
+
+    bool is_ready(process_info const& info) const;
+    void try_schedule(task_t task, size_t idx);
+    bool reserve_reentrant_step(task_t task);
+    void release_reentrant_step(size_t idx);
+    bool find_task(size_t idx, task_t& task);
+    void process_complete();
+
     size_t const num_threads;
+    size_t const max_in_flight;
+    cpu_ids_t const cpus;
 
     bool complete;
 
+    process_infos_t processes;
+    worker_queues_t queues;
+
+    size_t pending;
+    size_t remaining;
+
+    // Steps of reentrant processes which are queued or running, and the
+    // processes which were turned away because there were too many.
+    size_t reentrant_in_flight;
+    task_queue_t deferred;
+
+    boost::mutex idle_mut;
+    boost::condition_variable idle_cond;
+
     boost::thread_group thread_pool;
 
+    typedef boost::shared_mutex mutex_t;
+    typedef boost::shared_lock<mutex_t> shared_lock_t;
+
+    mutable mutex_t mut;
+
     static config::key_t const config_num_threads;
 };
 
@@ -65,10 +167,19 @@ ::thread_pool_scheduler(pipeline_t const& pipe, config_t const& config)
   : scheduler(pipe, config)
   , d()
 {
-  unsigned const hardware_concurrency = boost::thread::hardware_concurrency();
-  size_t const num_threads = config->get_value<size_t>(priv::config_num_threads, hardware_concurrency - 1);
+  size_t num_threads = config->get_value<size_t>(priv::config_num_threads, 0);
+
+  if (!num_threads)
+  {
+    num_threads = boost::thread::hardware_concurrency();
+  }
+
+  if (!num_threads)
+  {
+    num_threads = 1;
+  }
 
-  d.reset(new priv(num_threads));
+  d.reset(new priv(num_threads, affinity()));
 }
 
 thread_pool_scheduler
@@ -81,13 +192,11 @@ void
 thread_pool_scheduler
 ::_start()
 {
-  /// \todo Map processes to upstream edges.
-  /// \todo Map processes to downstream edges.
-  /// \todo Initialize all process statuses to 'ready'.
+  d->setup(pipeline());
 
-  while (!d->complete)
+  for (size_t i = 0; i < d->num_threads; ++i)
   {
-    /// \todo Queue processes while upstreams have data and downstreams aren't full.
+    d->thread_pool.create_thread(boost::bind(&priv::run_worker, d.get(), i));
   }
 }
 
@@ -102,29 +211,49 @@ void
 thread_pool_scheduler
 ::_pause()
 {
-  /// \todo Implement.
+  d->mut.lock();
 }
 
 void
 thread_pool_scheduler
 ::_resume()
 {
-  /// \todo Implement.
+  d->mut.unlock();
 }
 
 void
 thread_pool_scheduler
 ::_stop()
 {
-  d->complete = true;
+  {
+    boost::mutex::scoped_lock const lock(d->idle_mut);
+
+    (void)lock;
+
+    d->complete = true;
+  }
+
+  d->idle_cond.notify_all();
   d->thread_pool.interrupt_all();
 }
 
 thread_pool_scheduler::priv
-::priv(size_t num_threads_)
+::priv(size_t num_threads_, cpu_ids_t const& cpus_)
   : num_threads(num_threads_)
+    // Leave a worker free for processes which are not reentrant.
+  , max_in_flight(std::max(size_t(1), num_threads_ - 1))
+  , cpus(cpus_)
   , complete(false)
+  , processes()
+  , queues()
+  , pending(0)
+  , remaining(0)
+  , reentrant_in_flight(0)
+  , deferred()
+  , idle_mut()
+  , idle_cond()
   , thread_pool()
+  , mut()
 {
 }
 
@@ -133,4 +262,475 @@ thread_pool_scheduler::priv
 {
 }
 
+void
+thread_pool_scheduler::priv
+::setup(pipeline_t const& pipe)
+{
+  process::names_t const names = pipe->process_names();
+
+  typedef std::map<process::name_t, task_t> task_map_t;
+
+  task_map_t task_map;
+
+  for (size_t i = 0; i < num_threads; ++i)
+  {
+    queues.push_back(new worker_queue);
+  }
+
+  BOOST_FOREACH (process::name_t const& name, names)
+  {
+    process_t const proc = pipe->process_by_name(name);
+    task_t const task = processes.size();
+
+    processes.push_back(new process_info(proc, task % num_threads));
+    process_info& info = processes.back();
+
+    proc->set_step_callback(boost::bind(&process_info::stepped, &info, _1));
+
+    process::properties_t const consts = proc->properties();
+
+    // Processes which cannot be moved between threads always run on the worker
+    // they were assigned to and are never stolen.
+    if (consts.count(process::property_no_threads))
+    {
+      info.pinned = true;
+    }
+
+    info.reentrant = (!info.pinned && proc->is_reentrant());
+
+    task_map[name] = task;
+  }
+
+  BOOST_FOREACH (process_info& info, processes)
+  {
+    process::name_t const name = info.process->name();
+
+    processes_t const ups = pipe->upstream_for_process(name);
+    processes_t const downs = pipe->downstream_for_process(name);
+
+    BOOST_FOREACH (process_t const& up, ups)
+    {
+      info.upstream.push_back(task_map[up->name()]);
+    }
+
+    BOOST_FOREACH (process_t const& down, downs)
+    {
+      info.downstream.push_back(task_map[down->name()]);
+    }
+  }
+
+  remaining = processes.size();
+
+  if (!remaining)
+  {
+    complete = true;
+  }
+
+  for (task_t task = 0; task < processes.size(); ++task)
+  {
+    try_schedule(task, processes[task].worker);
+  }
+}
+
+void
+thread_pool_scheduler::priv
+::run_worker(size_t idx)
+{
+  name_thread(thread_name);
+
+  // Processes move between workers, so each worker gets its own processor
+  // rather than following any particular process.
+  if (!cpus.empty())
+  {
+    pin_thread(cpu_ids_t(1, cpus[idx % cpus.size()]));
+  }
+
+  while (true)
+  {
+    boost::this_thread::interruption_point();
+
+    task_t task;
+
+    if (!find_task(idx, task))
+    {
+      boost::mutex::scoped_lock lock(idle_mut);
+
+      while (!complete && !pending && !queues[idx].pinned_pending)
+      {
+        idle_cond.wait(lock);
+      }
+
+      if (complete)
+      {
+        return;
+      }
+
+      continue;
+    }
+
+    process_info& info = processes[task];
+
+    bool stepped = true;
+
+    {
+      shared_lock_t const lock(mut);
+
+      (void)lock;
+
+      boost::this_thread::interruption_point();
+
+      if (info.reentrant)
+      {
+        // Another copy of the step may have taken the inputs already.
+        stepped = info.process->try_step();
+      }
+      else
+      {
+        info.process->step();
+      }
+    }
+
+    bool proc_complete = false;
+    bool newly_complete = false;
+
+    {
+      boost::mutex::scoped_lock const lock(info.mut);
+
+      (void)lock;
+
+      proc_complete = info.stepped_complete;
+
+      if (info.state != state_complete)
+      {
+        info.state = (proc_complete ? state_complete : state_idle);
+        newly_complete = proc_complete;
+      }
+    }
+
+    if (info.reentrant)
+    {
+      release_reentrant_step(idx);
+    }
+
+    if (!stepped)
+    {
+      continue;
+    }
+
+    if (newly_complete)
+    {
+      process_complete();
+    }
+    else if (!proc_complete)
+    {
+      try_schedule(task, idx);
+    }
+
+    // Stepping may have made data available downstream or freed space
+    // upstream, so give the neighbors a chance to run.
+    BOOST_FOREACH (task_t const down, info.downstream)
+    {
+      try_schedule(down, idx);
+    }
+
+    BOOST_FOREACH (task_t const up, info.upstream)
+    {
+      try_schedule(up, idx);
+    }
+  }
+}
+
+bool
+thread_pool_scheduler::priv
+::is_ready(process_info const& info) const
+{
+  // The process is idle here (or reentrant, which makes the check safe), so
+  // nothing else consumes its inputs or fills its outputs while it is being
+  // checked.
+  return info.process->ready();
+}
+
+void
+thread_pool_scheduler::priv
+::try_schedule(task_t task, size_t idx)
+{
+  process_info& info = processes[task];
+
+  {
+    boost::mutex::scoped_lock const lock(info.mut);
+
+    (void)lock;
+
+    if (info.state != state_idle)
+    {
+      return;
+    }
+
+    if (!is_ready(info))
+    {
+      return;
+    }
+
+    if (info.reentrant)
+    {
+      if (!reserve_reentrant_step(task))
+      {
+        return;
+      }
+    }
+    else
+    {
+      info.state = state_queued;
+    }
+  }
+
+  size_t const target = (info.pinned ? info.worker : idx);
+  worker_queue& queue = queues[target];
+
+  // Count the task before it is visible so that the count never drops below
+  // the number of queued tasks.
+  {
+    boost::mutex::scoped_lock const lock(idle_mut);
+
+    (void)lock;
+
+    if (info.pinned)
+    {
+      ++queue.pinned_pending;
+    }
+    else
+    {
+      ++pending;
+    }
+  }
+
+  {
+    boost::mutex::scoped_lock const queue_lock(queue.mut);
+
+    (void)queue_lock;
+
+    if (info.pinned)
+    {
+      queue.pinned_tasks.push_back(task);
+    }
+    else
+    {
+      queue.tasks.push_back(task);
+    }
+  }
+
+  if (info.pinned)
+  {
+    idle_cond.notify_all();
+  }
+  else
+  {
+    idle_cond.notify_one();
+  }
+}
+
+bool
+thread_pool_scheduler::priv
+::reserve_reentrant_step(task_t task)
+{
+  boost::mutex::scoped_lock const lock(idle_mut);
+
+  (void)lock;
+
+  // Reentrant steps may wait on each other to push their outputs, so they
+  // must never take every worker.
+  if (max_in_flight <= reentrant_in_flight)
+  {
+    if (std::find(deferred.begin(), deferred.end(), task) == deferred.end())
+    {
+      deferred.push_back(task);
+    }
+
+    return false;
+  }
+
+  ++reentrant_in_flight;
+
+  return true;
+}
+
+void
+thread_pool_scheduler::priv
+::release_reentrant_step(size_t idx)
+{
+  task_queue_t retry;
+
+  {
+    boost::mutex::scoped_lock const lock(idle_mut);
+
+    (void)lock;
+
+    --reentrant_in_flight;
+
+    retry.swap(deferred);
+  }
+
+  BOOST_FOREACH (task_t const task, retry)
+  {
+    try_schedule(task, idx);
+  }
+}
+
+bool
+thread_pool_scheduler::priv
+::find_task(size_t idx, task_t& task)
+{
+  bool found = false;
+  bool pinned = false;
+
+  // Check our own queue first, newest first, to keep data warm in the cache.
+  {
+    worker_queue& queue = queues[idx];
+
+    boost::mutex::scoped_lock const queue_lock(queue.mut);
+
+    (void)queue_lock;
+
+    if (!queue.pinned_tasks.empty())
+    {
+      task = queue.pinned_tasks.front();
+      queue.pinned_tasks.pop_front();
+
+      found = true;
+      pinned = true;
+    }
+    else if (!queue.tasks.empty())
+    {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+
+      found = true;
+    }
+  }
+
+  // Steal the oldest work from the other workers.
+  for (size_t i = 1; !found && (i < num_threads); ++i)
+  {
+    worker_queue& queue = queues[(idx + i) % num_threads];
+
+    boost::mutex::scoped_lock const queue_lock(queue.mut);
+
+    (void)queue_lock;
+
+    if (!queue.tasks.empty())
+    {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+
+      found = true;
+    }
+  }
+
+  if (!found)
+  {
+    return false;
+  }
+
+  {
+    boost::mutex::scoped_lock const lock(idle_mut);
+
+    (void)lock;
+
+    if (pinned)
+    {
+      --queues[idx].pinned_pending;
+    }
+    else
+    {
+      --pending;
+    }
+  }
+
+  process_info& info = processes[task];
+
+  boost::mutex::scoped_lock const lock(info.mut);
+
+  (void)lock;
+
+  if (!info.reentrant)
+  {
+    info.state = state_running;
+  }
+
+  return true;
+}
+
+void
+thread_pool_scheduler::priv
+::process_complete()
+{
+  {
+    boost::mutex::scoped_lock const lock(idle_mut);
+
+    (void)lock;
+
+    --remaining;
+
+    if (remaining)
+    {
+      return;
+    }
+
+    complete = true;
+  }
+
+  idle_cond.notify_all();
+}
+
+thread_pool_scheduler::priv::process_info
+::process_info(process_t const& process_, size_t worker_)
+  : process(process_)
+  , stepped_complete(false)
+  , upstream()
+  , downstream()
+  , pinned(false)
+  , worker(worker_)
+  , reentrant(false)
+  , state(state_idle)
+  , mut()
+{
+}
+
+thread_pool_scheduler::priv::process_info
+::~process_info()
+{
+  process->set_step_callback(process::step_callback_t());
+}
+
+void
+thread_pool_scheduler::priv::process_info
+::stepped(bool complete)
+{
+  // Steps of reentrant processes may finish in any order, so completion is
+  // never taken back.
+  if (!complete)
+  {
+    return;
+  }
+
+  boost::mutex::scoped_lock const lock(mut);
+
+  (void)lock;
+
+  stepped_complete = true;
+}
+
+thread_pool_scheduler::priv::worker_queue
+::worker_queue()
+  : tasks()
+  , pinned_tasks()
+  , pinned_pending(0)
+  , mut()
+{
+}
+
+thread_pool_scheduler::priv::worker_queue
+::~worker_queue()
+{
+}
 }
@@ -51,13 +51,32 @@ namespace sprokit
 /**
  * \class thread_pool_scheduler
  *
- * \brief A scheduler which process execution among a group of threads.
+ * \brief A scheduler which distributes process execution among a group of threads.
  *
  * \scheduler Manages execution using a set number of threads.
  *
+ * Each worker thread owns a queue of runnable processes and steals from the
+ * other workers when its own queue is empty. A process is only queued when its
+ * required input edges have enough data for a step and none of its output
+ * edges are full. Each process has at most one step in flight at a time,
+ * except for \link process::is_reentrant reentrant\endlink processes. Their
+ * steps may run on several workers at once, but at most \c num_threads - 1 of
+ * them are in flight across the whole pool so that a worker is always left
+ * for the rest of the pipeline. Each such step keeps a place free on the
+ * output edges until its outputs are pushed, and the outputs are pushed in
+ * the order the steps took their inputs. Processes with the \c _no_thread
+ * property are always stepped from the same worker.
+ *
+ * \note Processes which grab more data than their port frequencies declare
+ * may still block the worker which is stepping them.
+ *
  * \configs
  *
  * \config{num_threads} The number of threads to run. A setting of \c 0 means "auto".
+ *
+ * With \key{affinity}, each worker is pinned to one of the processors in the
+ * list in turn. Per-process settings are ignored since processes move between
+ * workers.
  */
 class SPROKIT_SCHEDULERS_EXAMPLES_NO_EXPORT thread_pool_scheduler
   : public scheduler
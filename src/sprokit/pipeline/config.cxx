@@ -32,13 +32,18 @@
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
-#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_set.hpp>
 #include <boost/foreach.hpp>
-#include <boost/none.hpp>
 
-#include <algorithm>
-#include <iterator>
+#include <map>
+#include <set>
 #include <sstream>
+#include <utility>
+
+#include <cstddef>
 
 /**
  * \file config.cxx
@@ -54,6 +59,82 @@ config::key_t const config::global_value = key_t("_global");
 
 static bool does_not_begin_with(config::key_t const& key, config::key_t const& name);
 static config::key_t strip_block_name(config::key_t const& subblock, config::key_t const& key);
+static bool key_for_view(config::keys_t const& path, config::key_t& key);
+static config::keys_t child_path(config::keys_t const& path, config::key_t const& name);
+
+class config::priv
+{
+  public:
+    priv();
+    priv(config_t const& parent_, key_t const& name);
+    ~priv();
+
+    typedef boost::mutex mutex_t;
+    typedef boost::unique_lock<mutex_t> unique_lock_t;
+
+    class entry
+    {
+      public:
+        entry();
+        ~entry();
+
+        value_t value;
+        std::type_info const* cached_type;
+        cached_value_t cached;
+    };
+    typedef std::map<key_t, entry> store_t;
+
+    // A key looked up through a view without building the full key.
+    class view_key
+    {
+      public:
+        view_key(key_t const& prefix_, size_t prefix_hash_, key_t const& key_);
+        ~view_key();
+
+        key_t const& prefix;
+        size_t const prefix_hash;
+        key_t const& key;
+    };
+
+    class key_hash
+    {
+      public:
+        size_t operator () (store_t::iterator const& i) const;
+        size_t operator () (view_key const& key) const;
+    };
+
+    class key_equal
+    {
+      public:
+        bool operator () (store_t::iterator const& a, store_t::iterator const& b) const;
+        bool operator () (view_key const& a, store_t::iterator const& b) const;
+    };
+
+    typedef boost::unordered_set<store_t::iterator, key_hash, key_equal> index_t;
+    typedef std::set<key_t> ro_list_t;
+
+    // These require the lock of the root.
+    store_t::iterator find(key_t const& key) const;
+    void add_range(key_t const& block_prefix, std::map<key_t, key_t>& keys) const;
+
+    // These are only called on the root.
+    void set(key_t const& key, value_t const& value);
+    void unset(key_t const& key);
+
+    static size_t hash_key(size_t seed, key_t const& key);
+
+    config_t const parent;
+    keys_t const path;
+    key_t const prefix;
+    size_t const prefix_hash;
+    priv* const root;
+
+    store_t store;
+    index_t index;
+    ro_list_t ro_list;
+
+    mutable mutex_t mut;
+};
 
 config_t
 config
@@ -99,20 +180,13 @@ void
 config
 ::set_value(key_t const& key, value_t const& value)
 {
-  if (m_parent)
+  if (d->parent)
   {
-    m_parent->set_value(m_name + block_sep + key, value);
+    d->root->set(d->prefix + key, value);
   }
   else
   {
-    if (is_read_only(key))
-    {
-      value_t const current_value = get_value<value_t>(key, value_t());
-
-      throw set_on_read_only_value_exception(key, current_value, value);
-    }
-
-    m_store[key] = value;
+    d->set(key, value);
   }
 }
 
@@ -120,27 +194,13 @@ void
 config
 ::unset_value(key_t const& key)
 {
-  if (m_parent)
+  if (d->parent)
   {
-    m_parent->unset_value(m_name + block_sep + key);
+    d->root->unset(d->prefix + key);
   }
   else
   {
-    if (is_read_only(key))
-    {
-      value_t const current_value = get_value<value_t>(key, value_t());
-
-      throw unset_on_read_only_value_exception(key, current_value);
-    }
-
-    store_t::iterator const i = m_store.find(key);
-
-    if (i == m_store.end())
-    {
-      throw no_such_configuration_value_exception(key);
-    }
-
-    m_store.erase(i);
+    d->unset(key);
   }
 }
 
@@ -148,14 +208,14 @@ bool
 config
 ::is_read_only(key_t const& key) const
 {
-  return (0 != m_ro_list.count(key));
+  return (0 != d->ro_list.count(key));
 }
 
 void
 config
 ::mark_read_only(key_t const& key)
 {
-  m_ro_list.insert(key);
+  d->ro_list.insert(key);
 }
 
 void
@@ -178,24 +238,45 @@ ::available_values() const
 {
   keys_t keys;
 
-  if (m_parent)
-  {
-    keys_t parent_keys = m_parent->available_values();
-
-    keys_t::iterator const i = std::remove_if(parent_keys.begin(), parent_keys.end(), boost::bind(does_not_begin_with, _1, m_name));
+  priv::unique_lock_t const lock(d->root->mut);
 
-    parent_keys.erase(i, parent_keys.end());
+  (void)lock;
 
-    std::transform(parent_keys.begin(), parent_keys.end(), std::back_inserter(keys), boost::bind(strip_block_name, m_name, _1));
-  }
-  else
+  if (!d->parent)
   {
-    BOOST_FOREACH (store_t::value_type const& value, m_store)
+    BOOST_FOREACH (priv::store_t::value_type const& value, d->store)
     {
       key_t const& key = value.first;
 
       keys.push_back(key);
     }
+
+    return keys;
+  }
+
+  static key_t const global_start = global_value + block_sep;
+
+  // Global values from any enclosing block are visible within a view, so the
+  // ranges for those are searched in addition to the block itself.
+  typedef std::map<key_t, key_t> key_map_t;
+
+  key_map_t view_keys;
+  key_t block_prefix;
+
+  BOOST_FOREACH (key_t const& name, d->path)
+  {
+    d->add_range(block_prefix + global_start, view_keys);
+
+    block_prefix += name + block_sep;
+  }
+
+  d->add_range(block_prefix, view_keys);
+
+  BOOST_FOREACH (key_map_t::value_type const& view_key, view_keys)
+  {
+    key_t const& key = view_key.second;
+
+    keys.push_back(key);
   }
 
   return keys;
@@ -205,52 +286,91 @@ bool
 config
 ::has_value(key_t const& key) const
 {
-  if (m_parent)
-  {
-    return m_parent->has_value(m_name + block_sep + key);
-  }
+  priv::unique_lock_t const lock(d->root->mut);
 
-  return (0 != m_store.count(key));
+  (void)lock;
+
+  return (d->find(key) != d->root->store.end());
 }
 
 config
 ::config(key_t const& name, config_t parent)
-  : m_parent(parent)
-  , m_name(name)
-  , m_store()
-  , m_ro_list()
+  : d(parent ? new priv(parent, name) : new priv)
 {
 }
 
-boost::optional<config::value_t>
+bool
 config
-::find_value(key_t const& key) const
+::find_value(key_t const& key, std::type_info const& type, value_t& value, cached_value_t& cached) const
 {
-  if (!has_value(key))
+  priv::unique_lock_t const lock(d->root->mut);
+
+  (void)lock;
+
+  priv::store_t::iterator const i = d->find(key);
+
+  if (i == d->root->store.end())
   {
-    return boost::none;
+    return false;
   }
 
-  return get_value(key);
+  priv::entry const& ent = i->second;
+
+  if (ent.cached && (*ent.cached_type == type))
+  {
+    cached = ent.cached;
+  }
+  else
+  {
+    value = ent.value;
+  }
+
+  return true;
 }
 
-config::value_t
+void
 config
-::get_value(key_t const& key) const
+::cache_value(key_t const& key, value_t const& value, std::type_info const& type, cached_value_t const& cached) const
 {
-  if (m_parent)
+  priv::unique_lock_t const lock(d->root->mut);
+
+  (void)lock;
+
+  priv::store_t::iterator const i = d->find(key);
+
+  if (i == d->root->store.end())
+  {
+    return;
+  }
+
+  priv::entry& ent = i->second;
+
+  // The value may have been changed since it was parsed.
+  if (ent.value != value)
   {
-    return m_parent->get_value(m_name + block_sep + key);
+    return;
   }
 
-  store_t::const_iterator i = m_store.find(key);
+  ent.cached_type = &type;
+  ent.cached = cached;
+}
+
+config::value_t
+config
+::get_value(key_t const& key) const
+{
+  priv::unique_lock_t const lock(d->root->mut);
+
+  (void)lock;
+
+  priv::store_t::iterator const i = d->find(key);
 
-  if (i == m_store.end())
+  if (i == d->root->store.end())
   {
     return value_t();
   }
 
-  return i->second;
+  return i->second.value;
 }
 
 configuration_exception
@@ -400,4 +520,224 @@ strip_block_name(config::key_t const& subblock, config::key_t const& key)
   return key.substr(subblock.size() + config::block_sep.size());
 }
 
+bool
+key_for_view(config::keys_t const& path, config::key_t& key)
+{
+  BOOST_FOREACH (config::key_t const& name, path)
+  {
+    if (does_not_begin_with(key, name))
+    {
+      return false;
+    }
+
+    key = strip_block_name(name, key);
+  }
+
+  return true;
+}
+
+config::keys_t
+child_path(config::keys_t const& path, config::key_t const& name)
+{
+  config::keys_t child = path;
+
+  child.push_back(name);
+
+  return child;
+}
+
+config::priv
+::priv()
+  : parent()
+  , path()
+  , prefix()
+  , prefix_hash(0)
+  , root(this)
+  , store()
+  , index()
+  , ro_list()
+  , mut()
+{
+}
+
+config::priv
+::priv(config_t const& parent_, key_t const& name)
+  : parent(parent_)
+  , path(child_path(parent->d->path, name))
+  , prefix(parent->d->prefix + name + block_sep)
+  , prefix_hash(hash_key(parent->d->prefix_hash, name + block_sep))
+  , root(parent->d->root)
+  , store()
+  , index()
+  , ro_list()
+  , mut()
+{
+}
+
+config::priv
+::~priv()
+{
+}
+
+config::priv::store_t::iterator
+config::priv
+::find(key_t const& key) const
+{
+  index_t::const_iterator const i = root->index.find(view_key(prefix, prefix_hash, key), key_hash(), key_equal());
+
+  if (i == root->index.end())
+  {
+    return root->store.end();
+  }
+
+  return *i;
+}
+
+void
+config::priv
+::add_range(key_t const& block_prefix, std::map<key_t, key_t>& keys) const
+{
+  store_t::const_iterator i = root->store.lower_bound(block_prefix);
+  store_t::const_iterator const e = root->store.end();
+
+  for ( ; (i != e) && boost::starts_with(i->first, block_prefix); ++i)
+  {
+    key_t stripped_key = i->first;
+
+    if (key_for_view(path, stripped_key))
+    {
+      keys[i->first] = stripped_key;
+    }
+  }
+}
+
+void
+config::priv
+::set(key_t const& key, value_t const& value)
+{
+  unique_lock_t const lock(mut);
+
+  (void)lock;
+
+  if (ro_list.count(key))
+  {
+    store_t::const_iterator const i = store.find(key);
+    value_t const current_value = ((i == store.end()) ? value_t() : i->second.value);
+
+    throw set_on_read_only_value_exception(key, current_value, value);
+  }
+
+  std::pair<store_t::iterator, bool> const result = store.insert(store_t::value_type(key, entry()));
+
+  if (result.second)
+  {
+    index.insert(result.first);
+  }
+
+  entry& ent = result.first->second;
+
+  ent.value = value;
+  ent.cached_type = NULL;
+  ent.cached.reset();
+}
+
+void
+config::priv
+::unset(key_t const& key)
+{
+  unique_lock_t const lock(mut);
+
+  (void)lock;
+
+  store_t::iterator const i = find(key);
+
+  if (ro_list.count(key))
+  {
+    value_t const current_value = ((i == store.end()) ? value_t() : i->second.value);
+
+    throw unset_on_read_only_value_exception(key, current_value);
+  }
+
+  if (i == store.end())
+  {
+    throw no_such_configuration_value_exception(key);
+  }
+
+  index.erase(i);
+  store.erase(i);
+}
+
+size_t
+config::priv
+::hash_key(size_t seed, key_t const& key)
+{
+  // Hashing character by character allows the hash of a view's prefix to be
+  // continued with the key instead of hashing the concatenation.
+  BOOST_FOREACH (char const c, key)
+  {
+    boost::hash_combine(seed, c);
+  }
+
+  return seed;
+}
+
+config::priv::entry
+::entry()
+  : value()
+  , cached_type(NULL)
+  , cached()
+{
+}
+
+config::priv::entry
+::~entry()
+{
+}
+
+config::priv::view_key
+::view_key(key_t const& prefix_, size_t prefix_hash_, key_t const& key_)
+  : prefix(prefix_)
+  , prefix_hash(prefix_hash_)
+  , key(key_)
+{
+}
+
+config::priv::view_key
+::~view_key()
+{
+}
+
+size_t
+config::priv::key_hash
+::operator () (store_t::iterator const& i) const
+{
+  return hash_key(0, i->first);
+}
+
+size_t
+config::priv::key_hash
+::operator () (view_key const& key) const
+{
+  return hash_key(key.prefix_hash, key.key);
+}
+
+bool
+config::priv::key_equal
+::operator () (store_t::iterator const& a, store_t::iterator const& b) const
+{
+  return (a->first == b->first);
+}
+
+bool
+config::priv::key_equal
+::operator () (view_key const& a, store_t::iterator const& b) const
+{
+  key_t const& key = b->first;
+  size_t const prefix_size = a.prefix.size();
+
+  return ((key.size() == (prefix_size + a.key.size())) &&
+          !key.compare(0, prefix_size, a.prefix) &&
+          !key.compare(prefix_size, key_t::npos, a.key));
+}
+
 }
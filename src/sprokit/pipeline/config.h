@@ -39,6 +39,8 @@
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <map>
 #include <set>
@@ -62,6 +64,11 @@ namespace sprokit
  *
  * \brief Stores configuration values for use within a \ref pipeline.
  *
+ * Values are kept in a single table owned by the root configuration. Views
+ * resolve their keys against that table directly using a prefix computed when
+ * the view is created rather than walking up their parents. The result of the
+ * last typed \ref get_value call for a key is cached until the value changes.
+ *
  * \ingroup base_classes
  */
 class SPROKIT_PIPELINE_EXPORT config
@@ -232,16 +239,17 @@ class SPROKIT_PIPELINE_EXPORT config
   private:
     SPROKIT_PIPELINE_NO_EXPORT config(key_t const& name, config_t parent);
 
-    boost::optional<value_t> find_value(key_t const& key) const;
-    SPROKIT_PIPELINE_NO_EXPORT value_t get_value(key_t const& key) const;
+    /// The type of a parsed value which is cached for a key.
+    typedef boost::shared_ptr<void const> cached_value_t;
 
-    typedef std::map<key_t, value_t> store_t;
-    typedef std::set<key_t> ro_list_t;
+    bool find_value(key_t const& key, std::type_info const& type, value_t& value, cached_value_t& cached) const;
+    void cache_value(key_t const& key, value_t const& value, std::type_info const& type, cached_value_t const& cached) const;
+    template <typename T>
+    T parse_value(key_t const& key, value_t const& value) const;
+    SPROKIT_PIPELINE_NO_EXPORT value_t get_value(key_t const& key) const;
 
-    config_t m_parent;
-    key_t m_name;
-    store_t m_store;
-    ro_list_t m_ro_list;
+    class SPROKIT_PIPELINE_NO_EXPORT priv;
+    boost::scoped_ptr<priv> d;
 };
 
 /**
@@ -488,21 +496,20 @@ T
 config
 ::get_value(key_t const& key) const
 {
-  boost::optional<value_t> value = find_value(key);
+  value_t value;
+  cached_value_t cached;
 
-  if (!value)
+  if (!find_value(key, typeid(T), value, cached))
   {
     throw no_such_configuration_value_exception(key);
   }
 
-  try
+  if (cached)
   {
-    return config_cast<T>(*value);
-  }
-  catch (bad_configuration_cast const& e)
-  {
-    throw bad_configuration_cast_exception(key, *value, typeid(T).name(), e.what());
+    return *static_cast<T const*>(cached.get());
   }
+
+  return parse_value<T>(key, value);
 }
 
 template <typename T>
@@ -512,7 +519,21 @@ ::get_value(key_t const& key, T const& def) const SPROKIT_NOTHROW
 {
   try
   {
-    return get_value<T>(key);
+    value_t value;
+    cached_value_t cached;
+
+    // Missing keys are common here; avoid throwing for them.
+    if (!find_value(key, typeid(T), value, cached))
+    {
+      return def;
+    }
+
+    if (cached)
+    {
+      return *static_cast<T const*>(cached.get());
+    }
+
+    return parse_value<T>(key, value);
   }
   catch (...)
   {
@@ -520,6 +541,29 @@ ::get_value(key_t const& key, T const& def) const SPROKIT_NOTHROW
   }
 }
 
+template <typename T>
+T
+config
+::parse_value(key_t const& key, value_t const& value) const
+{
+  try
+  {
+    T const typed_value = config_cast<T>(value);
+
+    // Strings are stored as-is; caching them would only duplicate the value.
+    if (typeid(T) != typeid(value_t))
+    {
+      cache_value(key, value, typeid(T), cached_value_t(new T(typed_value)));
+    }
+
+    return typed_value;
+  }
+  catch (bad_configuration_cast const& e)
+  {
+    throw bad_configuration_cast_exception(key, value, typeid(T).name(), e.what());
+  }
+}
+
 }
 
 #endif // SPROKIT_PIPELINE_CONFIG_H
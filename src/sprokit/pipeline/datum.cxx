@@ -30,6 +30,9 @@
 
 #include "datum.h"
 
+#include "pool.h"
+
+#include <new>
 #include <sstream>
 
 /**
@@ -41,38 +44,74 @@
 namespace sprokit
 {
 
+typedef pool_allocator<datum> datum_allocator_t;
+typedef pool_deleter<datum> datum_deleter_t;
+
 datum_t
 datum::new_datum(boost::any const& dat)
 {
-  return datum_t(new datum(dat));
+  return create(&payload<boost::any>::ops, &dat);
 }
 
+// Datums without a payload are immutable and indistinguishable from each
+// other, so a single instance of each is shared rather than allocating one
+// for every step.
+
 datum_t
 datum
 ::empty_datum()
 {
-  return datum_t(new datum(empty));
+  static datum_t const dat(new datum(empty));
+
+  return dat;
 }
 
 datum_t
 datum
 ::flush_datum()
 {
-  return datum_t(new datum(flush));
+  static datum_t const dat(new datum(flush));
+
+  return dat;
 }
 
 datum_t
 datum
 ::complete_datum()
 {
-  return datum_t(new datum(complete));
+  static datum_t const dat(new datum(complete));
+
+  return dat;
 }
 
 datum_t
 datum
 ::error_datum(error_t const& error)
 {
-  return datum_t(new datum(error));
+  void* const mem = pool_allocate(sizeof(datum));
+  datum* ptr;
+
+  try
+  {
+    ptr = new (mem) datum(error);
+  }
+  catch (...)
+  {
+    pool_deallocate(mem, sizeof(datum));
+
+    throw;
+  }
+
+  return datum_t(ptr, datum_deleter_t(), datum_allocator_t());
+}
+
+datum
+::~datum()
+{
+  if (m_ops)
+  {
+    m_ops->destroy(m_storage);
+  }
 }
 
 datum::type_t
@@ -89,11 +128,83 @@ ::get_error() const
   return m_error;
 }
 
+size_t
+datum
+::size() const
+{
+  if (!m_ops)
+  {
+    return 0;
+  }
+
+  return m_ops->size(m_storage);
+}
+
+datum_t
+datum
+::create(payload_ops const* ops, void const* src)
+{
+  void* const mem = pool_allocate(sizeof(datum));
+  datum* ptr;
+
+  try
+  {
+    ptr = new (mem) datum(ops, src);
+  }
+  catch (...)
+  {
+    pool_deallocate(mem, sizeof(datum));
+
+    throw;
+  }
+
+  return datum_t(ptr, datum_deleter_t(), datum_allocator_t());
+}
+
+void const*
+datum
+::find_payload(std::type_info const& requested) const
+{
+  if (!m_ops || (m_ops->type() != requested))
+  {
+    return NULL;
+  }
+
+  return m_ops->address(m_storage);
+}
+
+void
+datum
+::throw_bad_cast(std::type_info const& requested) const
+{
+  std::string const req_type_name = requested.name();
+  std::string type_name = typeid(void).name();
+
+  if (m_ops)
+  {
+    boost::any const* const any = static_cast<boost::any const*>(find_payload(typeid(boost::any)));
+
+    if (any)
+    {
+      type_name = any->type().name();
+    }
+    else
+    {
+      type_name = m_ops->type().name();
+    }
+  }
+
+  boost::bad_any_cast const e;
+
+  throw bad_datum_cast_exception(req_type_name, type_name, m_type, m_error, e.what());
+}
+
 datum
 ::datum(type_t ty)
   : m_type(ty)
   , m_error()
-  , m_datum()
+  , m_ops(NULL)
+  , m_storage()
 {
 }
 
@@ -101,16 +212,19 @@ datum
 ::datum(error_t const& err)
   : m_type(error)
   , m_error(err)
-  , m_datum()
+  , m_ops(NULL)
+  , m_storage()
 {
 }
 
 datum
-::datum(boost::any const& dat)
+::datum(payload_ops const* ops, void const* src)
   : m_type(data)
   , m_error()
-  , m_datum(dat)
+  , m_ops(ops)
+  , m_storage()
 {
+  m_ops->construct(m_storage, src);
 }
 
 datum_exception
@@ -36,8 +36,16 @@
 #include "types.h"
 
 #include <boost/any.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 
+#include <new>
 #include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <cstddef>
 
 /**
  * \file datum.h
@@ -48,14 +56,42 @@
 namespace sprokit
 {
 
+/**
+ * \class datum_size datum.h <sprokit/pipeline/datum.h>
+ *
+ * \brief The amount of memory held by a value passed through the pipeline.
+ *
+ * Only the object itself is counted by default. Types which own memory
+ * elsewhere (such as images) should specialize this so that \link edge
+ * edges\endlink with a memory limit can account for it.
+ */
+template <typename T>
+class datum_size
+{
+  public:
+    /**
+     * \brief Query the memory held by a value.
+     *
+     * \param value The value to measure.
+     *
+     * \returns The number of bytes held by \p value.
+     */
+    static size_t size(T const& value);
+};
+
 /**
  * \class datum datum.h <sprokit/pipeline/datum.h>
  *
  * \brief A wrapper for data that passes through an \ref edge in the \ref pipeline.
  *
+ * Small values (up to four pointers in size) are stored within the datum
+ * itself; larger values are stored on the heap. Either way, the value may be
+ * accessed by reference with \ref get_datum_ref.
+ *
  * \ingroup base_classes
  */
 class SPROKIT_PIPELINE_EXPORT datum
+  : boost::noncopyable
 {
   public:
     /// Information about an error that occurred within a process.
@@ -125,6 +161,11 @@ class SPROKIT_PIPELINE_EXPORT datum
      */
     static datum_t error_datum(error_t const& error);
 
+    /**
+     * \brief Destructor.
+     */
+    ~datum();
+
     /**
      * \brief Query a datum for the type.
      *
@@ -148,14 +189,68 @@ class SPROKIT_PIPELINE_EXPORT datum
      */
     template <typename T>
     T get_datum() const;
+    /**
+     * \brief Access the result within a datum without copying it.
+     *
+     * \throws bad_datum_cast_exception Thrown when the data cannot be cast as requested.
+     *
+     * \returns The result contained within the datum.
+     */
+    template <typename T>
+    T const& get_datum_ref() const;
+
+    /**
+     * \brief Query the memory held by the result within a datum.
+     *
+     * \returns The size given by \ref datum_size for the result, or \c 0 if there is no result.
+     */
+    size_t size() const;
   private:
+    static size_t const payload_size = 4 * sizeof(void*);
+    typedef boost::aligned_storage<payload_size> payload_storage_t;
+
+    class payload_ops
+    {
+      public:
+        std::type_info const& (*type)();
+        void (*construct)(payload_storage_t& storage, void const* src);
+        void (*destroy)(payload_storage_t& storage);
+        void const* (*address)(payload_storage_t const& storage);
+        boost::any (*to_any)(payload_storage_t const& storage);
+        size_t (*size)(payload_storage_t const& storage);
+    };
+
+    template <typename T>
+    class payload
+    {
+      public:
+        static bool const in_place =
+          ((sizeof(T) <= payload_size) &&
+           (boost::alignment_of<T>::value <= boost::alignment_of<payload_storage_t>::value));
+
+        static std::type_info const& type();
+        static void construct(payload_storage_t& storage, void const* src);
+        static void destroy(payload_storage_t& storage);
+        static void const* address(payload_storage_t const& storage);
+        static boost::any to_any(payload_storage_t const& storage);
+        static size_t size(payload_storage_t const& storage);
+
+        static payload_ops const ops;
+    };
+
+    static datum_t create(payload_ops const* ops, void const* src);
+
+    void const* find_payload(std::type_info const& requested) const;
+    void throw_bad_cast(std::type_info const& requested) const;
+
     SPROKIT_PIPELINE_NO_EXPORT datum(type_t ty);
     SPROKIT_PIPELINE_NO_EXPORT datum(error_t const& err);
-    SPROKIT_PIPELINE_NO_EXPORT datum(boost::any const& dat);
+    SPROKIT_PIPELINE_NO_EXPORT datum(payload_ops const* ops, void const* src);
 
     type_t const m_type;
     error_t const m_error;
-    boost::any const m_datum;
+    payload_ops const* const m_ops;
+    payload_storage_t m_storage;
 };
 
 /**
@@ -218,35 +313,195 @@ class SPROKIT_PIPELINE_EXPORT bad_datum_cast_exception
 };
 
 template <typename T>
-datum_t
-datum::new_datum(T const& dat)
+size_t
+datum_size<T>
+::size(T const& /*value*/)
 {
-  return new_datum(boost::any(dat));
+  return sizeof(T);
 }
 
+/// The memory held by a string.
+template <>
+inline
+size_t
+datum_size<std::string>
+::size(std::string const& value)
+{
+  return (sizeof(std::string) + value.capacity());
+}
+
+/**
+ * \class datum_size<std::vector<T, Alloc> > datum.h <sprokit/pipeline/datum.h>
+ *
+ * \brief The memory held by a vector.
+ *
+ * Memory owned by the elements themselves is not counted.
+ */
+template <typename T, typename Alloc>
+class datum_size<std::vector<T, Alloc> >
+{
+  public:
+    /**
+     * \brief Query the memory held by a vector.
+     *
+     * \param value The vector to measure.
+     *
+     * \returns The number of bytes held by \p value.
+     */
+    static size_t size(std::vector<T, Alloc> const& value)
+    {
+      return (sizeof(std::vector<T, Alloc>) + (value.capacity() * sizeof(T)));
+    }
+};
+
 template <typename T>
-T
-datum::get_datum() const
+std::type_info const&
+datum::payload<T>
+::type()
+{
+  return typeid(T);
+}
+
+template <typename T>
+void
+datum::payload<T>
+::construct(payload_storage_t& storage, void const* src)
 {
-  try
+  T const& value = *static_cast<T const*>(src);
+
+  if (in_place)
   {
-    return boost::any_cast<T>(m_datum);
+    new (storage.address()) T(value);
   }
-  catch (boost::bad_any_cast const& e)
+  else
   {
-    std::string const req_type_name = typeid(T).name();
-    std::string const type_name = m_datum.type().name();
+    T* const ptr = new T(value);
 
-    throw bad_datum_cast_exception(req_type_name, type_name, m_type, m_error, e.what());
+    new (storage.address()) T*(ptr);
+  }
+}
+
+template <typename T>
+void
+datum::payload<T>
+::destroy(payload_storage_t& storage)
+{
+  if (in_place)
+  {
+    static_cast<T*>(storage.address())->~T();
+  }
+  else
+  {
+    delete *static_cast<T**>(storage.address());
   }
 }
 
+template <typename T>
+void const*
+datum::payload<T>
+::address(payload_storage_t const& storage)
+{
+  if (in_place)
+  {
+    return storage.address();
+  }
+
+  return *static_cast<T const* const*>(storage.address());
+}
+
+template <typename T>
+boost::any
+datum::payload<T>
+::to_any(payload_storage_t const& storage)
+{
+  return boost::any(*static_cast<T const*>(address(storage)));
+}
+
+template <>
+inline
+boost::any
+datum::payload<boost::any>
+::to_any(payload_storage_t const& storage)
+{
+  return *static_cast<boost::any const*>(address(storage));
+}
+
+template <typename T>
+size_t
+datum::payload<T>
+::size(payload_storage_t const& storage)
+{
+  return datum_size<T>::size(*static_cast<T const*>(address(storage)));
+}
+
+template <typename T>
+datum::payload_ops const datum::payload<T>::ops =
+{
+  &datum::payload<T>::type,
+  &datum::payload<T>::construct,
+  &datum::payload<T>::destroy,
+  &datum::payload<T>::address,
+  &datum::payload<T>::to_any,
+  &datum::payload<T>::size
+};
+
+template <typename T>
+datum_t
+datum::new_datum(T const& dat)
+{
+  return create(&payload<T>::ops, &dat);
+}
+
+template <typename T>
+T
+datum::get_datum() const
+{
+  return get_datum_ref<T>();
+}
+
 template <>
 inline
 boost::any
 datum::get_datum() const
 {
-  return m_datum;
+  if (!m_ops)
+  {
+    return boost::any();
+  }
+
+  return m_ops->to_any(m_storage);
+}
+
+template <typename T>
+T const&
+datum::get_datum_ref() const
+{
+  // Payloads created within the same library share the operations table, so
+  // the common case avoids comparing type information altogether.
+  if (m_ops == &payload<T>::ops)
+  {
+    return *static_cast<T const*>(m_ops->address(m_storage));
+  }
+
+  void const* ptr = find_payload(typeid(T));
+
+  if (!ptr)
+  {
+    // Bindings create datums from boost::any objects directly.
+    boost::any const* const any = static_cast<boost::any const*>(find_payload(typeid(boost::any)));
+
+    if (any)
+    {
+      ptr = boost::any_cast<T>(any);
+    }
+  }
+
+  if (!ptr)
+  {
+    throw_bad_cast(typeid(T));
+  }
+
+  return *static_cast<T const*>(ptr);
 }
 
 }
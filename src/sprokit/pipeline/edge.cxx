@@ -31,15 +31,31 @@
 #include "edge.h"
 #include "edge_exception.h"
 
+#include "datum.h"
+#include "instrumentation.h"
+#include "memory_budget.h"
 #include "stamp.h"
+#include "statistics.h"
 #include "types.h"
 
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/version.hpp>
+#include <boost/foreach.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 
+// XXX(boost): 1.53.0
+#if BOOST_VERSION >= 105300
+#define HAVE_LOCK_FREE_EDGES
+#include <boost/atomic.hpp>
+#endif
+
 #include <deque>
+#include <utility>
+#include <vector>
 
 /**
  * \file edge.cxx
@@ -64,6 +80,15 @@ ::edge_datum_t(datum_t const& datum_, stamp_t const& stamp_)
 {
 }
 
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+edge_datum_t
+::edge_datum_t(datum_t&& datum_, stamp_t&& stamp_)
+  : datum(std::move(datum_))
+  , stamp(std::move(stamp_))
+{
+}
+#endif
+
 edge_datum_t
 ::~edge_datum_t()
 {
@@ -79,26 +104,80 @@ ::operator == (edge_datum_t const& rhs) const
 
 config::key_t const edge::config_dependency = config::key_t("_dependency");
 config::key_t const edge::config_capacity = config::key_t("capacity");
+config::key_t const edge::config_capacity_bytes = config::key_t("capacity_bytes");
+config::key_t const edge::config_lock_free = config::key_t("lock_free");
+config::key_t const edge::config_overflow_policy = config::key_t("overflow_policy");
 
 class edge::priv
 {
   public:
-    priv(bool depends_, size_t capacity_);
+    typedef enum
+    {
+      overflow_block,
+      overflow_drop_oldest,
+      overflow_drop_newest,
+      overflow_keep_latest
+    } overflow_policy_t;
+
+    priv(bool depends_, size_t capacity_, size_t capacity_bytes_, bool lock_free, overflow_policy_t policy_);
     ~priv();
 
+    static overflow_policy_t overflow_policy(config::value_t const& value);
+
     typedef boost::weak_ptr<process> process_ref_t;
 
     bool has_data() const;
     bool full_of_data() const;
+    bool has_space_for(size_t count) const;
     void complete_check() const;
+    bool accepting_data() const;
+
+    // Checks for the unsynchronized path of an inline edge.
+    bool can_push_inline(size_t count) const;
+    bool can_grab_inline(size_t count) const;
+
+    static void take(edge_datum_t& dest, edge_datum_t& src);
+    // Flush and completion packets are handled without the rest of a step's data.
+    static bool ends_group(edge_datum_t const& edat);
+
+    // Pushes without waiting, discarding data according to the policy.
+    void push_or_drop(edge_datum_t const& datum);
+    size_t drop_queued(size_t count);
+    void record_drop(edge_datum_t const& edat);
+    bool over_memory_limit() const;
+    static bool droppable(edge_datum_t const& edat);
+
+    // Memory accounting; these must be called before the datum is moved.
+    void count_push(edge_datum_t const& edat);
+    void count_grab(edge_datum_t const& edat);
+    void count_clear();
+    static size_t size_of(edge_datum_t const& edat);
+
+    template <typename Lock>
+    void wait_for_space(Lock& lock);
+    template <typename Lock>
+    void wait_for_data(Lock& lock, size_t idx = 0);
+
+    void record_push(size_t depth);
+    void record_grab(size_t count);
+    void record_push_blocked(statistic_t ns);
+    void record_grab_blocked(statistic_t ns);
 
     bool const depends;
     size_t const capacity;
+    size_t const capacity_bytes;
+    bool const lock_free;
+    overflow_policy_t const policy;
     bool downstream_complete;
+    bool inline_slot;
 
     process_ref_t upstream;
     process_ref_t downstream;
 
+    bool counts_bytes;
+    size_t bytes;
+    memory_budget_t budget;
+
     typedef std::deque<edge_datum_t> edge_queue_t;
 
     edge_queue_t q;
@@ -114,7 +193,126 @@ class edge::priv
 
     mutable mutex_t mutex;
     mutable mutex_t complete_mutex;
+
+    // Kept regardless of instrumentation since dropping data is not free.
+    statistic_t dropped;
+    stamp_t newest_dropped;
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+#ifdef HAVE_LOCK_FREE_EDGES
+    typedef boost::atomic<statistic_t> counter_t;
+#else
+    typedef statistic_t counter_t;
+#endif
+
+    static void bump(counter_t& counter, statistic_t amount);
+    static statistic_t read(counter_t const& counter);
+
+    class counters
+    {
+      public:
+        counters();
+        ~counters();
+
+        // Each group is only written by one side of the edge at a time, so
+        // keep them apart to avoid false sharing.
+        counter_t pushed;
+        counter_t high_water_mark;
+        counter_t occupancy_sum;
+        counter_t push_blocked_ns;
+
+        char pad[64];
+
+        counter_t grabbed;
+        counter_t grab_blocked_ns;
+    };
+
+    counters stats;
+#endif
+
+#ifdef HAVE_LOCK_FREE_EDGES
+    class ring_buffer;
+
+    boost::scoped_ptr<ring_buffer> ring;
+#endif
+};
+
+#ifdef HAVE_LOCK_FREE_EDGES
+/**
+ * \class edge::priv::ring_buffer
+ *
+ * \brief A bounded single-producer, single-consumer queue of edge data.
+ *
+ * The producer only writes the tail index and the consumer only writes the
+ * head index, so neither side needs a lock to move data. The mutex and
+ * condition variables are only used when one side must wait on the other
+ * because the ring is empty or full.
+ */
+class edge::priv::ring_buffer
+{
+  public:
+    ring_buffer(size_t capacity_, priv& owner_);
+    ~ring_buffer();
+
+    size_t count() const;
+    bool full() const;
+
+    void push(edge_datum_t const& datum);
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+    void push(edge_datum_t&& datum);
+#endif
+    edge_datum_t peek(size_t idx) const;
+    edge_datum_t get();
+    void pop();
+    void clear();
+
+    bool is_complete() const;
+    void mark_complete();
+  private:
+    size_t claim_slot();
+    void publish_slot(size_t tail_idx);
+
+    void wait_for_data(size_t idx) const;
+    void wait_for_space(size_t tail_idx);
+    void notify_consumer() const;
+    void notify_producer();
+
+    typedef boost::atomic<size_t> index_t;
+
+    // Keep the indices on separate cache lines so that the producer and
+    // consumer do not invalidate each other's caches with every access.
+    static size_t const cache_line_size = 64;
+
+    class padded_index
+    {
+      public:
+        padded_index();
+        ~padded_index();
+
+        index_t value;
+      private:
+        char pad[cache_line_size - sizeof(index_t)];
+    };
+
+    size_t const capacity;
+    std::vector<edge_datum_t> slots;
+
+    priv& owner;
+
+    char head_pad[cache_line_size];
+    padded_index head;
+    padded_index tail;
+
+    boost::atomic<bool> complete;
+
+    mutable boost::atomic<bool> consumer_waiting;
+    boost::atomic<bool> producer_waiting;
+
+    mutable boost::mutex wait_mutex;
+    mutable boost::condition_variable cond_have_data;
+    boost::condition_variable cond_have_space;
 };
+#endif
 
 edge
 ::edge(config_t const& config)
@@ -127,8 +325,17 @@ ::edge(config_t const& config)
 
   bool const depends = config->get_value<bool>(config_dependency, true);
   size_t const capacity = config->get_value<size_t>(config_capacity, 0);
+  size_t const capacity_bytes = config->get_value<size_t>(config_capacity_bytes, 0);
+  bool const lock_free = config->get_value<bool>(config_lock_free, false);
+  config::value_t const policy = config->get_value<config::value_t>(config_overflow_policy, "block");
+
+  // Data moved through a ring cannot be counted.
+  if (lock_free && capacity_bytes)
+  {
+    throw lock_free_memory_limit_exception();
+  }
 
-  d.reset(new priv(depends, capacity));
+  d.reset(new priv(depends, capacity, capacity_bytes, lock_free, priv::overflow_policy(policy)));
 }
 
 edge
@@ -147,6 +354,13 @@ bool
 edge
 ::has_data() const
 {
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    return (0 != d->ring->count());
+  }
+#endif
+
   priv::shared_lock_t const lock(d->mutex);
 
   (void)lock;
@@ -158,6 +372,18 @@ bool
 edge
 ::full_of_data() const
 {
+  if (d->policy != priv::overflow_block)
+  {
+    return false;
+  }
+
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    return d->ring->full();
+  }
+#endif
+
   priv::shared_lock_t const lock(d->mutex);
 
   (void)lock;
@@ -165,10 +391,40 @@ ::full_of_data() const
   return d->full_of_data();
 }
 
+bool
+edge
+::has_space_for(size_t count) const
+{
+  if (d->policy != priv::overflow_block)
+  {
+    return true;
+  }
+
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    return ((d->ring->count() + count) <= d->capacity);
+  }
+#endif
+
+  priv::shared_lock_t const lock(d->mutex);
+
+  (void)lock;
+
+  return d->has_space_for(count);
+}
+
 size_t
 edge
 ::datum_count() const
 {
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    return d->ring->count();
+  }
+#endif
+
   priv::shared_lock_t const lock(d->mutex);
 
   (void)lock;
@@ -176,202 +432,1079 @@ ::datum_count() const
   return d->q.size();
 }
 
+size_t
+edge
+::capacity() const
+{
+  return d->capacity;
+}
+
+size_t
+edge
+::capacity_bytes() const
+{
+  return d->capacity_bytes;
+}
+
+size_t
+edge
+::buffered_bytes() const
+{
+  priv::shared_lock_t const lock(d->mutex);
+
+  (void)lock;
+
+  return d->bytes;
+}
+
+edge_statistics
+edge
+::statistics() const
+{
+  edge_statistics stats;
+
+  priv::shared_lock_t const lock(d->mutex);
+
+  (void)lock;
+
+  stats.dropped = d->dropped;
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  priv::counters const& counters = d->stats;
+
+  stats.pushed = priv::read(counters.pushed);
+  stats.grabbed = priv::read(counters.grabbed);
+  stats.high_water_mark = priv::read(counters.high_water_mark);
+  stats.occupancy_sum = priv::read(counters.occupancy_sum);
+  stats.push_blocked_ns = priv::read(counters.push_blocked_ns);
+  stats.grab_blocked_ns = priv::read(counters.grab_blocked_ns);
+#endif
+
+  return stats;
+}
+
+stamp_t
+edge
+::newest_dropped_stamp() const
+{
+  priv::shared_lock_t const lock(d->mutex);
+
+  (void)lock;
+
+  return d->newest_dropped;
+}
+
 void
 edge
 ::push_datum(edge_datum_t const& datum)
 {
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
   {
-    priv::shared_lock_t const lock(d->complete_mutex);
-
-    (void)lock;
-
-    if (d->downstream_complete)
+    if (!d->ring->is_complete())
     {
-      return;
+      d->ring->push(datum);
+      d->record_push(d->ring->count());
     }
+
+    return;
+  }
+#endif
+
+  if (d->can_push_inline(1))
+  {
+    d->count_push(datum);
+    d->q.push_back(datum);
+    d->record_push(d->q.size());
+
+    return;
+  }
+
+  if (!d->accepting_data())
+  {
+    return;
+  }
+
+  if (d->policy != priv::overflow_block)
+  {
+    d->push_or_drop(datum);
+
+    return;
   }
 
   {
     priv::upgrade_lock_t lock(d->mutex);
 
-    while (d->full_of_data())
-    {
-      d->cond_have_space.wait(lock);
-    }
+    d->wait_for_space(lock);
 
     {
       priv::upgrade_to_unique_lock_t const write_lock(lock);
 
       (void)write_lock;
 
+      d->count_push(datum);
       d->q.push_back(datum);
+      d->record_push(d->q.size());
     }
   }
 
   d->cond_have_data.notify_one();
 }
 
-edge_datum_t
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+void
 edge
-::get_datum()
+::push_datum(edge_datum_t&& datum)
 {
-  d->complete_check();
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    if (!d->ring->is_complete())
+    {
+      d->ring->push(std::move(datum));
+      d->record_push(d->ring->count());
+    }
 
-  edge_datum_t dat;
+    return;
+  }
+#endif
 
+  if (d->can_push_inline(1))
   {
-    priv::upgrade_lock_t lock(d->mutex);
+    d->count_push(datum);
+    d->q.push_back(std::move(datum));
+    d->record_push(d->q.size());
 
-    while (!d->has_data())
-    {
-      d->cond_have_data.wait(lock);
-    }
+    return;
+  }
+
+  if (!d->accepting_data())
+  {
+    return;
+  }
+
+  if (d->policy != priv::overflow_block)
+  {
+    d->push_or_drop(datum);
+
+    return;
+  }
+
+  {
+    priv::upgrade_lock_t lock(d->mutex);
 
-    dat = d->q.front();
+    d->wait_for_space(lock);
 
     {
       priv::upgrade_to_unique_lock_t const write_lock(lock);
 
       (void)write_lock;
 
-      d->q.pop_front();
+      d->count_push(datum);
+      d->q.push_back(std::move(datum));
+      d->record_push(d->q.size());
     }
   }
 
-  d->cond_have_space.notify_one();
-
-  return dat;
+  d->cond_have_data.notify_one();
 }
+#endif
 
 edge_datum_t
 edge
-::peek_datum(size_t idx) const
+::get_datum()
 {
-  d->complete_check();
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    edge_datum_t dat = d->ring->get();
 
-  priv::shared_lock_t lock(d->mutex);
+    d->record_grab(1);
 
-  while (d->q.size() <= idx)
-  {
-    d->cond_have_data.wait(lock);
+    return dat;
   }
+#endif
 
-  return d->q.at(idx);
-}
+  edge_datum_t dat;
+
+  if (d->can_grab_inline(1))
+  {
+    d->count_grab(d->q.front());
+    priv::take(dat, d->q.front());
+    d->q.pop_front();
+    d->record_grab(1);
+
+    return dat;
+  }
 
-void
-edge
-::pop_datum()
-{
   d->complete_check();
 
   {
     priv::upgrade_lock_t lock(d->mutex);
 
-    while (!d->has_data())
-    {
-      d->cond_have_data.wait(lock);
-    }
+    d->wait_for_data(lock);
 
     {
       priv::upgrade_to_unique_lock_t const write_lock(lock);
 
       (void)write_lock;
 
+      d->count_grab(d->q.front());
+      priv::take(dat, d->q.front());
       d->q.pop_front();
+      d->record_grab(1);
     }
   }
 
   d->cond_have_space.notify_one();
+
+  return dat;
 }
 
 void
 edge
-::mark_downstream_as_complete()
+::push_data(edge_data_t const& data)
 {
-  priv::unique_lock_t const complete_lock(d->complete_mutex);
-  priv::unique_lock_t const lock(d->mutex);
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    BOOST_FOREACH (edge_datum_t const& datum, data)
+    {
+      if (d->ring->is_complete())
+      {
+        break;
+      }
 
-  (void)complete_lock;
-  (void)lock;
+      d->ring->push(datum);
+      d->record_push(d->ring->count());
+    }
 
-  d->downstream_complete = true;
+    return;
+  }
+#endif
 
-  while (!d->q.empty())
+  if (d->can_push_inline(data.size()))
   {
-    d->q.pop_front();
+    BOOST_FOREACH (edge_datum_t const& datum, data)
+    {
+      d->count_push(datum);
+      d->q.push_back(datum);
+      d->record_push(d->q.size());
+    }
+
+    return;
   }
 
-  d->cond_have_space.notify_one();
-}
+  if (!d->accepting_data())
+  {
+    return;
+  }
 
-bool
-edge
-::is_downstream_complete() const
-{
-  priv::shared_lock_t const lock(d->complete_mutex);
+  if (d->policy != priv::overflow_block)
+  {
+    BOOST_FOREACH (edge_datum_t const& datum, data)
+    {
+      d->push_or_drop(datum);
+    }
 
-  (void)lock;
+    return;
+  }
 
-  return d->downstream_complete;
+  edge_data_t::const_iterator i = data.begin();
+  edge_data_t::const_iterator const end = data.end();
+
+  while (i != end)
+  {
+    {
+      priv::upgrade_lock_t lock(d->mutex);
+
+      d->wait_for_space(lock);
+
+      {
+        priv::upgrade_to_unique_lock_t const write_lock(lock);
+
+        (void)write_lock;
+
+        // Only push what fits; the rest waits for the consumer to make room.
+        while ((i != end) && !d->full_of_data())
+        {
+          d->count_push(*i);
+          d->q.push_back(*i);
+          d->record_push(d->q.size());
+          ++i;
+        }
+      }
+    }
+
+    d->cond_have_data.notify_one();
+  }
 }
 
-void
+bool
 edge
-::set_upstream_process(process_t process)
+::try_push_datum(edge_datum_t const& datum)
 {
-  if (!process)
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
   {
-    throw null_process_connection_exception();
+    if (d->ring->is_complete())
+    {
+      return true;
+    }
+
+    // Only this side adds data, so the ring cannot fill up after the check.
+    if (d->ring->full())
+    {
+      return false;
+    }
+
+    d->ring->push(datum);
+    d->record_push(d->ring->count());
+
+    return true;
   }
+#endif
 
-  if (!d->upstream.expired())
+  if (d->can_push_inline(1))
   {
-    process_t const up = d->upstream.lock();
+    d->count_push(datum);
+    d->q.push_back(datum);
+    d->record_push(d->q.size());
 
-    throw input_already_connected_exception(up->name(), process->name());
+    return true;
   }
 
-  d->upstream = process;
-}
+  if (!d->accepting_data())
+  {
+    return true;
+  }
 
-void
-edge
-::set_downstream_process(process_t process)
-{
-  if (!process)
+  if (d->policy != priv::overflow_block)
   {
-    throw null_process_connection_exception();
+    d->push_or_drop(datum);
+
+    return true;
   }
 
-  if (!d->downstream.expired())
   {
-    process_t const down = d->downstream.lock();
+    priv::unique_lock_t const lock(d->mutex);
 
-    throw output_already_connected_exception(down->name(), process->name());
+    (void)lock;
+
+    if (d->full_of_data())
+    {
+      return false;
+    }
+
+    d->count_push(datum);
+    d->q.push_back(datum);
+    d->record_push(d->q.size());
   }
 
-  d->downstream = process;
+  d->cond_have_data.notify_one();
+
+  return true;
 }
 
-edge::priv
-::priv(bool depends_, size_t capacity_)
-  : depends(depends_)
-  , capacity(capacity_)
+edge_data_t
+edge
+::get_data(size_t count)
+{
+  edge_data_t data;
+
+  data.reserve(count);
+
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      data.push_back(d->ring->get());
+    }
+
+    d->record_grab(count);
+
+    return data;
+  }
+#endif
+
+  if (d->can_grab_inline(count))
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      data.push_back(edge_datum_t());
+      d->count_grab(d->q.front());
+      priv::take(data.back(), d->q.front());
+      d->q.pop_front();
+    }
+
+    d->record_grab(count);
+
+    return data;
+  }
+
+  d->complete_check();
+
+  while (data.size() < count)
+  {
+    {
+      priv::upgrade_lock_t lock(d->mutex);
+
+      d->wait_for_data(lock);
+
+      {
+        priv::upgrade_to_unique_lock_t const write_lock(lock);
+
+        (void)write_lock;
+
+        size_t const before = data.size();
+
+        // Take whatever is available; a bounded edge may not be able to hold
+        // the whole batch at once.
+        while ((data.size() < count) && d->has_data())
+        {
+          data.push_back(edge_datum_t());
+          d->count_grab(d->q.front());
+          priv::take(data.back(), d->q.front());
+          d->q.pop_front();
+        }
+
+        d->record_grab(data.size() - before);
+      }
+    }
+
+    d->cond_have_space.notify_one();
+  }
+
+  return data;
+}
+
+edge_datum_t
+edge
+::peek_datum(size_t idx) const
+{
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    return d->ring->peek(idx);
+  }
+#endif
+
+  if (d->can_grab_inline(idx + 1))
+  {
+    return d->q[idx];
+  }
+
+  d->complete_check();
+
+  priv::shared_lock_t lock(d->mutex);
+
+  d->wait_for_data(lock, idx);
+
+  return d->q.at(idx);
+}
+
+void
+edge
+::peek_range(edge_data_t& data, size_t count) const
+{
+  if (!count)
+  {
+    return;
+  }
+
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      data.push_back(d->ring->peek(i));
+    }
+
+    return;
+  }
+#endif
+
+  if (d->can_grab_inline(count))
+  {
+    data.insert(data.end(), d->q.begin(), d->q.begin() + count);
+
+    return;
+  }
+
+  d->complete_check();
+
+  priv::shared_lock_t lock(d->mutex);
+
+  d->wait_for_data(lock, count - 1);
+
+  data.insert(data.end(), d->q.begin(), d->q.begin() + count);
+}
+
+void
+edge
+::peek_step_data(edge_data_t& data, size_t count) const
+{
+  if (!count)
+  {
+    return;
+  }
+
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    data.push_back(d->ring->peek(0));
+
+    if (priv::ends_group(data.back()))
+    {
+      return;
+    }
+
+    for (size_t i = 1; i < count; ++i)
+    {
+      data.push_back(d->ring->peek(i));
+    }
+
+    return;
+  }
+#endif
+
+  if (d->can_grab_inline(1) && priv::ends_group(d->q.front()))
+  {
+    data.push_back(d->q.front());
+
+    return;
+  }
+
+  if (d->can_grab_inline(count))
+  {
+    data.insert(data.end(), d->q.begin(), d->q.begin() + count);
+
+    return;
+  }
+
+  d->complete_check();
+
+  priv::shared_lock_t lock(d->mutex);
+
+  d->wait_for_data(lock, 0);
+
+  data.push_back(d->q.front());
+
+  if (priv::ends_group(data.back()))
+  {
+    return;
+  }
+
+  d->wait_for_data(lock, count - 1);
+
+  data.insert(data.end(), d->q.begin() + 1, d->q.begin() + count);
+}
+
+bool
+edge
+::try_peek_datum(edge_datum_t& datum, size_t idx) const
+{
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    if (d->ring->is_complete())
+    {
+      throw datum_requested_after_complete();
+    }
+
+    // Only this side removes data, so the datum cannot go away after the check.
+    if (d->ring->count() <= idx)
+    {
+      return false;
+    }
+
+    datum = d->ring->peek(idx);
+
+    return true;
+  }
+#endif
+
+  if (d->can_grab_inline(idx + 1))
+  {
+    datum = d->q[idx];
+
+    return true;
+  }
+
+  d->complete_check();
+
+  priv::shared_lock_t const lock(d->mutex);
+
+  (void)lock;
+
+  if (d->q.size() <= idx)
+  {
+    return false;
+  }
+
+  datum = d->q[idx];
+
+  return true;
+}
+
+void
+edge
+::pop_datum()
+{
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    d->ring->pop();
+    d->record_grab(1);
+
+    return;
+  }
+#endif
+
+  if (d->can_grab_inline(1))
+  {
+    d->count_grab(d->q.front());
+    d->q.pop_front();
+    d->record_grab(1);
+
+    return;
+  }
+
+  d->complete_check();
+
+  {
+    priv::upgrade_lock_t lock(d->mutex);
+
+    d->wait_for_data(lock);
+
+    {
+      priv::upgrade_to_unique_lock_t const write_lock(lock);
+
+      (void)write_lock;
+
+      d->count_grab(d->q.front());
+      d->q.pop_front();
+      d->record_grab(1);
+    }
+  }
+
+  d->cond_have_space.notify_one();
+}
+
+void
+edge
+::mark_downstream_as_complete()
+{
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    d->ring->mark_complete();
+
+    return;
+  }
+#endif
+
+  priv::unique_lock_t const complete_lock(d->complete_mutex);
+  priv::unique_lock_t const lock(d->mutex);
+
+  (void)complete_lock;
+  (void)lock;
+
+  d->downstream_complete = true;
+
+  while (!d->q.empty())
+  {
+    d->q.pop_front();
+  }
+
+  d->count_clear();
+
+  d->cond_have_space.notify_one();
+}
+
+bool
+edge
+::is_downstream_complete() const
+{
+#ifdef HAVE_LOCK_FREE_EDGES
+  if (d->ring)
+  {
+    return d->ring->is_complete();
+  }
+#endif
+
+  priv::shared_lock_t const lock(d->complete_mutex);
+
+  (void)lock;
+
+  return d->downstream_complete;
+}
+
+void
+edge
+::set_upstream_process(process_t process)
+{
+  if (!process)
+  {
+    throw null_process_connection_exception();
+  }
+
+  if (!d->upstream.expired())
+  {
+    process_t const up = d->upstream.lock();
+
+    throw input_already_connected_exception(up->name(), process->name());
+  }
+
+  d->upstream = process;
+}
+
+void
+edge
+::set_downstream_process(process_t process)
+{
+  if (!process)
+  {
+    throw null_process_connection_exception();
+  }
+
+  if (!d->downstream.expired())
+  {
+    process_t const down = d->downstream.lock();
+
+    throw output_already_connected_exception(down->name(), process->name());
+  }
+
+  d->downstream = process;
+}
+
+void
+edge
+::set_inline(bool inline_)
+{
+  priv::unique_lock_t const lock(d->mutex);
+
+  (void)lock;
+
+  d->inline_slot = inline_;
+}
+
+bool
+edge
+::is_inline() const
+{
+  return d->inline_slot;
+}
+
+void
+edge
+::set_memory_budget(memory_budget_t const& budget)
+{
+  if (budget && d->lock_free)
+  {
+    throw lock_free_memory_limit_exception();
+  }
+
+  priv::unique_lock_t const lock(d->mutex);
+
+  (void)lock;
+
+  if (d->budget)
+  {
+    d->budget->release(d->bytes);
+  }
+
+  d->bytes = 0;
+  d->budget = budget;
+  d->counts_bytes = (d->capacity_bytes || d->budget);
+
+  if (d->counts_bytes)
+  {
+    BOOST_FOREACH (edge_datum_t const& edat, d->q)
+    {
+      d->count_push(edat);
+    }
+  }
+}
+
+edge::priv
+::priv(bool depends_, size_t capacity_, size_t capacity_bytes_, bool lock_free_, overflow_policy_t policy_)
+  : depends(depends_)
+  , capacity(capacity_)
+  , capacity_bytes(capacity_bytes_)
+  , lock_free(lock_free_)
+  , policy(policy_)
   , downstream_complete(false)
+  , inline_slot(false)
   , upstream()
   , downstream()
+  , counts_bytes(0 != capacity_bytes)
+  , bytes(0)
+  , budget()
   , q()
   , cond_have_data()
   , cond_have_space()
   , mutex()
   , complete_mutex()
+  , dropped(0)
+  , newest_dropped()
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  , stats()
+#endif
+#ifdef HAVE_LOCK_FREE_EDGES
+  , ring()
+#endif
+{
+#ifdef HAVE_LOCK_FREE_EDGES
+  // An unbounded edge cannot be backed by a ring and only the consumer may
+  // remove data from one.
+  if (lock_free && capacity && (policy == overflow_block))
+  {
+    ring.reset(new ring_buffer(capacity, *this));
+  }
+#endif
+}
+
+edge::priv
+::~priv()
+{
+  count_clear();
+}
+
+edge::priv::overflow_policy_t
+edge::priv
+::overflow_policy(config::value_t const& value)
+{
+  if (value == "block")
+  {
+    return overflow_block;
+  }
+  else if (value == "drop_oldest")
+  {
+    return overflow_drop_oldest;
+  }
+  else if (value == "drop_newest")
+  {
+    return overflow_drop_newest;
+  }
+  else if (value == "keep_latest")
+  {
+    return overflow_keep_latest;
+  }
+
+  throw invalid_overflow_policy_exception(value);
+}
+
+void
+edge::priv
+::push_or_drop(edge_datum_t const& datum)
+{
+  {
+    unique_lock_t const lock(mutex);
+
+    (void)lock;
+
+    if (full_of_data())
+    {
+      switch (policy)
+      {
+        case overflow_drop_newest:
+          if (droppable(datum))
+          {
+            record_drop(datum);
+
+            return;
+          }
+
+          // Make room for the packet which must be delivered.
+          drop_queued(1);
+          break;
+        case overflow_drop_oldest:
+          // Memory limits may need more than one datum to be dropped.
+          while (full_of_data() && drop_queued(1))
+          {
+          }
+          break;
+        case overflow_keep_latest:
+          drop_queued(q.size());
+          break;
+        case overflow_block:
+        default:
+          break;
+      }
+    }
+
+    // If nothing could be dropped, the edge goes over capacity rather than
+    // losing a control packet.
+    count_push(datum);
+    q.push_back(datum);
+
+    record_push(q.size());
+  }
+
+  cond_have_data.notify_one();
+}
+
+size_t
+edge::priv
+::drop_queued(size_t count)
+{
+  edge_queue_t::iterator i = q.begin();
+  size_t dropped_now = 0;
+
+  while ((i != q.end()) && (dropped_now < count))
+  {
+    if (droppable(*i))
+    {
+      count_grab(*i);
+      record_drop(*i);
+      i = q.erase(i);
+      ++dropped_now;
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  return dropped_now;
+}
+
+void
+edge::priv
+::record_drop(edge_datum_t const& edat)
+{
+  ++dropped;
+
+  stamp_t const& st = edat.stamp;
+
+  if (!newest_dropped || (*newest_dropped < *st))
+  {
+    newest_dropped = st;
+  }
+}
+
+bool
+edge::priv
+::over_memory_limit() const
+{
+  // An empty edge always has room so that a datum larger than the limits can
+  // still get through.
+  if (!counts_bytes || q.empty())
+  {
+    return false;
+  }
+
+  if (capacity_bytes && (capacity_bytes <= bytes))
+  {
+    return true;
+  }
+
+  return (budget && budget->exhausted());
+}
+
+bool
+edge::priv
+::droppable(edge_datum_t const& edat)
+{
+  datum::type_t const type = edat.datum->type();
+
+  return ((type == datum::data) ||
+          (type == datum::empty));
+}
+
+void
+edge::priv
+::count_push(edge_datum_t const& edat)
+{
+  if (!counts_bytes)
+  {
+    return;
+  }
+
+  size_t const size = size_of(edat);
+
+  bytes += size;
+
+  if (budget)
+  {
+    budget->acquire(size);
+  }
+}
+
+void
+edge::priv
+::count_grab(edge_datum_t const& edat)
+{
+  if (!counts_bytes)
+  {
+    return;
+  }
+
+  size_t const size = size_of(edat);
+
+  bytes -= size;
+
+  if (budget)
+  {
+    budget->release(size);
+  }
+}
+
+void
+edge::priv
+::count_clear()
+{
+  if (budget)
+  {
+    budget->release(bytes);
+  }
+
+  bytes = 0;
+}
+
+size_t
+edge::priv
+::size_of(edge_datum_t const& edat)
+{
+  if (!edat.datum)
+  {
+    return 0;
+  }
+
+  return edat.datum->size();
+}
+
+bool
+edge::priv
+::accepting_data() const
 {
+  shared_lock_t const lock(complete_mutex);
+
+  (void)lock;
+
+  return !downstream_complete;
 }
 
+void
 edge::priv
-::~priv()
+::take(edge_datum_t& dest, edge_datum_t& src)
+{
+  // Swapping hands over the references without touching the (atomic)
+  // reference counts.
+  dest.datum.swap(src.datum);
+  dest.stamp.swap(src.stamp);
+}
+
+bool
+edge::priv
+::ends_group(edge_datum_t const& edat)
 {
+  datum::type_t const type = edat.datum->type();
+
+  return ((type == datum::flush) ||
+          (type == datum::complete));
 }
 
 bool
@@ -385,12 +1518,208 @@ bool
 edge::priv
 ::full_of_data() const
 {
-  if (!capacity)
+  if (capacity && (capacity <= q.size()))
+  {
+    return true;
+  }
+
+  return over_memory_limit();
+}
+
+bool
+edge::priv
+::has_space_for(size_t count) const
+{
+  if (!count)
+  {
+    return true;
+  }
+
+  if (capacity && (capacity < (q.size() + count)))
+  {
+    return false;
+  }
+
+  if (counts_bytes && (1 < count))
+  {
+    return false;
+  }
+
+  return !over_memory_limit();
+}
+
+template <typename Lock>
+void
+edge::priv
+::wait_for_space(Lock& lock)
+{
+  if (!full_of_data())
+  {
+    return;
+  }
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  statistic_t const start = wall_clock_ns();
+#endif
+
+  while (full_of_data())
+  {
+    cond_have_space.wait(lock);
+  }
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  record_push_blocked(wall_clock_ns() - start);
+#endif
+}
+
+template <typename Lock>
+void
+edge::priv
+::wait_for_data(Lock& lock, size_t idx)
+{
+  if (idx < q.size())
+  {
+    return;
+  }
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  statistic_t const start = wall_clock_ns();
+#endif
+
+  while (q.size() <= idx)
+  {
+    cond_have_data.wait(lock);
+  }
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  record_grab_blocked(wall_clock_ns() - start);
+#endif
+}
+
+void
+edge::priv
+::record_push(size_t depth)
+{
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  bump(stats.pushed, 1);
+  bump(stats.occupancy_sum, depth);
+
+  if (read(stats.high_water_mark) < depth)
+  {
+    bump(stats.high_water_mark, depth - read(stats.high_water_mark));
+  }
+#else
+  (void)depth;
+#endif
+}
+
+void
+edge::priv
+::record_grab(size_t count)
+{
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  bump(stats.grabbed, count);
+#else
+  (void)count;
+#endif
+}
+
+void
+edge::priv
+::record_push_blocked(statistic_t ns)
+{
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  bump(stats.push_blocked_ns, ns);
+#else
+  (void)ns;
+#endif
+}
+
+void
+edge::priv
+::record_grab_blocked(statistic_t ns)
+{
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  bump(stats.grab_blocked_ns, ns);
+#else
+  (void)ns;
+#endif
+}
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+void
+edge::priv
+::bump(counter_t& counter, statistic_t amount)
+{
+  // Each counter only has one writer at a time, so a full read-modify-write
+  // is not needed.
+#ifdef HAVE_LOCK_FREE_EDGES
+  counter.store(counter.load(boost::memory_order_relaxed) + amount, boost::memory_order_relaxed);
+#else
+  counter += amount;
+#endif
+}
+
+statistic_t
+edge::priv
+::read(counter_t const& counter)
+{
+#ifdef HAVE_LOCK_FREE_EDGES
+  return counter.load(boost::memory_order_relaxed);
+#else
+  return counter;
+#endif
+}
+
+edge::priv::counters
+::counters()
+  : pushed(0)
+  , high_water_mark(0)
+  , occupancy_sum(0)
+  , push_blocked_ns(0)
+  , grabbed(0)
+  , grab_blocked_ns(0)
+{
+}
+
+edge::priv::counters
+::~counters()
+{
+}
+#endif
+
+bool
+edge::priv
+::can_push_inline(size_t count) const
+{
+  // Completion is left to the synchronized path so that the data is dropped
+  // the same way.
+  if (!inline_slot || downstream_complete)
+  {
+    return false;
+  }
+
+  // Memory limits are only known to be met one datum at a time.
+  if (counts_bytes)
+  {
+    return ((count == 1) && !full_of_data());
+  }
+
+  return (!capacity || ((q.size() + count) <= capacity));
+}
+
+bool
+edge::priv
+::can_grab_inline(size_t count) const
+{
+  // Completion is left to the synchronized path so that the error is thrown
+  // the same way.
+  if (!inline_slot || downstream_complete)
   {
     return false;
   }
 
-  return (q.size() == capacity);
+  return (count <= q.size());
 }
 
 void
@@ -407,4 +1736,286 @@ ::complete_check() const
   }
 }
 
+#ifdef HAVE_LOCK_FREE_EDGES
+edge::priv::ring_buffer
+::ring_buffer(size_t capacity_, priv& owner_)
+  : capacity(capacity_)
+  , slots(capacity_)
+  , owner(owner_)
+  , head()
+  , tail()
+  , complete(false)
+  , consumer_waiting(false)
+  , producer_waiting(false)
+  , wait_mutex()
+  , cond_have_data()
+  , cond_have_space()
+{
+}
+
+edge::priv::ring_buffer
+::~ring_buffer()
+{
+}
+
+size_t
+edge::priv::ring_buffer
+::count() const
+{
+  // Read the head first; the tail can only move away from it.
+  size_t const head_idx = head.value.load(boost::memory_order_acquire);
+  size_t const tail_idx = tail.value.load(boost::memory_order_acquire);
+
+  return (tail_idx - head_idx);
+}
+
+bool
+edge::priv::ring_buffer
+::full() const
+{
+  return (count() == capacity);
+}
+
+void
+edge::priv::ring_buffer
+::push(edge_datum_t const& datum)
+{
+  size_t const tail_idx = claim_slot();
+
+  slots[tail_idx % capacity] = datum;
+
+  publish_slot(tail_idx);
+}
+
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+void
+edge::priv::ring_buffer
+::push(edge_datum_t&& datum)
+{
+  size_t const tail_idx = claim_slot();
+
+  slots[tail_idx % capacity] = std::move(datum);
+
+  publish_slot(tail_idx);
+}
+#endif
+
+edge_datum_t
+edge::priv::ring_buffer
+::peek(size_t idx) const
+{
+  wait_for_data(idx);
+
+  size_t const head_idx = head.value.load(boost::memory_order_relaxed);
+
+  return slots[(head_idx + idx) % capacity];
+}
+
+edge_datum_t
+edge::priv::ring_buffer
+::get()
+{
+  wait_for_data(0);
+
+  size_t const head_idx = head.value.load(boost::memory_order_relaxed);
+  edge_datum_t& slot = slots[head_idx % capacity];
+
+  // This also leaves the slot empty so the ring does not keep references.
+  edge_datum_t dat;
+
+  priv::take(dat, slot);
+
+  head.value.store(head_idx + 1, boost::memory_order_release);
+
+  notify_producer();
+
+  return dat;
+}
+
+void
+edge::priv::ring_buffer
+::pop()
+{
+  wait_for_data(0);
+
+  size_t const head_idx = head.value.load(boost::memory_order_relaxed);
+
+  slots[head_idx % capacity] = edge_datum_t();
+
+  head.value.store(head_idx + 1, boost::memory_order_release);
+
+  notify_producer();
+}
+
+void
+edge::priv::ring_buffer
+::clear()
+{
+  size_t head_idx = head.value.load(boost::memory_order_relaxed);
+  size_t const tail_idx = tail.value.load(boost::memory_order_acquire);
+
+  while (head_idx != tail_idx)
+  {
+    slots[head_idx % capacity] = edge_datum_t();
+
+    ++head_idx;
+  }
+
+  head.value.store(head_idx, boost::memory_order_release);
+
+  notify_producer();
+}
+
+bool
+edge::priv::ring_buffer
+::is_complete() const
+{
+  return complete.load(boost::memory_order_acquire);
+}
+
+void
+edge::priv::ring_buffer
+::mark_complete()
+{
+  complete.store(true, boost::memory_order_release);
+
+  clear();
+}
+
+size_t
+edge::priv::ring_buffer
+::claim_slot()
+{
+  size_t const tail_idx = tail.value.load(boost::memory_order_relaxed);
+
+  if ((tail_idx - head.value.load(boost::memory_order_acquire)) == capacity)
+  {
+    wait_for_space(tail_idx);
+  }
+
+  return tail_idx;
+}
+
+void
+edge::priv::ring_buffer
+::publish_slot(size_t tail_idx)
+{
+  tail.value.store(tail_idx + 1, boost::memory_order_release);
+
+  notify_consumer();
+}
+
+void
+edge::priv::ring_buffer
+::wait_for_data(size_t idx) const
+{
+  if (is_complete())
+  {
+    throw datum_requested_after_complete();
+  }
+
+  if (idx < count())
+  {
+    return;
+  }
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  statistic_t const start = wall_clock_ns();
+#endif
+
+  boost::mutex::scoped_lock lock(wait_mutex);
+
+  consumer_waiting.store(true, boost::memory_order_relaxed);
+
+  // Pairs with the fence in notify_consumer so that either the producer sees
+  // that we are waiting or we see its new tail.
+  boost::atomic_thread_fence(boost::memory_order_seq_cst);
+
+  while (count() <= idx)
+  {
+    cond_have_data.wait(lock);
+  }
+
+  consumer_waiting.store(false, boost::memory_order_relaxed);
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  owner.record_grab_blocked(wall_clock_ns() - start);
+#endif
+}
+
+void
+edge::priv::ring_buffer
+::wait_for_space(size_t tail_idx)
+{
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  statistic_t const start = wall_clock_ns();
+#endif
+
+  boost::mutex::scoped_lock lock(wait_mutex);
+
+  producer_waiting.store(true, boost::memory_order_relaxed);
+
+  // Pairs with the fence in notify_producer.
+  boost::atomic_thread_fence(boost::memory_order_seq_cst);
+
+  while ((tail_idx - head.value.load(boost::memory_order_acquire)) == capacity)
+  {
+    cond_have_space.wait(lock);
+  }
+
+  producer_waiting.store(false, boost::memory_order_relaxed);
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  owner.record_push_blocked(wall_clock_ns() - start);
+#endif
+}
+
+void
+edge::priv::ring_buffer
+::notify_consumer() const
+{
+  boost::atomic_thread_fence(boost::memory_order_seq_cst);
+
+  if (!consumer_waiting.load(boost::memory_order_relaxed))
+  {
+    return;
+  }
+
+  boost::mutex::scoped_lock const lock(wait_mutex);
+
+  (void)lock;
+
+  cond_have_data.notify_one();
+}
+
+void
+edge::priv::ring_buffer
+::notify_producer()
+{
+  boost::atomic_thread_fence(boost::memory_order_seq_cst);
+
+  if (!producer_waiting.load(boost::memory_order_relaxed))
+  {
+    return;
+  }
+
+  boost::mutex::scoped_lock const lock(wait_mutex);
+
+  (void)lock;
+
+  cond_have_space.notify_one();
+}
+
+edge::priv::ring_buffer::padded_index
+::padded_index()
+  : value(0)
+{
+}
+
+edge::priv::ring_buffer::padded_index
+::~padded_index()
+{
+}
+#endif
+
 }
@@ -34,6 +34,7 @@
 #include "pipeline-config.h"
 
 #include "config.h"
+#include "statistics.h"
 #include "types.h"
 
 #include <boost/noncopyable.hpp>
@@ -71,6 +72,23 @@ class SPROKIT_PIPELINE_EXPORT edge_datum_t
      * \param stamp_ The stamp for the datum.
      */
     edge_datum_t(datum_t const& datum_, stamp_t const& stamp_);
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+    /**
+     * \brief Constructor which takes ownership of its arguments.
+     *
+     * \param datum_ The datum on the edge.
+     * \param stamp_ The stamp for the datum.
+     */
+    edge_datum_t(datum_t&& datum_, stamp_t&& stamp_);
+    /// Copy constructor.
+    edge_datum_t(edge_datum_t const&) = default;
+    /// Move constructor.
+    edge_datum_t(edge_datum_t&&) = default;
+    /// Copy assignment.
+    edge_datum_t& operator = (edge_datum_t const&) = default;
+    /// Move assignment.
+    edge_datum_t& operator = (edge_datum_t&&) = default;
+#endif
     /**
      * \brief Destructor.
      */
@@ -100,6 +118,47 @@ typedef std::vector<edge_t> edges_t;
  *
  * \brief A connection between two \ref process ports which can carry data.
  *
+ * \configs
+ *
+ * \config{capacity} The maximum number of data packets in the edge. A setting of \c 0 means unbounded.
+ * \config{capacity_bytes} The amount of memory the data in the edge may hold. A setting of \c 0 means unbounded.
+ * \config{lock_free} Whether a bounded edge should use a lock-free single-producer, single-consumer ring buffer.
+ * \config{overflow_policy} What to do when pushing into a full edge: \c block
+ *                          (the default), \c drop_oldest, \c drop_newest, or
+ *                          \c keep_latest.
+ *
+ * When \key{lock_free} is used, only one thread may push into the edge and
+ * only one thread may pull from it at a time. Threads only block when the ring
+ * is empty or full. Data moved through the ring cannot be counted, so
+ * \key{lock_free} may not be combined with \key{capacity_bytes} or a
+ * \link edge::set_memory_budget memory budget\endlink.
+ *
+ * With a dropping \key{overflow_policy}, pushing never waits for space.
+ * \c drop_oldest discards the oldest queued datum, \c drop_newest discards
+ * the datum being pushed, and \c keep_latest discards everything queued so
+ * that only the newest datum is kept. Only data and empty packets are ever
+ * discarded; flush, complete, and error packets are always delivered, even if
+ * the edge has to go over its capacity to do so. Discarded packets are
+ * removed, so the capacity still bounds the length of the queue. The edge
+ * remembers the \link edge::newest_dropped_stamp newest stamp\endlink it
+ * discarded so that a downstream process can tell the gap apart from a
+ * synchronization error and step through the missing stamps with empty data.
+ * Discarded data is counted in the \ref edge_statistics::dropped "statistics"
+ * of the edge. Such edges are never \ref full_of_data and are not backed by a
+ * lock-free ring.
+ *
+ * With \key{capacity_bytes}, the edge counts the \link datum::size size\endlink
+ * of the data it holds and is full once it holds at least that much. An edge
+ * may also share a \link edge::set_memory_budget memory budget\endlink with
+ * other edges; it is then full whenever it holds data and the budget is
+ * exhausted. Either way, an empty edge always accepts a datum so that a
+ * single large datum cannot stall the pipeline.
+ *
+ * An edge may also be made \link edge::set_inline inline\endlink by a
+ * scheduler which runs both of its processes in the same thread. Data is then
+ * moved without taking locks or notifying waiters whenever it can be done
+ * without waiting.
+ *
  * \ingroup base_classes
  */
 class SPROKIT_PIPELINE_EXPORT edge
@@ -115,6 +174,10 @@ class SPROKIT_PIPELINE_EXPORT edge
      *
      * \endpreconds
      *
+     * \throws null_edge_config_exception Thrown when \p config is \c NULL.
+     * \throws invalid_overflow_policy_exception Thrown when the overflow policy is not known.
+     * \throws lock_free_memory_limit_exception Thrown when a lock-free edge is given a memory capacity.
+     *
      * \param config Contains configuration for the edge.
      */
     edge(config_t const& config = config::empty_config());
@@ -139,15 +202,64 @@ class SPROKIT_PIPELINE_EXPORT edge
     /**
      * \brief Query whether the edge can accept more data or not.
      *
+     * Edges which drop data when they overflow always accept more data.
+     *
      * \returns True if the edge can hold no more data, false otherwise.
      */
     bool full_of_data() const;
+    /**
+     * \brief Query whether the edge can accept several more data without blocking.
+     *
+     * The size of data which has not been pushed yet is unknown, so an edge
+     * with memory limits only promises room for a single datum.
+     *
+     * \param count The number of data which would be pushed.
+     *
+     * \returns True if \p count more data could be pushed without blocking, false otherwise.
+     */
+    bool has_space_for(size_t count) const;
     /**
      * \brief Query how many results are in the edge.
      *
      * \returns The number of data items the edge holds.
      */
     size_t datum_count() const;
+    /**
+     * \brief Query the maximum number of results the edge may hold.
+     *
+     * \returns The capacity of the edge, or \c 0 if it is unbounded.
+     */
+    size_t capacity() const;
+    /**
+     * \brief Query the maximum amount of memory the edge may hold.
+     *
+     * \returns The memory capacity of the edge in bytes, or \c 0 if it is unbounded.
+     */
+    size_t capacity_bytes() const;
+    /**
+     * \brief Query how much memory is held by the data in the edge.
+     *
+     * \returns The number of bytes held, or \c 0 if the edge does not count memory.
+     */
+    size_t buffered_bytes() const;
+    /**
+     * \brief Statistics about the data which has moved through the edge.
+     *
+     * The \ref edge_statistics::dropped "dropped" count is always kept; the
+     * rest require instrumentation to be enabled.
+     *
+     * \returns A snapshot of the statistics for the edge.
+     */
+    edge_statistics statistics() const;
+    /**
+     * \brief The stamp of the newest datum discarded by the overflow policy.
+     *
+     * Data between the last datum taken from the edge and the one at its
+     * front which is older than this stamp was discarded.
+     *
+     * \returns The newest discarded stamp, or \c NULL if nothing was discarded.
+     */
+    stamp_t newest_dropped_stamp() const;
 
     /**
      * \brief Push a datum into the edge.
@@ -165,6 +277,45 @@ class SPROKIT_PIPELINE_EXPORT edge
      * \param datum The datum to put into the edge.
      */
     void push_datum(edge_datum_t const& datum);
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+    /**
+     * \brief Move a datum into the edge.
+     *
+     * \note This call blocks if \c full_of_data is \c true.
+     *
+     * \param datum The datum to put into the edge.
+     */
+    void push_datum(edge_datum_t&& datum);
+#endif
+    /**
+     * \brief Push multiple data into the edge.
+     *
+     * The edge is locked and waiting threads are notified once for the whole
+     * batch rather than once per datum as long as there is room for all of
+     * the data.
+     *
+     * \note This call blocks while \c full_of_data is \c true.
+     *
+     * \postconds
+     *
+     * \postcond{The edge has <code>data.size()</code> more datum packets in it.}
+     *
+     * \endpostconds
+     *
+     * \param data The data to put into the edge, in order.
+     */
+    void push_data(edge_data_t const& data);
+    /**
+     * \brief Push a datum into the edge if there is room for it.
+     *
+     * This never blocks. As with \ref push_datum, data pushed after the
+     * downstream is complete is dropped and counts as pushed.
+     *
+     * \param datum The datum to put into the edge.
+     *
+     * \returns True if the datum was accepted, false if the edge is full.
+     */
+    bool try_push_datum(edge_datum_t const& datum);
     /**
      * \brief Extract a datum from the edge.
      *
@@ -189,6 +340,35 @@ class SPROKIT_PIPELINE_EXPORT edge
      * \returns The next datum available from the edge.
      */
     edge_datum_t get_datum();
+    /**
+     * \brief Extract multiple data from the edge.
+     *
+     * The edge is locked and waiting threads are notified once for the whole
+     * batch rather than once per datum as long as all of the data is already
+     * available.
+     *
+     * \note This call blocks until \p count data have been extracted.
+     *
+     * \throws datum_requested_after_complete Thrown if called after \ref mark_downstream_as_complete.
+     *
+     * \preconds
+     *
+     * \precond{<code>this->is_downstream_complete() == false</code>}
+     *
+     * \endpreconds
+     *
+     * \postconds
+     *
+     * \postcond{The edge has \p count fewer datum packets in it.}
+     * \postcond{The caller takes ownership of the returned datum packets.}
+     *
+     * \endpostconds
+     *
+     * \param count The number of data to extract.
+     *
+     * \returns The next \p count data from the edge, in order.
+     */
+    edge_data_t get_data(size_t count);
     /**
      * \brief Look at the next datum in the edge.
      *
@@ -214,6 +394,49 @@ class SPROKIT_PIPELINE_EXPORT edge
      * \returns The next datum available from the edge.
      */
     edge_datum_t peek_datum(size_t idx = 0) const;
+    /**
+     * \brief Look at the first few data in the edge at once.
+     *
+     * This is equivalent to calling \ref peek_datum for each index, but the
+     * edge is only locked once.
+     *
+     * \note This call blocks until the edge holds \p count data.
+     *
+     * \throws datum_requested_after_complete Thrown if called after \ref mark_downstream_as_complete.
+     *
+     * \param data Where to append the data.
+     * \param count The number of data to look at.
+     */
+    void peek_range(edge_data_t& data, size_t count) const;
+    /**
+     * \brief Look at the data a step would use from the edge at once.
+     *
+     * This is \ref peek_range except that a flush or completion packet at the
+     * front of the edge is looked at on its own since the step handles it
+     * without the rest of the group. The edge is only locked once.
+     *
+     * \note This call blocks until the edge holds \p count data unless the
+     * first is a flush or completion packet.
+     *
+     * \throws datum_requested_after_complete Thrown if called after \ref mark_downstream_as_complete.
+     *
+     * \param data Where to append the data.
+     * \param count The number of data a step uses.
+     */
+    void peek_step_data(edge_data_t& data, size_t count) const;
+    /**
+     * \brief Look at a datum in the edge if it is available.
+     *
+     * This never blocks.
+     *
+     * \throws datum_requested_after_complete Thrown if called after \ref mark_downstream_as_complete.
+     *
+     * \param datum Where to store the datum.
+     * \param idx The element in the queue to look at.
+     *
+     * \returns True if \p datum was set, false if the edge holds \p idx or fewer data.
+     */
+    bool try_peek_datum(edge_datum_t& datum, size_t idx = 0) const;
     /**
      * \brief Remove a datum from the edge.
      *
@@ -285,10 +508,53 @@ class SPROKIT_PIPELINE_EXPORT edge
      */
     void set_downstream_process(process_t process);
 
+    /**
+     * \brief Move data without synchronization.
+     *
+     * This is meant for schedulers which step the upstream and downstream
+     * processes from the same thread. Pushes and grabs which would not need to
+     * wait skip the locks and notifications; those which would wait behave as
+     * usual. Queries such as \ref datum_count are only reliable from other
+     * threads while execution is paused. Edges using \key{lock_free} are not
+     * affected.
+     *
+     * \warning Only change this while neither process is being stepped.
+     *
+     * \param inline_ Whether both ends of the edge run in the same thread.
+     */
+    void set_inline(bool inline_);
+    /**
+     * \brief Query whether the edge moves data without synchronization.
+     *
+     * \returns True if the edge is inline, false otherwise.
+     */
+    bool is_inline() const;
+
+    /**
+     * \brief Count the memory held by the edge against a shared budget.
+     *
+     * Edges holding data are full while \p budget is exhausted. Waiting
+     * pushes are woken when the consumer of the edge takes data, not when
+     * other edges release memory.
+     *
+     * \warning Only change this before data is pushed into the edge.
+     *
+     * \throws lock_free_memory_limit_exception Thrown when the edge uses \key{lock_free}.
+     *
+     * \param budget The budget to use, or \c NULL to stop using one.
+     */
+    void set_memory_budget(memory_budget_t const& budget);
+
     /// Configuration that indicates the edge implies an execution dependency between upstream and downstream.
     static config::key_t const config_dependency;
     /// Configuration for the maximum capacity of an edge.
     static config::key_t const config_capacity;
+    /// Configuration for the maximum memory held by an edge.
+    static config::key_t const config_capacity_bytes;
+    /// Configuration for using a lock-free ring buffer for a bounded edge.
+    static config::key_t const config_lock_free;
+    /// Configuration for what happens when data is pushed into a full edge.
+    static config::key_t const config_overflow_policy;
   private:
     class SPROKIT_PIPELINE_NO_EXPORT priv;
     boost::scoped_ptr<priv> d;
@@ -68,6 +68,42 @@ null_edge_config_exception
 {
 }
 
+invalid_overflow_policy_exception
+::invalid_overflow_policy_exception(std::string const& policy) SPROKIT_NOTHROW
+  : edge_exception()
+  , m_policy(policy)
+{
+  std::ostringstream sstr;
+
+  sstr << "The overflow policy \'" << m_policy << "\' "
+          "is not known to edges";
+
+  m_what = sstr.str();
+}
+
+invalid_overflow_policy_exception
+::~invalid_overflow_policy_exception() SPROKIT_NOTHROW
+{
+}
+
+lock_free_memory_limit_exception
+::lock_free_memory_limit_exception() SPROKIT_NOTHROW
+  : edge_exception()
+{
+  std::ostringstream sstr;
+
+  sstr << "A lock-free edge cannot count the memory "
+          "it holds, so it may not be given a memory "
+          "capacity or budget";
+
+  m_what = sstr.str();
+}
+
+lock_free_memory_limit_exception
+::~lock_free_memory_limit_exception() SPROKIT_NOTHROW
+{
+}
+
 datum_requested_after_complete
 ::datum_requested_after_complete() SPROKIT_NOTHROW
   : edge_exception()
@@ -89,6 +89,53 @@ class SPROKIT_PIPELINE_EXPORT null_edge_config_exception
     ~null_edge_config_exception() throw();
 };
 
+/**
+ * \class invalid_overflow_policy_exception edge_exception.h <sprokit/pipeline/edge_exception.h>
+ *
+ * \brief Thrown when an unknown overflow policy is given to an edge.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT invalid_overflow_policy_exception
+  : public edge_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param policy The requested policy.
+     */
+    invalid_overflow_policy_exception(std::string const& policy) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~invalid_overflow_policy_exception() throw();
+
+    /// The requested policy.
+    std::string const m_policy;
+};
+
+/**
+ * \class lock_free_memory_limit_exception edge_exception.h <sprokit/pipeline/edge_exception.h>
+ *
+ * \brief Thrown when a lock-free edge is given a memory capacity or budget.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT lock_free_memory_limit_exception
+  : public edge_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     */
+    lock_free_memory_limit_exception() throw();
+    /**
+     * \brief Destructor.
+     */
+    ~lock_free_memory_limit_exception() throw();
+};
+
 /**
  * \class datum_requested_after_complete pipeline_exception.h <sprokit/pipeline/pipeline_exception.h>
  *
@@ -0,0 +1,88 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_INSTRUMENTATION_H
+#define SPROKIT_PIPELINE_INSTRUMENTATION_H
+
+#include "pipeline-config.h"
+
+#include "statistics.h"
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+#include <boost/chrono/chrono.hpp>
+#include <boost/chrono/thread_clock.hpp>
+#endif
+
+/**
+ * \file instrumentation.h
+ *
+ * \brief Clocks used to collect runtime statistics.
+ */
+
+namespace sprokit
+{
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+/**
+ * \brief The current time on a monotonic clock.
+ *
+ * \returns The time in nanoseconds since an unspecified epoch.
+ */
+inline
+statistic_t
+wall_clock_ns()
+{
+  boost::chrono::steady_clock::duration const now = boost::chrono::steady_clock::now().time_since_epoch();
+
+  return statistic_t(boost::chrono::duration_cast<boost::chrono::nanoseconds>(now).count());
+}
+
+/**
+ * \brief The CPU time used by the calling thread.
+ *
+ * \returns The CPU time in nanoseconds, or \c 0 if it is not available.
+ */
+inline
+statistic_t
+thread_cpu_ns()
+{
+#ifdef BOOST_CHRONO_HAS_THREAD_CLOCK
+  boost::chrono::thread_clock::duration const now = boost::chrono::thread_clock::now().time_since_epoch();
+
+  return statistic_t(boost::chrono::duration_cast<boost::chrono::nanoseconds>(now).count());
+#else
+  return 0;
+#endif
+}
+#endif
+
+}
+
+#endif // SPROKIT_PIPELINE_INSTRUMENTATION_H
@@ -0,0 +1,155 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "memory_budget.h"
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/version.hpp>
+
+// XXX(boost): 1.53.0
+#if BOOST_VERSION >= 105300
+#define HAVE_ATOMIC_BUDGET
+#include <boost/atomic.hpp>
+#endif
+
+/**
+ * \file memory_budget.cxx
+ *
+ * \brief Implementation of a \link sprokit::memory_budget memory budget\endlink.
+ */
+
+namespace sprokit
+{
+
+class memory_budget::priv
+{
+  public:
+    priv(size_t limit_);
+    ~priv();
+
+    size_t const limit;
+
+    // Every push and grab on a budgeted edge touches the count, so avoid a
+    // lock when possible.
+#ifdef HAVE_ATOMIC_BUDGET
+    boost::atomic<size_t> used;
+#else
+    size_t used;
+    mutable boost::mutex mut;
+#endif
+};
+
+memory_budget
+::memory_budget(size_t limit)
+  : d(new priv(limit))
+{
+}
+
+memory_budget
+::~memory_budget()
+{
+}
+
+size_t
+memory_budget
+::limit() const
+{
+  return d->limit;
+}
+
+size_t
+memory_budget
+::used() const
+{
+#ifdef HAVE_ATOMIC_BUDGET
+  return d->used.load(boost::memory_order_relaxed);
+#else
+  boost::mutex::scoped_lock const lock(d->mut);
+
+  (void)lock;
+
+  return d->used;
+#endif
+}
+
+bool
+memory_budget
+::exhausted() const
+{
+  return (d->limit <= used());
+}
+
+void
+memory_budget
+::acquire(size_t bytes)
+{
+#ifdef HAVE_ATOMIC_BUDGET
+  d->used.fetch_add(bytes, boost::memory_order_relaxed);
+#else
+  boost::mutex::scoped_lock const lock(d->mut);
+
+  (void)lock;
+
+  d->used += bytes;
+#endif
+}
+
+void
+memory_budget
+::release(size_t bytes)
+{
+#ifdef HAVE_ATOMIC_BUDGET
+  d->used.fetch_sub(bytes, boost::memory_order_relaxed);
+#else
+  boost::mutex::scoped_lock const lock(d->mut);
+
+  (void)lock;
+
+  d->used -= bytes;
+#endif
+}
+
+memory_budget::priv
+::priv(size_t limit_)
+  : limit(limit_)
+  , used(0)
+#ifndef HAVE_ATOMIC_BUDGET
+  , mut()
+#endif
+{
+}
+
+memory_budget::priv
+::~priv()
+{
+}
+
+}
@@ -0,0 +1,117 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_MEMORY_BUDGET_H
+#define SPROKIT_PIPELINE_MEMORY_BUDGET_H
+
+#include "pipeline-config.h"
+
+#include "types.h"
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <cstddef>
+
+/**
+ * \file memory_budget.h
+ *
+ * \brief Header for a \link sprokit::memory_budget memory budget\endlink shared between edges.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class memory_budget memory_budget.h <sprokit/pipeline/memory_budget.h>
+ *
+ * \brief A limit on the memory held by a group of \link edge edges\endlink.
+ *
+ * Edges using a budget count the \link datum::size size\endlink of the data
+ * they hold against it. Once the budget is exhausted, edges which already
+ * hold data are \link edge::full_of_data full\endlink until their consumer
+ * takes some of it, so that buffers stop growing behind slow processes.
+ *
+ * \ingroup base_classes
+ */
+class SPROKIT_PIPELINE_EXPORT memory_budget
+  : boost::noncopyable
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param limit The number of bytes which may be held before the budget is exhausted.
+     */
+    explicit memory_budget(size_t limit);
+    /**
+     * \brief Destructor.
+     */
+    ~memory_budget();
+
+    /**
+     * \brief Query the limit of the budget.
+     *
+     * \returns The number of bytes which may be held.
+     */
+    size_t limit() const;
+    /**
+     * \brief Query how much of the budget is in use.
+     *
+     * \returns The number of bytes currently held.
+     */
+    size_t used() const;
+    /**
+     * \brief Query whether the budget has been used up.
+     *
+     * \returns True if at least \ref limit bytes are held, false otherwise.
+     */
+    bool exhausted() const;
+
+    /**
+     * \brief Count memory against the budget.
+     *
+     * \param bytes The number of bytes now held.
+     */
+    void acquire(size_t bytes);
+    /**
+     * \brief Return memory to the budget.
+     *
+     * \param bytes The number of bytes no longer held.
+     */
+    void release(size_t bytes);
+  private:
+    class SPROKIT_PIPELINE_NO_EXPORT priv;
+    boost::scoped_ptr<priv> d;
+};
+
+}
+
+#endif // SPROKIT_PIPELINE_MEMORY_BUDGET_H
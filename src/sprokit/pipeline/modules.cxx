@@ -33,18 +33,31 @@
 #if defined(_WIN32) || defined(_WIN64)
 #include <sprokit/pipeline/module-paths.h>
 #endif
+#include "process_registry.h"
+#include "scheduler_registry.h"
 #include "utils.h"
 
 #include <sprokit/pipeline_util/path.h>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include <ctime>
+
 #if defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
 #else
@@ -77,18 +90,64 @@ typedef path_t::string_type module_path_t;
 typedef std::vector<module_path_t> module_paths_t;
 typedef std::string lib_suffix_t;
 typedef std::string function_name_t;
+typedef std::time_t module_mtime_t;
+
+class module_manifest
+{
+  public:
+    module_manifest();
+    ~module_manifest();
+
+    bool read(std::istream& istr);
+    void write(std::ostream& ostr) const;
+
+    process::types_t processes;
+    scheduler_registry::types_t schedulers;
+};
+
+class module_cache
+{
+  public:
+    module_cache(path_t const& path_);
+    ~module_cache();
+
+    bool lookup(module_path_t const& module, module_mtime_t mtime, module_manifest& manifest) const;
+    void update(module_path_t const& module, module_mtime_t mtime, module_manifest const& manifest);
+    void save() const;
+  private:
+    typedef std::pair<module_mtime_t, module_manifest> entry_t;
+    typedef std::map<std::string, entry_t> entries_t;
+
+    path_t const path;
+    entries_t entries;
+    bool dirty;
+};
 
 }
 
-static void look_in_directory(module_path_t const& directory);
+static void look_in_directory(module_path_t const& directory, module_cache& cache);
+static bool read_manifest(module_path_t const& path, module_manifest& manifest);
+static void load_module(module_path_t const& path, module_cache& cache);
+static void load_module_once(module_path_t const& path);
 static void load_from_module(module_path_t const& path);
 static bool is_separator(module_path_t::value_type ch);
 
+template <typename T>
+static T new_types(T const& before, T const& after);
+
 static function_name_t const process_function_name = function_name_t("register_processes");
 static function_name_t const scheduler_function_name = function_name_t("register_schedulers");
 static module_path_t const default_module_dirs = module_path_t(DEFAULT_MODULE_PATHS);
 static envvar_name_t const sprokit_module_envvar = envvar_name_t("SPROKIT_MODULE_PATH");
+static envvar_name_t const sprokit_module_cache_envvar = envvar_name_t("SPROKIT_MODULE_CACHE");
 static lib_suffix_t const library_suffix = lib_suffix_t(LIBRARY_SUFFIX);
+static lib_suffix_t const manifest_suffix = lib_suffix_t(".types");
+
+typedef boost::mutex loaded_mutex_t;
+typedef std::set<module_path_t> loaded_modules_t;
+
+static loaded_mutex_t loaded_mut;
+static loaded_modules_t loaded_modules;
 
 void
 load_known_modules()
@@ -108,9 +167,13 @@ load_known_modules()
 
   module_dirs.insert(module_dirs.end(), module_dirs_tmp.begin(), module_dirs_tmp.end());
 
+  envvar_value_t const cache_path = get_envvar(sprokit_module_cache_envvar);
+
+  module_cache cache(cache_path ? path_t(*cache_path) : path_t());
+
   BOOST_FOREACH (module_path_t const& module_dir, module_dirs)
   {
-    look_in_directory(module_dir);
+    look_in_directory(module_dir, cache);
 
 #ifdef USE_CONFIGURATION_SUBDIRECTORY
     module_path_t const subdir = module_dir +
@@ -121,13 +184,15 @@ load_known_modules()
 #endif
     ;
 
-    look_in_directory(subdir);
+    look_in_directory(subdir, cache);
 #endif
   }
+
+  cache.save();
 }
 
 void
-look_in_directory(module_path_t const& directory)
+look_in_directory(module_path_t const& directory, module_cache& cache)
 {
   if (directory.empty())
   {
@@ -166,10 +231,108 @@ look_in_directory(module_path_t const& directory)
       continue;
     }
 
-    load_from_module(ent.path().native());
+    load_module(ent.path().native(), cache);
   }
 }
 
+bool
+read_manifest(module_path_t const& path, module_manifest& manifest)
+{
+  path_t const manifest_path = path_t(path + module_path_t(manifest_suffix.begin(), manifest_suffix.end()));
+
+  boost::filesystem::ifstream fin(manifest_path);
+
+  if (!fin.good())
+  {
+    return false;
+  }
+
+  if (!manifest.read(fin))
+  {
+    /// \todo Log a warning that the manifest is malformed.
+    return false;
+  }
+
+  return true;
+}
+
+void
+load_module(module_path_t const& path, module_cache& cache)
+{
+  {
+    boost::unique_lock<loaded_mutex_t> const lock(loaded_mut);
+
+    (void)lock;
+
+    if (loaded_modules.count(path))
+    {
+      return;
+    }
+  }
+
+  boost::system::error_code ec;
+  module_mtime_t const mtime = boost::filesystem::last_write_time(path, ec);
+
+  module_manifest manifest;
+
+  bool const have_manifest = (read_manifest(path, manifest) ||
+                              (!ec && cache.lookup(path, mtime, manifest)));
+
+  process_registry_t const preg = process_registry::self();
+  scheduler_registry_t const sreg = scheduler_registry::self();
+
+  if (have_manifest)
+  {
+    // Hold off on opening the library until one of its types is used.
+    process_registry::module_loader_t const loader = boost::bind(load_module_once, path);
+
+    BOOST_FOREACH (process::type_t const& type, manifest.processes)
+    {
+      preg->register_deferred_process(type, loader);
+    }
+
+    BOOST_FOREACH (scheduler_registry::type_t const& type, manifest.schedulers)
+    {
+      sreg->register_deferred_scheduler(type, loader);
+    }
+
+    return;
+  }
+
+  process::types_t const processes = preg->types();
+  scheduler_registry::types_t const schedulers = sreg->types();
+
+  load_module_once(path);
+
+  if (ec)
+  {
+    return;
+  }
+
+  // Record what the module provided so the next run can avoid loading it.
+  manifest.processes = new_types(processes, preg->types());
+  manifest.schedulers = new_types(schedulers, sreg->types());
+
+  cache.update(path, mtime, manifest);
+}
+
+void
+load_module_once(module_path_t const& path)
+{
+  {
+    boost::unique_lock<loaded_mutex_t> const lock(loaded_mut);
+
+    (void)lock;
+
+    if (!loaded_modules.insert(path).second)
+    {
+      return;
+    }
+  }
+
+  load_from_module(path);
+}
+
 void
 load_from_module(module_path_t const& path)
 {
@@ -260,4 +423,241 @@ is_separator(module_path_t::value_type ch)
   return (ch == separator);
 }
 
+template <typename T>
+T
+new_types(T const& before, T const& after)
+{
+  T sorted_before = before;
+  T sorted_after = after;
+  T added;
+
+  std::sort(sorted_before.begin(), sorted_before.end());
+  std::sort(sorted_after.begin(), sorted_after.end());
+
+  std::set_difference(sorted_after.begin(), sorted_after.end(),
+                      sorted_before.begin(), sorted_before.end(),
+                      std::back_inserter(added));
+
+  return added;
+}
+
+static std::string const process_tag = std::string("process");
+static std::string const scheduler_tag = std::string("scheduler");
+static std::string const module_tag = std::string("module");
+
+module_manifest
+::module_manifest()
+  : processes()
+  , schedulers()
+{
+}
+
+module_manifest
+::~module_manifest()
+{
+}
+
+bool
+module_manifest
+::read(std::istream& istr)
+{
+  std::string line;
+
+  while (std::getline(istr, line))
+  {
+    if (line.empty() || boost::starts_with(line, "#"))
+    {
+      continue;
+    }
+
+    std::istringstream sstr(line);
+
+    std::string tag;
+    std::string type;
+
+    if (!(sstr >> tag >> type))
+    {
+      return false;
+    }
+
+    if (tag == process_tag)
+    {
+      processes.push_back(type);
+    }
+    else if (tag == scheduler_tag)
+    {
+      schedulers.push_back(type);
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void
+module_manifest
+::write(std::ostream& ostr) const
+{
+  BOOST_FOREACH (process::type_t const& type, processes)
+  {
+    ostr << process_tag << " " << type << std::endl;
+  }
+
+  BOOST_FOREACH (scheduler_registry::type_t const& type, schedulers)
+  {
+    ostr << scheduler_tag << " " << type << std::endl;
+  }
+}
+
+module_cache
+::module_cache(path_t const& path_)
+  : path(path_)
+  , entries()
+  , dirty(false)
+{
+  if (path.empty())
+  {
+    return;
+  }
+
+  boost::filesystem::ifstream fin(path);
+
+  // Each module is given as a line with its modification time and path
+  // followed by its manifest.
+  std::string line;
+  std::string module;
+  std::stringstream manifest_text;
+  module_mtime_t mtime = 0;
+
+  while (true)
+  {
+    bool const more = static_cast<bool>(std::getline(fin, line));
+
+    if (!more || boost::starts_with(line, module_tag + " "))
+    {
+      if (!module.empty())
+      {
+        module_manifest manifest;
+
+        if (manifest.read(manifest_text))
+        {
+          entries[module] = entry_t(mtime, manifest);
+        }
+      }
+
+      if (!more)
+      {
+        break;
+      }
+
+      std::istringstream sstr(line.substr(module_tag.size() + 1));
+
+      module.clear();
+      manifest_text.str(std::string());
+      manifest_text.clear();
+
+      if (sstr >> mtime)
+      {
+        sstr >> std::ws;
+        std::getline(sstr, module);
+      }
+
+      continue;
+    }
+
+    manifest_text << line << std::endl;
+  }
+}
+
+module_cache
+::~module_cache()
+{
+}
+
+bool
+module_cache
+::lookup(module_path_t const& module, module_mtime_t mtime, module_manifest& manifest) const
+{
+  entries_t::const_iterator const i = entries.find(path_t(module).string());
+
+  if (i == entries.end())
+  {
+    return false;
+  }
+
+  entry_t const& entry = i->second;
+
+  if (entry.first != mtime)
+  {
+    return false;
+  }
+
+  module_manifest const& cached_manifest = entry.second;
+
+  // Modules which registered nothing may find types at runtime (e.g., from
+  // cluster files), so they are always loaded.
+  if (cached_manifest.processes.empty() && cached_manifest.schedulers.empty())
+  {
+    return false;
+  }
+
+  manifest = cached_manifest;
+
+  return true;
+}
+
+void
+module_cache
+::update(module_path_t const& module, module_mtime_t mtime, module_manifest const& manifest)
+{
+  entries[path_t(module).string()] = entry_t(mtime, manifest);
+  dirty = true;
+}
+
+void
+module_cache
+::save() const
+{
+  if (path.empty() || !dirty)
+  {
+    return;
+  }
+
+  // Write to a temporary file so that concurrent readers never see a partial
+  // cache.
+  path_t const tmp_path = path_t(path.string() + ".tmp");
+
+  {
+    boost::filesystem::ofstream fout(tmp_path);
+
+    if (!fout.good())
+    {
+      /// \todo Log a warning that the cache could not be written.
+      return;
+    }
+
+    BOOST_FOREACH (entries_t::value_type const& entry, entries)
+    {
+      std::string const& module = entry.first;
+      module_mtime_t const mtime = entry.second.first;
+      module_manifest const& manifest = entry.second.second;
+
+      fout << module_tag << " " << mtime << " " << module << std::endl;
+      manifest.write(fout);
+    }
+  }
+
+  boost::system::error_code ec;
+
+  boost::filesystem::rename(tmp_path, path, ec);
+
+  if (ec)
+  {
+    /// \todo Log a warning that the cache could not be written.
+  }
+}
+
 }
@@ -44,6 +44,16 @@ namespace sprokit
 
 /**
  * \brief Load modules from the system path.
+ *
+ * A module may ship a manifest next to it with the same name plus a \c .types
+ * suffix. It lists the types it provides, one per line, as \c process or \c
+ * scheduler followed by the type name. If the \c SPROKIT_MODULE_CACHE
+ * environment variable names a file, manifests for modules without one are
+ * recorded there, keyed by the modification time of the module.
+ *
+ * Modules with a manifest are not loaded until one of their types is created
+ * or described through the registries. All other modules are loaded
+ * immediately.
  */
 SPROKIT_PIPELINE_EXPORT void load_known_modules();
 
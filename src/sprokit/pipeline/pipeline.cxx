@@ -32,12 +32,14 @@
 #include "pipeline_exception.h"
 
 #include "edge.h"
+#include "memory_budget.h"
 #include "process_exception.h"
 #include "process_cluster.h"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/graph/directed_graph.hpp>
 #include <boost/graph/topological_sort.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/math/common_factor_rt.hpp>
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
@@ -65,6 +67,39 @@
 namespace sprokit
 {
 
+namespace
+{
+
+/**
+ * \class replica_cluster
+ *
+ * \brief A cluster which runs copies of a process on disjoint parts of its input.
+ *
+ * Each input is split among the replicas by a \c distribute process and each
+ * output is merged back into stamp order by a \c collate process.
+ */
+class replica_cluster
+  : public process_cluster
+{
+  public:
+    replica_cluster(name_t const& name_, type_t const& type_, config_t const& conf,
+                    ports_t const& inputs, ports_t const& outputs, size_t replicas);
+    ~replica_cluster();
+  private:
+    static config_t cluster_config(name_t const& name_, type_t const& type_);
+
+    static name_t const name_distribute;
+    static name_t const name_collate;
+    static name_t const name_replica_prefix;
+    static name_t const name_drop_prefix;
+    static type_t const type_distribute;
+    static type_t const type_collate;
+    static type_t const type_sink;
+    static port_t const port_sink;
+};
+
+}
+
 class pipeline::priv
 {
   public:
@@ -72,6 +107,7 @@ class pipeline::priv
     ~priv();
 
     void check_duplicate_name(process::name_t const& name);
+    process_t replicate(process_t const& process) const;
     void remove_from_pipeline(process::name_t const& name);
     void propagate(process::name_t const& root);
 
@@ -106,6 +142,26 @@ class pipeline::priv
 
     typedef std::map<process::port_addr_t, bool> shared_port_map_t;
 
+    // Indices into the connections so that queries only need to look at the
+    // connections they are interested in.
+    typedef std::vector<size_t> connection_indices_t;
+    typedef std::map<process::name_t, connection_indices_t> process_connection_map_t;
+    typedef std::map<process::port_addr_t, connection_indices_t> port_connection_map_t;
+
+    typedef std::set<process::connection_t> connection_set_t;
+    typedef std::map<process::name_t, connection_set_t> untyped_connection_map_t;
+
+    void add_connection(process::connection_t const& connection);
+    void index_connections();
+    template <typename Map>
+    static connection_indices_t const& indices_for(Map const& index, typename Map::key_type const& key);
+
+    void add_untyped_connection(process::connection_t const& connection);
+    void forget_untyped_connection(process::connection_t const& connection);
+    void forget_untyped_connections_with(process::name_t const& name);
+
+    processes_t processes_named(std::set<process::name_t> const& names) const;
+
     // Steps for checking a connection.
     port_type_status check_connection_types(process::connection_t const& connection, process::port_type_t const& up_type, process::port_type_t const& down_type);
     bool check_connection_flags(process::connection_t const& connection, process::port_flags_t const& up_flags, process::port_flags_t const& down_flags);
@@ -122,6 +178,9 @@ class pipeline::priv
     void check_for_dag() const;
     void initialize_processes();
     void check_port_frequencies() const;
+    void port_frequencies(process::connection_t const& connection,
+                          process::port_frequency_t& up_port_freq,
+                          process::port_frequency_t& down_port_freq) const;
 
     void ensure_setup() const;
 
@@ -138,9 +197,15 @@ class pipeline::priv
     process_parent_map_t process_parent_map;
     parent_stack_t parent_stack;
 
+    process_connection_map_t process_inputs;
+    process_connection_map_t process_outputs;
+    port_connection_map_t port_senders;
+    port_connection_map_t port_receivers;
+
     process::connections_t data_dep_connections;
     cluster_connections_t cluster_connections;
-    process::connections_t untyped_connections;
+    // Each connection is kept under both of its processes.
+    untyped_connection_map_t untyped_connections;
     type_pinnings_t type_pinnings;
 
     shared_port_map_t connected_shared_ports;
@@ -182,6 +247,7 @@ class pipeline::priv
     static config::key_t const config_edge;
     static config::key_t const config_edge_type;
     static config::key_t const config_edge_conn;
+    static config::key_t const config_memory_budget;
     static config::key_t const upstream_subblock;
     static config::key_t const downstream_subblock;
 };
@@ -189,6 +255,7 @@ class pipeline::priv
 config::key_t const pipeline::priv::config_edge = config::key_t("_edge");
 config::key_t const pipeline::priv::config_edge_type = config::key_t("_edge_by_type");
 config::key_t const pipeline::priv::config_edge_conn = config::key_t("_edge_by_conn");
+config::key_t const pipeline::priv::config_memory_budget = config::key_t("_memory_budget");
 config::key_t const pipeline::priv::upstream_subblock = config::key_t("up");
 config::key_t const pipeline::priv::downstream_subblock = config::key_t("down");
 
@@ -227,6 +294,15 @@ ::add_process(process_t const& process)
 
   d->check_duplicate_name(name);
 
+  process_t const replicated = d->replicate(process);
+
+  if (replicated != process)
+  {
+    add_process(replicated);
+
+    return;
+  }
+
   process_cluster_t const cluster = boost::dynamic_pointer_cast<process_cluster>(process);
 
   process::name_t parent;
@@ -387,7 +463,7 @@ ::connect(process::name_t const& upstream_name,
       break;
   }
 
-  d->connections.push_back(connection);
+  d->add_connection(connection);
 }
 
 void
@@ -420,10 +496,12 @@ ::disconnect(process::name_t const& upstream_name,
   FORGET_CONNECTION(process::connections_t, eq, d->planned_connections);
   FORGET_CONNECTION(process::connections_t, eq, d->connections);
   FORGET_CONNECTION(process::connections_t, eq, d->data_dep_connections);
-  FORGET_CONNECTION(process::connections_t, eq, d->untyped_connections);
   FORGET_CONNECTION(priv::cluster_connections_t, cluster_eq, d->cluster_connections);
 
 #undef FORGET_CONNECTION
+
+  d->forget_untyped_connection(conn);
+  d->index_connections();
 }
 
 void
@@ -504,6 +582,7 @@ ::reset()
 
   // Clear internal bookkeeping.
   d->connections.clear();
+  d->index_connections();
   d->edge_map.clear();
   d->data_dep_connections.clear();
   d->cluster_connections.clear();
@@ -703,31 +782,18 @@ ::upstream_for_process(process::name_t const& name) const
 
   std::set<process::name_t> names;
 
-  BOOST_FOREACH (process::connection_t const& connection, d->connections)
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->process_inputs, name))
   {
+    process::connection_t const& connection = d->connections[i];
+
     process::port_addr_t const& upstream_addr = connection.first;
-    process::port_addr_t const& downstream_addr = connection.second;
 
     process::name_t const& upstream_name = upstream_addr.first;
-    process::name_t const& downstream_name = downstream_addr.first;
 
-    if (downstream_name == name)
-    {
-      names.insert(upstream_name);
-    }
+    names.insert(upstream_name);
   }
 
-  processes_t processes;
-
-  BOOST_FOREACH (process::name_t const& process_name, names)
-  {
-    priv::process_map_t::const_iterator const i = d->process_map.find(process_name);
-    process_t const& process = i->second;
-
-    processes.push_back(process);
-  }
-
-  return processes;
+  return d->processes_named(names);
 }
 
 process_t
@@ -736,25 +802,23 @@ ::upstream_for_port(process::name_t const& name, process::port_t const& port) co
 {
   d->ensure_setup();
 
-  BOOST_FOREACH (process::connection_t const& connection, d->connections)
+  process::port_addr_t const addr = process::port_addr_t(name, port);
+  priv::connection_indices_t const& indices = priv::indices_for(d->port_senders, addr);
+
+  if (indices.empty())
   {
-    process::port_addr_t const& upstream_addr = connection.first;
-    process::port_addr_t const& downstream_addr = connection.second;
+    return process_t();
+  }
 
-    process::name_t const& upstream_name = upstream_addr.first;
-    process::name_t const& downstream_name = downstream_addr.first;
-    process::port_t const& downstream_port = downstream_addr.second;
+  process::connection_t const& connection = d->connections[indices.front()];
 
-    if ((downstream_name == name) &&
-        (downstream_port == port))
-    {
-      priv::process_map_t::const_iterator const i = d->process_map.find(upstream_name);
+  process::port_addr_t const& upstream_addr = connection.first;
 
-      return i->second;
-    }
-  }
+  process::name_t const& upstream_name = upstream_addr.first;
 
-  return process_t();
+  priv::process_map_t::const_iterator const i = d->process_map.find(upstream_name);
+
+  return i->second;
 }
 
 processes_t
@@ -765,31 +829,18 @@ ::downstream_for_process(process::name_t const& name) const
 
   std::set<process::name_t> names;
 
-  BOOST_FOREACH (process::connection_t const& connection, d->connections)
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->process_outputs, name))
   {
-    process::port_addr_t const& upstream_addr = connection.first;
+    process::connection_t const& connection = d->connections[i];
+
     process::port_addr_t const& downstream_addr = connection.second;
 
-    process::name_t const& upstream_name = upstream_addr.first;
     process::name_t const& downstream_name = downstream_addr.first;
 
-    if (upstream_name == name)
-    {
-      names.insert(downstream_name);
-    }
+    names.insert(downstream_name);
   }
 
-  processes_t processes;
-
-  BOOST_FOREACH (process::name_t const& process_name, names)
-  {
-    priv::process_map_t::const_iterator const i = d->process_map.find(process_name);
-    process_t const& process = i->second;
-
-    processes.push_back(process);
-  }
-
-  return processes;
+  return d->processes_named(names);
 }
 
 processes_t
@@ -798,35 +849,22 @@ ::downstream_for_port(process::name_t const& name, process::port_t const& port)
 {
   d->ensure_setup();
 
+  process::port_addr_t const addr = process::port_addr_t(name, port);
+
   std::set<process::name_t> names;
 
-  BOOST_FOREACH (process::connection_t const& connection, d->connections)
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->port_receivers, addr))
   {
-    process::port_addr_t const& upstream_addr = connection.first;
+    process::connection_t const& connection = d->connections[i];
+
     process::port_addr_t const& downstream_addr = connection.second;
 
-    process::name_t const& upstream_name = upstream_addr.first;
-    process::port_t const& upstream_port = upstream_addr.second;
     process::name_t const& downstream_name = downstream_addr.first;
 
-    if ((upstream_name == name) &&
-        (upstream_port == port))
-    {
-      names.insert(downstream_name);
-    }
+    names.insert(downstream_name);
   }
 
-  processes_t processes;
-
-  BOOST_FOREACH (process::name_t const& process_name, names)
-  {
-    priv::process_map_t::const_iterator const i = d->process_map.find(process_name);
-    process_t const& process = i->second;
-
-    processes.push_back(process);
-  }
-
-  return processes;
+  return d->processes_named(names);
 }
 
 process::port_addr_t
@@ -835,22 +873,17 @@ ::sender_for_port(process::name_t const& name, process::port_t const& port) cons
 {
   d->ensure_setup();
 
-  BOOST_FOREACH (process::connection_t const& connection, d->connections)
-  {
-    process::port_addr_t const& upstream_addr = connection.first;
-    process::port_addr_t const& downstream_addr = connection.second;
-
-    process::name_t const& downstream_name = downstream_addr.first;
-    process::port_t const& downstream_port = downstream_addr.second;
+  process::port_addr_t const addr = process::port_addr_t(name, port);
+  priv::connection_indices_t const& indices = priv::indices_for(d->port_senders, addr);
 
-    if ((downstream_name == name) &&
-        (downstream_port == port))
-    {
-      return upstream_addr;
-    }
+  if (indices.empty())
+  {
+    return process::port_addr_t();
   }
 
-  return process::port_addr_t();
+  process::connection_t const& connection = d->connections[indices.front()];
+
+  return connection.first;
 }
 
 process::port_addrs_t
@@ -859,21 +892,17 @@ ::receivers_for_port(process::name_t const& name, process::port_t const& port) c
 {
   d->ensure_setup();
 
+  process::port_addr_t const addr = process::port_addr_t(name, port);
+
   process::port_addrs_t port_addrs;
 
-  BOOST_FOREACH (process::connection_t const& connection, d->connections)
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->port_receivers, addr))
   {
-    process::port_addr_t const& upstream_addr = connection.first;
-    process::port_addr_t const& downstream_addr = connection.second;
+    process::connection_t const& connection = d->connections[i];
 
-    process::name_t const& upstream_name = upstream_addr.first;
-    process::port_t const& upstream_port = upstream_addr.second;
+    process::port_addr_t const& downstream_addr = connection.second;
 
-    if ((upstream_name == name) &&
-        (upstream_port == port))
-    {
-      port_addrs.push_back(downstream_addr);
-    }
+    port_addrs.push_back(downstream_addr);
   }
 
   return port_addrs;
@@ -888,22 +917,14 @@ ::edge_for_connection(process::name_t const& upstream_name,
 {
   d->ensure_setup();
 
-  for (size_t i = 0; i < d->connections.size(); ++i)
+  process::port_addr_t const upstream_addr = process::port_addr_t(upstream_name, upstream_port);
+  process::port_addr_t const downstream_addr = process::port_addr_t(downstream_name, downstream_port);
+
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->port_receivers, upstream_addr))
   {
     process::connection_t const& connection = d->connections[i];
 
-    process::port_addr_t const& upstream_addr = connection.first;
-    process::port_addr_t const& downstream_addr = connection.second;
-
-    process::name_t const& up_name = upstream_addr.first;
-    process::port_t const& up_port = upstream_addr.second;
-    process::name_t const& down_name = downstream_addr.first;
-    process::port_t const& down_port = downstream_addr.second;
-
-    if ((up_name == upstream_name) &&
-        (up_port == upstream_port) &&
-        (down_name == downstream_name) &&
-        (down_port == downstream_port))
+    if (connection.second == downstream_addr)
     {
       return d->edge_map[i];
     }
@@ -920,20 +941,13 @@ ::input_edges_for_process(process::name_t const& name) const
 
   edges_t edges;
 
-  BOOST_FOREACH (priv::edge_map_t::value_type const& edge_index, d->edge_map)
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->process_inputs, name))
   {
-    size_t const& i = edge_index.first;
-    edge_t const& edge = edge_index.second;
-
-    process::connection_t const connection = d->connections[i];
+    priv::edge_map_t::const_iterator const e = d->edge_map.find(i);
 
-    process::port_addr_t const& downstream_addr = connection.second;
-
-    process::name_t const& downstream_name = downstream_addr.first;
-
-    if (downstream_name == name)
+    if (e != d->edge_map.end())
     {
-      edges.push_back(edge);
+      edges.push_back(e->second);
     }
   }
 
@@ -946,22 +960,15 @@ ::input_edge_for_port(process::name_t const& name, process::port_t const& port)
 {
   d->ensure_setup();
 
-  BOOST_FOREACH (priv::edge_map_t::value_type const& edge_index, d->edge_map)
-  {
-    size_t const& i = edge_index.first;
-    edge_t const& edge = edge_index.second;
-
-    process::connection_t const connection = d->connections[i];
+  process::port_addr_t const addr = process::port_addr_t(name, port);
 
-    process::port_addr_t const& downstream_addr = connection.second;
-
-    process::name_t const& downstream_name = downstream_addr.first;
-    process::port_t const& downstream_port = downstream_addr.second;
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->port_senders, addr))
+  {
+    priv::edge_map_t::const_iterator const e = d->edge_map.find(i);
 
-    if ((downstream_name == name) &&
-        (downstream_port == port))
+    if (e != d->edge_map.end())
     {
-      return edge;
+      return e->second;
     }
   }
 
@@ -976,20 +983,13 @@ ::output_edges_for_process(process::name_t const& name) const
 
   edges_t edges;
 
-  BOOST_FOREACH (priv::edge_map_t::value_type const& edge_index, d->edge_map)
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->process_outputs, name))
   {
-    size_t const& i = edge_index.first;
-    edge_t const& edge = edge_index.second;
-
-    process::connection_t const connection = d->connections[i];
-
-    process::port_addr_t const& upstream_addr = connection.first;
-
-    process::name_t const& upstream_name = upstream_addr.first;
+    priv::edge_map_t::const_iterator const e = d->edge_map.find(i);
 
-    if (upstream_name == name)
+    if (e != d->edge_map.end())
     {
-      edges.push_back(edge);
+      edges.push_back(e->second);
     }
   }
 
@@ -1002,24 +1002,17 @@ ::output_edges_for_port(process::name_t const& name, process::port_t const& port
 {
   d->ensure_setup();
 
+  process::port_addr_t const addr = process::port_addr_t(name, port);
+
   edges_t edges;
 
-  BOOST_FOREACH (priv::edge_map_t::value_type const& edge_index, d->edge_map)
+  BOOST_FOREACH (size_t const i, priv::indices_for(d->port_receivers, addr))
   {
-    size_t const& i = edge_index.first;
-    edge_t const& edge = edge_index.second;
-
-    process::connection_t const connection = d->connections[i];
-
-    process::port_addr_t const& upstream_addr = connection.first;
+    priv::edge_map_t::const_iterator const e = d->edge_map.find(i);
 
-    process::name_t const& upstream_name = upstream_addr.first;
-    process::port_t const& upstream_port = upstream_addr.second;
-
-    if ((upstream_name == name) &&
-        (upstream_port == port))
+    if (e != d->edge_map.end())
     {
-      edges.push_back(edge);
+      edges.push_back(e->second);
     }
   }
 
@@ -1058,6 +1051,10 @@ ::priv(pipeline* pipe, config_t conf)
   , process_map()
   , cluster_map()
   , edge_map()
+  , process_inputs()
+  , process_outputs()
+  , port_senders()
+  , port_receivers()
   , data_dep_connections()
   , untyped_connections()
   , type_pinnings()
@@ -1083,6 +1080,85 @@ ::check_duplicate_name(process::name_t const& name)
   }
 }
 
+process_t
+pipeline::priv
+::replicate(process_t const& process) const
+{
+  size_t const replicas = process->config_value<size_t>(process::config_replicas);
+
+  if (replicas == 1)
+  {
+    return process;
+  }
+
+  process::name_t const name = process->name();
+
+  if (!replicas)
+  {
+    throw invalid_replication_exception(name, replicas, "at least one copy must run");
+  }
+
+  process::properties_t const props = process->properties();
+
+  if (!props.count(process::property_replicable))
+  {
+    throw invalid_replication_exception(name, replicas, "the process is not replicable");
+  }
+
+  process::type_t const type = process->type();
+
+  if (type.empty())
+  {
+    throw invalid_replication_exception(name, replicas, "the process has no type to create copies from");
+  }
+
+  process::ports_t inputs;
+  process::ports_t outputs;
+
+  // Ports which are internal to the pipeline are not split among the replicas.
+  BOOST_FOREACH (process::port_t const& port, process->input_ports())
+  {
+    if (!boost::starts_with(port, "_"))
+    {
+      inputs.push_back(port);
+    }
+  }
+
+  BOOST_FOREACH (process::port_t const& port, process->output_ports())
+  {
+    if (!boost::starts_with(port, "_"))
+    {
+      outputs.push_back(port);
+    }
+  }
+
+  if (inputs.empty())
+  {
+    throw invalid_replication_exception(name, replicas, "the process has no inputs to split");
+  }
+
+  config_t const base_conf = process->get_config();
+  config_t const conf = config::empty_config();
+
+  BOOST_FOREACH (config::key_t const& key, base_conf->available_values())
+  {
+    // The copies must not replicate themselves again.
+    if (key == process::config_replicas)
+    {
+      continue;
+    }
+
+    conf->set_value(key, base_conf->get_value<config::value_t>(key));
+
+    if (base_conf->is_read_only(key))
+    {
+      conf->mark_read_only(key);
+    }
+  }
+
+  return boost::make_shared<replica_cluster>(name, type, conf, inputs, outputs, replicas);
+}
+
 void
 pipeline::priv
 ::remove_from_pipeline(process::name_t const& name)
@@ -1100,10 +1176,141 @@ ::remove_from_pipeline(process::name_t const& name)
   FORGET_CONNECTIONS(process::connections_t, is, planned_connections);
   FORGET_CONNECTIONS(process::connections_t, is, connections);
   FORGET_CONNECTIONS(process::connections_t, is, data_dep_connections);
-  FORGET_CONNECTIONS(process::connections_t, is, untyped_connections);
   FORGET_CONNECTIONS(cluster_connections_t, cluster_is, cluster_connections);
 
 #undef FORGET_CONNECTIONS
+
+  forget_untyped_connections_with(name);
+  index_connections();
+}
+
+void
+pipeline::priv
+::add_connection(process::connection_t const& connection)
+{
+  size_t const i = connections.size();
+
+  connections.push_back(connection);
+
+  process::port_addr_t const& upstream_addr = connection.first;
+  process::port_addr_t const& downstream_addr = connection.second;
+
+  process::name_t const& upstream_name = upstream_addr.first;
+  process::name_t const& downstream_name = downstream_addr.first;
+
+  process_outputs[upstream_name].push_back(i);
+  process_inputs[downstream_name].push_back(i);
+  port_receivers[upstream_addr].push_back(i);
+  port_senders[downstream_addr].push_back(i);
+}
+
+void
+pipeline::priv
+::index_connections()
+{
+  process::connections_t const conns = connections;
+
+  connections.clear();
+  process_inputs.clear();
+  process_outputs.clear();
+  port_senders.clear();
+  port_receivers.clear();
+
+  BOOST_FOREACH (process::connection_t const& connection, conns)
+  {
+    add_connection(connection);
+  }
+}
+
+template <typename Map>
+pipeline::priv::connection_indices_t const&
+pipeline::priv
+::indices_for(Map const& index, typename Map::key_type const& key)
+{
+  static connection_indices_t const no_indices = connection_indices_t();
+
+  typename Map::const_iterator const i = index.find(key);
+
+  if (i == index.end())
+  {
+    return no_indices;
+  }
+
+  return i->second;
+}
+
+void
+pipeline::priv
+::add_untyped_connection(process::connection_t const& connection)
+{
+  process::name_t const& upstream_name = connection.first.first;
+  process::name_t const& downstream_name = connection.second.first;
+
+  untyped_connections[upstream_name].insert(connection);
+  untyped_connections[downstream_name].insert(connection);
+}
+
+void
+pipeline::priv
+::forget_untyped_connection(process::connection_t const& connection)
+{
+  process::name_t const names[] = { connection.first.first, connection.second.first };
+
+  BOOST_FOREACH (process::name_t const& name, names)
+  {
+    untyped_connection_map_t::iterator const i = untyped_connections.find(name);
+
+    if (i == untyped_connections.end())
+    {
+      continue;
+    }
+
+    connection_set_t& conns = i->second;
+
+    conns.erase(connection);
+
+    // Keep the map empty once everything is resolved.
+    if (conns.empty())
+    {
+      untyped_connections.erase(i);
+    }
+  }
+}
+
+void
+pipeline::priv
+::forget_untyped_connections_with(process::name_t const& name)
+{
+  untyped_connection_map_t::const_iterator const i = untyped_connections.find(name);
+
+  if (i == untyped_connections.end())
+  {
+    return;
+  }
+
+  connection_set_t const conns = i->second;
+
+  BOOST_FOREACH (process::connection_t const& connection, conns)
+  {
+    forget_untyped_connection(connection);
+  }
+}
+
+processes_t
+pipeline::priv
+::processes_named(std::set<process::name_t> const& names) const
+{
+  processes_t processes;
+
+  BOOST_FOREACH (process::name_t const& process_name, names)
+  {
+    process_map_t::const_iterator const i = process_map.find(process_name);
+    process_t const& process = i->second;
+
+    processes.push_back(process);
+  }
+
+  return processes;
 }
 
 pipeline::priv::port_type_status
@@ -1126,7 +1333,7 @@ ::check_connection_types(process::connection_t const& connection, process::port_
   {
     if (up_flow_dep && down_flow_dep)
     {
-      untyped_connections.push_back(connection);
+      add_untyped_connection(connection);
     }
     else if (up_flow_dep)
     {
@@ -1203,8 +1410,15 @@ ::propagate(process::name_t const& root)
 
     process_t const proc = q->process_by_name(name);
 
-    process::connections_t const conns = untyped_connections;
-    untyped_connections.clear();
+    untyped_connection_map_t::const_iterator const i = untyped_connections.find(name);
+
+    if (i == untyped_connections.end())
+    {
+      continue;
+    }
+
+    // Resolving connections modifies the map.
+    connection_set_t const conns = i->second;
 
     BOOST_FOREACH (process::connection_t const& connection, conns)
     {
@@ -1215,8 +1429,6 @@ ::propagate(process::name_t const& root)
       process::name_t const& downstream_name = downstream_addr.first;
       process::port_t const& downstream_port = downstream_addr.second;
 
-      bool resolved = false;
-
       if (downstream_name == name)
       {
         // Push up.
@@ -1236,7 +1448,7 @@ ::propagate(process::name_t const& root)
                                         type, true);
           }
 
-          resolved = true;
+          forget_untyped_connection(connection);
 
           q->connect(upstream_name, upstream_port,
                      downstream_name, downstream_port);
@@ -1263,7 +1475,7 @@ ::propagate(process::name_t const& root)
                                         type, false);
           }
 
-          resolved = true;
+          forget_untyped_connection(connection);
 
           q->connect(upstream_name, upstream_port,
                      downstream_name, downstream_port);
@@ -1271,12 +1483,6 @@ ::propagate(process::name_t const& root)
           kyu.push(downstream_name);
         }
       }
-
-      if (!resolved)
-      {
-        // Remember that the resolution didn't happen.
-        untyped_connections.push_back(connection);
-      }
     }
   }
 }
@@ -1585,6 +1791,14 @@ ::make_connections()
 {
   size_t const len = connections.size();
 
+  size_t const budget_limit = config->get_value<size_t>(priv::config_memory_budget, 0);
+  memory_budget_t budget;
+
+  if (budget_limit)
+  {
+    budget = boost::make_shared<memory_budget>(budget_limit);
+  }
+
   for (size_t i = 0; i < len; ++i)
   {
     process::connection_t const& connection = connections[i];
@@ -1639,6 +1853,11 @@ ::make_connections()
 
     edge_t const e = boost::make_shared<edge>(edge_config);
 
+    if (budget)
+    {
+      e->set_memory_budget(budget);
+    }
+
     edge_map[i] = e;
 
     up_proc->connect_output_port(upstream_port, e);
@@ -1844,112 +2063,109 @@ ::check_port_frequencies() const
     return;
   }
 
-  process::names_t const names = q->process_names();
-
   typedef std::map<process::name_t, process::port_frequency_t> process_frequency_map_t;
 
   process_frequency_map_t freq_map;
 
-  std::queue<process::connection_t> unchecked_connections;
+  std::queue<process::name_t> to_visit;
 
+  // Seed the frequency map at 1-to-1 based on the upstream process of the
+  // first connection which can be checked.
   BOOST_FOREACH (process::connection_t const& connection, connections)
   {
-    unchecked_connections.push(connection);
-  }
+    process::port_frequency_t up_port_freq;
+    process::port_frequency_t down_port_freq;
 
-  while (!unchecked_connections.empty())
-  {
-    process::connection_t const connection = unchecked_connections.front();
-    unchecked_connections.pop();
+    port_frequencies(connection, up_port_freq, down_port_freq);
 
-    process::port_addr_t const& upstream_addr = connection.first;
-    process::port_addr_t const& downstream_addr = connection.second;
+    if (up_port_freq && down_port_freq)
+    {
+      process::name_t const& upstream_name = connection.first.first;
 
-    process::name_t const& upstream_name = upstream_addr.first;
-    process::port_t const& upstream_port = upstream_addr.second;
-    process::name_t const& downstream_name = downstream_addr.first;
-    process::port_t const& downstream_port = downstream_addr.second;
+      freq_map[upstream_name] = base_freq;
+      to_visit.push(upstream_name);
 
-    process_t const up_proc = q->process_by_name(upstream_name);
-    process::port_info_t const up_info = up_proc->output_port_info(upstream_port);
-    process::port_frequency_t const& up_port_freq = up_info->frequency;
+      break;
+    }
+  }
 
-    process_t const down_proc = q->process_by_name(downstream_name);
-    process::port_info_t const down_info = down_proc->input_port_info(downstream_port);
-    process::port_frequency_t const& down_port_freq = down_info->frequency;
+  // Spread the frequencies through the connections of each process as it is
+  // reached.
+  while (!to_visit.empty())
+  {
+    process::name_t const name = to_visit.front();
+    to_visit.pop();
+
+    connection_indices_t indices = indices_for(process_outputs, name);
+    connection_indices_t const& input_indices = indices_for(process_inputs, name);
 
-    if (!up_port_freq || !down_port_freq)
+    indices.insert(indices.end(), input_indices.begin(), input_indices.end());
+
+    BOOST_FOREACH (size_t const i, indices)
     {
-      /// \todo Issue a warning that the edge frequency cannot be validated.
+      process::connection_t const& connection = connections[i];
 
-      continue;
-    }
+      process::port_addr_t const& upstream_addr = connection.first;
+      process::port_addr_t const& downstream_addr = connection.second;
 
-    bool const up_in_map = (0 != freq_map.count(upstream_name));
-    bool const down_in_map = (0 != freq_map.count(downstream_name));
+      process::name_t const& upstream_name = upstream_addr.first;
+      process::port_t const& upstream_port = upstream_addr.second;
+      process::name_t const& downstream_name = downstream_addr.first;
+      process::port_t const& downstream_port = downstream_addr.second;
 
-    bool have_upstream = false;
-    bool have_downstream = false;
+      process::port_frequency_t up_port_freq;
+      process::port_frequency_t down_port_freq;
 
-    if (!up_in_map && !down_in_map)
-    {
-      if (freq_map.empty())
+      port_frequencies(connection, up_port_freq, down_port_freq);
+
+      if (!up_port_freq || !down_port_freq)
       {
-        // Seed the frequency map at 1-to-1 based on the upstream process.
-        freq_map[upstream_name] = base_freq;
-        have_upstream = true;
+        /// \todo Issue a warning that the edge frequency cannot be validated.
+
+        continue;
       }
-    }
 
-    if (up_in_map)
-    {
-      have_upstream = true;
-    }
-    if (down_in_map)
-    {
-      have_downstream = true;
-    }
+      bool const have_upstream = (0 != freq_map.count(upstream_name));
+      bool const have_downstream = (0 != freq_map.count(downstream_name));
 
-    // Validate the connection.
-    if (have_upstream && have_downstream)
-    {
-      process::port_frequency_t const up_proc_freq = freq_map[upstream_name];
+      // Validate the connection.
+      if (have_upstream && have_downstream)
+      {
+        process::port_frequency_t const up_proc_freq = freq_map[upstream_name];
 
-      process::port_frequency_t const edge_freq = up_proc_freq * up_port_freq;
-      process::port_frequency_t const expect_freq = edge_freq / down_port_freq;
+        process::port_frequency_t const edge_freq = up_proc_freq * up_port_freq;
+        process::port_frequency_t const expect_freq = edge_freq / down_port_freq;
 
-      process::port_frequency_t const down_proc_freq = freq_map[downstream_name];
+        process::port_frequency_t const down_proc_freq = freq_map[downstream_name];
 
-      if (down_proc_freq != expect_freq)
-      {
-        throw frequency_mismatch_exception(upstream_name, upstream_port, up_proc_freq, up_port_freq,
-                                           downstream_name, downstream_port, down_proc_freq, down_port_freq);
+        if (down_proc_freq != expect_freq)
+        {
+          throw frequency_mismatch_exception(upstream_name, upstream_port, up_proc_freq, up_port_freq,
+                                             downstream_name, downstream_port, down_proc_freq, down_port_freq);
+        }
       }
-    }
-    // Propagate the frequency downstream.
-    else if (have_upstream)
-    {
-      process::port_frequency_t const up_proc_freq = freq_map[upstream_name];
+      // Propagate the frequency downstream.
+      else if (have_upstream)
+      {
+        process::port_frequency_t const up_proc_freq = freq_map[upstream_name];
 
-      process::port_frequency_t const edge_freq = up_proc_freq * up_port_freq;
-      process::port_frequency_t const expect_freq = edge_freq / down_port_freq;
+        process::port_frequency_t const edge_freq = up_proc_freq * up_port_freq;
+        process::port_frequency_t const expect_freq = edge_freq / down_port_freq;
 
-      freq_map[downstream_name] = expect_freq;
-    }
-    // Propagate the frequency upstream.
-    else if (have_downstream)
-    {
-      process::port_frequency_t const down_proc_freq = freq_map[downstream_name];
+        freq_map[downstream_name] = expect_freq;
+        to_visit.push(downstream_name);
+      }
+      // Propagate the frequency upstream.
+      else
+      {
+        process::port_frequency_t const down_proc_freq = freq_map[downstream_name];
 
-      process::port_frequency_t const edge_freq = down_proc_freq * down_port_freq;
-      process::port_frequency_t const expect_freq = edge_freq / up_port_freq;
+        process::port_frequency_t const edge_freq = down_proc_freq * down_port_freq;
+        process::port_frequency_t const expect_freq = edge_freq / up_port_freq;
 
-      freq_map[upstream_name] = expect_freq;
-    }
-    // Not part of the already-checked parts.
-    else
-    {
-      unchecked_connections.push(connection);
+        freq_map[upstream_name] = expect_freq;
+        to_visit.push(upstream_name);
+      }
     }
   }
 
@@ -1976,6 +2192,25 @@ ::check_port_frequencies() const
   }
 }
 
+void
+pipeline::priv
+::port_frequencies(process::connection_t const& connection,
+                   process::port_frequency_t& up_port_freq,
+                   process::port_frequency_t& down_port_freq) const
+{
+  process::port_addr_t const& upstream_addr = connection.first;
+  process::port_addr_t const& downstream_addr = connection.second;
+
+  process_t const up_proc = q->process_by_name(upstream_addr.first);
+  process::port_info_t const up_info = up_proc->output_port_info(upstream_addr.second);
+
+  process_t const down_proc = q->process_by_name(downstream_addr.first);
+  process::port_info_t const down_info = down_proc->input_port_info(downstream_addr.second);
+
+  up_port_freq = up_info->frequency;
+  down_port_freq = down_info->frequency;
+}
+
 void
 pipeline::priv
 ::ensure_setup() const
@@ -2086,4 +2321,115 @@ pipeline::priv::propagation_exception
 {
 }
 
+namespace
+{
+
+process::name_t const replica_cluster::name_distribute = process::name_t("distribute");
+process::name_t const replica_cluster::name_collate = process::name_t("collate");
+process::name_t const replica_cluster::name_replica_prefix = process::name_t("replica");
+process::name_t const replica_cluster::name_drop_prefix = process::name_t("drop/");
+process::type_t const replica_cluster::type_distribute = process::type_t("distribute");
+process::type_t const replica_cluster::type_collate = process::type_t("collate");
+process::type_t const replica_cluster::type_sink = process::type_t("sink");
+process::port_t const replica_cluster::port_sink = process::port_t("sink");
+
+replica_cluster
+::replica_cluster(name_t const& name_, type_t const& type_, config_t const& conf,
+                  ports_t const& inputs, ports_t const& outputs, size_t replicas)
+  : process_cluster(cluster_config(name_, type_))
+{
+  config_t const dist_conf = config::empty_config();
+  config_t const coll_conf = config::empty_config();
+
+  // Data for separate inputs must stay together, so only a lone input may be
+  // sent to whichever replica has room for it.
+  dist_conf->set_value("mode", (inputs.size() == 1) ? "shortest_queue" : "round_robin");
+  coll_conf->set_value("mode", "reorder");
+
+  add_process(name_distribute, type_distribute, dist_conf);
+
+  if (!outputs.empty())
+  {
+    add_process(name_collate, type_collate, coll_conf);
+  }
+
+  std::vector<port_t> groups;
+
+  for (size_t i = 0; i < replicas; ++i)
+  {
+    port_t const group = boost::lexical_cast<port_t>(i);
+
+    add_process(name_replica_prefix + group, type_, conf);
+
+    groups.push_back(group);
+  }
+
+  bool status_used = false;
+
+  BOOST_FOREACH (port_t const& input, inputs)
+  {
+    port_t const status_port = "status/" + input;
+
+    // The status ports must be connected before any of the other ports for
+    // the tag exist.
+    if (!status_used && !outputs.empty())
+    {
+      BOOST_FOREACH (port_t const& output, outputs)
+      {
+        connect(name_distribute, status_port,
+                name_collate, "status/" + output);
+      }
+
+      status_used = true;
+    }
+    else
+    {
+      name_t const drop_name = name_drop_prefix + input;
+
+      add_process(drop_name, type_sink);
+
+      connect(name_distribute, status_port,
+              drop_name, port_sink);
+    }
+
+    BOOST_FOREACH (port_t const& group, groups)
+    {
+      connect(name_distribute, "dist/" + input + "/" + group,
+              name_replica_prefix + group, input);
+    }
+
+    map_input(input, name_distribute, "src/" + input);
+  }
+
+  BOOST_FOREACH (port_t const& output, outputs)
+  {
+    BOOST_FOREACH (port_t const& group, groups)
+    {
+      connect(name_replica_prefix + group, output,
+              name_collate, "coll/" + output + "/" + group);
+    }
+
+    map_output(output, name_collate, "res/" + output);
+  }
+}
+
+replica_cluster
+::~replica_cluster()
+{
+}
+
+config_t
+replica_cluster
+::cluster_config(name_t const& name_, type_t const& type_)
+{
+  config_t const conf = config::empty_config();
+
+  conf->set_value(config_name, name_);
+  conf->set_value(config_type, type_);
+
+  return conf;
+}
+
+}
+
 }
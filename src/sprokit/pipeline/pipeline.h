@@ -53,6 +53,13 @@ namespace sprokit
  *
  * \brief A collection of interconnected \link process processes\endlink.
  *
+ * \configs
+ *
+ * \config{_memory_budget} The amount of memory all of the edges in the
+ *                         pipeline may hold together. A setting of \c 0 means
+ *                         unbounded. See \ref edge::set_memory_budget; edges
+ *                         using \key{lock_free} may not be given a budget.
+ *
  * \ingroup base_classes
  */
 class SPROKIT_PIPELINE_EXPORT pipeline
@@ -216,6 +223,7 @@ class SPROKIT_PIPELINE_EXPORT pipeline
      * \throws connection_dependent_type_exception Thrown when a connection creates a port type problem in the pipeline.
      * \throws connection_dependent_type_cascade_exception Thrown when a data-dependent port type creates a problem in the pipeline.
      * \throws untyped_data_dependent_exception Thrown when there are untyped connections left in the pipeline.
+     * \throws lock_free_memory_limit_exception Thrown when an edge using \key{lock_free} would share the memory budget of the pipeline.
      */
     void setup_pipeline();
 
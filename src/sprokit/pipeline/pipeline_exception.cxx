@@ -134,6 +134,27 @@ duplicate_process_name_exception
 {
 }
 
+invalid_replication_exception
+::invalid_replication_exception(process::name_t const& name, size_t replicas, std::string const& reason) SPROKIT_NOTHROW
+  : pipeline_addition_exception()
+  , m_name(name)
+  , m_replicas(replicas)
+  , m_reason(reason)
+{
+  std::ostringstream sstr;
+
+  sstr << "The process named \'" << m_name << "\' "
+          "cannot be run as " << m_replicas << " replicas: "
+       << m_reason;
+
+  m_what = sstr.str();
+}
+
+invalid_replication_exception
+::~invalid_replication_exception() SPROKIT_NOTHROW
+{
+}
+
 pipeline_removal_exception
 ::pipeline_removal_exception() SPROKIT_NOTHROW
   : pipeline_exception()
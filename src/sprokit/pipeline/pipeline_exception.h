@@ -36,6 +36,10 @@
 #include "process.h"
 #include "types.h"
 
+#include <string>
+
+#include <cstddef>
+
 /**
  * \file pipeline_exception.h
  *
@@ -160,6 +164,38 @@ class SPROKIT_PIPELINE_EXPORT duplicate_process_name_exception
     process::name_t const m_name;
 };
 
+/**
+ * \class invalid_replication_exception pipeline_exception.h <sprokit/pipeline/pipeline_exception.h>
+ *
+ * \brief Thrown when a \ref process which cannot be replicated asks for replicas.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT invalid_replication_exception
+  : public pipeline_addition_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param name The name of the process.
+     * \param replicas The number of replicas requested.
+     * \param reason The reason the process cannot be replicated.
+     */
+    invalid_replication_exception(process::name_t const& name, size_t replicas, std::string const& reason) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~invalid_replication_exception() throw();
+
+    /// The name of the process.
+    process::name_t const m_name;
+    /// The number of replicas requested.
+    size_t const m_replicas;
+    /// The reason the process cannot be replicated.
+    std::string const m_reason;
+};
+
 /**
  * \class pipeline_removal_exception pipeline_exception.h <sprokit/pipeline/pipeline_exception.h>
  *
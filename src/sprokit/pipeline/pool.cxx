@@ -0,0 +1,337 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "pool.h"
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+/**
+ * \file pool.cxx
+ *
+ * \brief Implementation of the small object pool.
+ */
+
+#if defined(_MSC_VER)
+#define POOL_THREAD_LOCAL __declspec(thread)
+#else
+#define POOL_THREAD_LOCAL __thread
+#endif
+
+namespace sprokit
+{
+
+namespace
+{
+
+// Blocks are grouped into size classes of this granularity.
+static size_t const class_granularity = 16;
+// Larger requests go straight to the system allocator.
+static size_t const max_pooled_size = 256;
+static size_t const num_classes = max_pooled_size / class_granularity;
+
+// A thread keeps at most this many free blocks per class before handing a
+// batch back to the depot.
+static size_t const max_cached_blocks = 512;
+// The number of blocks moved between a thread cache and the depot at once.
+static size_t const batch_size = 128;
+
+class free_block
+{
+  public:
+    free_block* next;
+};
+
+class free_list
+{
+  public:
+    free_list();
+    ~free_list();
+
+    void push(free_block* block);
+    free_block* pop();
+
+    void splice(free_list& other, size_t count);
+
+    free_block* head;
+    size_t count;
+};
+
+class depot
+{
+  public:
+    depot();
+
+    void refill(size_t cls, free_list& list);
+    void drain(size_t cls, free_list& list, size_t count);
+
+    static depot& self();
+  private:
+    free_list m_lists[num_classes];
+
+    boost::mutex m_mut;
+};
+
+class thread_cache
+{
+  public:
+    thread_cache();
+    ~thread_cache();
+
+    void* allocate(size_t cls);
+    void deallocate(void* ptr, size_t cls);
+
+    static thread_cache& self();
+  private:
+    free_list m_lists[num_classes];
+};
+
+}
+
+static size_t class_for_size(size_t size);
+static size_t size_for_class(size_t cls);
+
+static POOL_THREAD_LOCAL thread_cache* current_cache = NULL;
+
+void*
+pool_allocate(size_t size)
+{
+  if (!size || (max_pooled_size < size))
+  {
+    return ::operator new(size);
+  }
+
+  return thread_cache::self().allocate(class_for_size(size));
+}
+
+void
+pool_deallocate(void* ptr, size_t size)
+{
+  if (!ptr)
+  {
+    return;
+  }
+
+  if (!size || (max_pooled_size < size))
+  {
+    ::operator delete(ptr);
+
+    return;
+  }
+
+  thread_cache::self().deallocate(ptr, class_for_size(size));
+}
+
+free_list
+::free_list()
+  : head(NULL)
+  , count(0)
+{
+}
+
+free_list
+::~free_list()
+{
+}
+
+void
+free_list
+::push(free_block* block)
+{
+  block->next = head;
+  head = block;
+  ++count;
+}
+
+free_block*
+free_list
+::pop()
+{
+  free_block* const block = head;
+
+  if (block)
+  {
+    head = block->next;
+    --count;
+  }
+
+  return block;
+}
+
+void
+free_list
+::splice(free_list& other, size_t count_)
+{
+  // Moves up to count_ blocks from the front of other to the front of this.
+  for (size_t i = 0; (i < count_) && other.head; ++i)
+  {
+    push(other.pop());
+  }
+}
+
+depot
+::depot()
+  : m_lists()
+  , m_mut()
+{
+}
+
+void
+depot
+::refill(size_t cls, free_list& list)
+{
+  boost::mutex::scoped_lock const lock(m_mut);
+
+  (void)lock;
+
+  list.splice(m_lists[cls], batch_size);
+}
+
+void
+depot
+::drain(size_t cls, free_list& list, size_t count)
+{
+  boost::mutex::scoped_lock const lock(m_mut);
+
+  (void)lock;
+
+  m_lists[cls].splice(list, count);
+}
+
+depot&
+depot
+::self()
+{
+  // Intentionally leaked so that threads which exit during static destruction
+  // still have somewhere to return their blocks to.
+  static depot* const dep = new depot;
+
+  return *dep;
+}
+
+static void destroy_cache(thread_cache* cache);
+
+thread_cache
+::thread_cache()
+  : m_lists()
+{
+}
+
+thread_cache
+::~thread_cache()
+{
+  depot& dep = depot::self();
+
+  for (size_t cls = 0; cls < num_classes; ++cls)
+  {
+    free_list& list = m_lists[cls];
+
+    dep.drain(cls, list, list.count);
+  }
+}
+
+void*
+thread_cache
+::allocate(size_t cls)
+{
+  free_list& list = m_lists[cls];
+
+  if (!list.head)
+  {
+    depot::self().refill(cls, list);
+  }
+
+  free_block* const block = list.pop();
+
+  if (block)
+  {
+    return block;
+  }
+
+  return ::operator new(size_for_class(cls));
+}
+
+void
+thread_cache
+::deallocate(void* ptr, size_t cls)
+{
+  free_list& list = m_lists[cls];
+
+  list.push(static_cast<free_block*>(ptr));
+
+  if (max_cached_blocks < list.count)
+  {
+    depot::self().drain(cls, list, batch_size);
+  }
+}
+
+thread_cache&
+thread_cache
+::self()
+{
+  if (!current_cache)
+  {
+    // The thread_specific_ptr is only used to clean up when the thread exits;
+    // lookups go through the (much cheaper) native thread-local pointer.
+    static boost::thread_specific_ptr<thread_cache>* const caches =
+      new boost::thread_specific_ptr<thread_cache>(destroy_cache);
+
+    current_cache = new thread_cache;
+    caches->reset(current_cache);
+  }
+
+  return *current_cache;
+}
+
+void
+destroy_cache(thread_cache* cache)
+{
+  if (current_cache == cache)
+  {
+    current_cache = NULL;
+  }
+
+  delete cache;
+}
+
+size_t
+class_for_size(size_t size)
+{
+  return ((size - 1) / class_granularity);
+}
+
+size_t
+size_for_class(size_t cls)
+{
+  return ((cls + 1) * class_granularity);
+}
+
+}
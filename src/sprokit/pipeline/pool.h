@@ -0,0 +1,183 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_POOL_H
+#define SPROKIT_PIPELINE_POOL_H
+
+#include "pipeline-config.h"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+/**
+ * \file pool.h
+ *
+ * \brief Header for the small object pool used for pipeline bookkeeping.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \brief Allocate a small block of memory.
+ *
+ * Blocks are recycled through a per-thread cache which is refilled from (and
+ * drained to) a shared depot in batches, so steady-state allocation does not
+ * touch the system allocator. Blocks may be freed from any thread.
+ *
+ * \param size The size of the block.
+ *
+ * \returns A block of at least \p size bytes.
+ */
+SPROKIT_PIPELINE_NO_EXPORT void* pool_allocate(size_t size);
+
+/**
+ * \brief Return a block to the pool.
+ *
+ * \param ptr The block to free.
+ * \param size The size which was requested when allocating \p ptr.
+ */
+SPROKIT_PIPELINE_NO_EXPORT void pool_deallocate(void* ptr, size_t size);
+
+/**
+ * \class pool_allocator pool.h "pool.h"
+ *
+ * \brief An allocator which uses the small object pool.
+ *
+ * This is meant for use as the control block allocator for \c shared_ptr.
+ */
+template <typename T>
+class pool_allocator
+{
+  public:
+    /// The type of allocated values.
+    typedef T value_type;
+    /// The type of a pointer to allocated values.
+    typedef T* pointer;
+    /// The type of a const pointer to allocated values.
+    typedef T const* const_pointer;
+    /// The type of a reference to allocated values.
+    typedef T& reference;
+    /// The type of a const reference to allocated values.
+    typedef T const& const_reference;
+    /// The type for sizes.
+    typedef size_t size_type;
+    /// The type for pointer differences.
+    typedef ptrdiff_t difference_type;
+
+    /// The allocator for another type.
+    template <typename U>
+    struct rebind
+    {
+      /// The rebound allocator type.
+      typedef pool_allocator<U> other;
+    };
+
+    pool_allocator() throw()
+    {
+    }
+
+    template <typename U>
+    pool_allocator(pool_allocator<U> const& /*other*/) throw()
+    {
+    }
+
+    pointer address(reference x) const
+    {
+      return &x;
+    }
+
+    const_pointer address(const_reference x) const
+    {
+      return &x;
+    }
+
+    pointer allocate(size_type n, void const* /*hint*/ = 0)
+    {
+      return static_cast<pointer>(pool_allocate(n * sizeof(T)));
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+      pool_deallocate(p, n * sizeof(T));
+    }
+
+    size_type max_size() const throw()
+    {
+      return (std::numeric_limits<size_type>::max() / sizeof(T));
+    }
+
+    void construct(pointer p, const_reference val)
+    {
+      new (p) T(val);
+    }
+
+    void destroy(pointer p)
+    {
+      p->~T();
+    }
+};
+
+template <typename T, typename U>
+inline
+bool
+operator == (pool_allocator<T> const& /*a*/, pool_allocator<U> const& /*b*/)
+{
+  return true;
+}
+
+template <typename T, typename U>
+inline
+bool
+operator != (pool_allocator<T> const& /*a*/, pool_allocator<U> const& /*b*/)
+{
+  return false;
+}
+
+/**
+ * \class pool_deleter pool.h "pool.h"
+ *
+ * \brief Destroys an object which was constructed in a block from the pool.
+ */
+template <typename T>
+class pool_deleter
+{
+  public:
+    void operator () (T const* p) const
+    {
+      p->~T();
+      pool_deallocate(const_cast<T*>(p), sizeof(T));
+    }
+};
+
+}
+
+#endif // SPROKIT_PIPELINE_POOL_H
@@ -34,21 +34,30 @@
 #include "config.h"
 #include "datum.h"
 #include "edge.h"
+#include "edge_exception.h"
+#include "instrumentation.h"
 #include "stamp.h"
+#include "statistics.h"
 #include "types.h"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/assign/ptr_map_inserter.hpp>
 #include <boost/ptr_container/ptr_map.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/tss.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <utility>
+#include <vector>
 
 /**
  * \file process.cxx
@@ -63,9 +72,11 @@ process::property_t const process::property_no_threads = property_t("_no_thread"
 process::property_t const process::property_no_reentrancy = property_t("_no_reentrant");
 process::property_t const process::property_unsync_input = property_t("_unsync_input");
 process::property_t const process::property_unsync_output = property_t("_unsync_output");
+process::property_t const process::property_replicable = property_t("_replicable");
 process::port_t const process::port_heartbeat = port_t("_heartbeat");
 config::key_t const process::config_name = config::key_t("_name");
 config::key_t const process::config_type = config::key_t("_type");
+config::key_t const process::config_replicas = config::key_t("_replicas");
 process::port_type_t const process::type_any = port_type_t("_any");
 process::port_type_t const process::type_none = port_type_t("_none");
 process::port_type_t const process::type_data_dependent = port_type_t("_data_dependent");
@@ -123,6 +134,32 @@ process::data_info
 {
 }
 
+process::port_handle
+::port_handle()
+  : index(size_t(-1))
+  , output(false)
+{
+}
+
+process::port_handle
+::port_handle(size_t index_, bool output_)
+  : index(index_)
+  , output(output_)
+{
+}
+
+process::port_handle
+::~port_handle()
+{
+}
+
+bool
+process::port_handle
+::is_valid() const
+{
+  return (index != size_t(-1));
+}
+
 class process::priv
 {
   public:
@@ -134,9 +171,85 @@ class process::priv
     void connect_output_port(port_t const& port, edge_t const& edge);
 
     datum_t check_required_input();
+    bool skip_dropped_inputs(stamp_t& oldest);
+    bool inputs_available() const;
+    bool outputs_have_space() const;
     void grab_from_input_edges();
-    void push_to_output_edges(datum_t const& dat) const;
+    void push_to_output_edges(datum_t const& dat);
+    void push_copies_to_port(port_t const& port, datum_t const& dat, frequency_component_t count);
+    stamp_t next_output_stamp(port_t const& port);
     bool required_outputs_done() const;
+    void record_step(bool ran, statistic_t wall_ns, statistic_t cpu_ns);
+    void run_step(statistic_t& wall_ns, statistic_t& cpu_ns);
+    void finish_step(bool complete, bool ran, statistic_t wall_ns, statistic_t cpu_ns);
+
+    // Data grabbed for and pushed by a step running concurrently with others.
+    class staged_step
+    {
+      public:
+        staged_step();
+        ~staged_step();
+
+        class output_t
+        {
+          public:
+            output_t(port_t const& port_, edge_datum_t const& edat_, bool stamped_);
+            ~output_t();
+
+            port_t port;
+            edge_datum_t edat;
+            bool stamped;
+        };
+        typedef std::vector<output_t> outputs_t;
+        typedef std::map<port_t, edge_datum_t> inputs_t;
+
+        bool peek(port_t const& port, edge_datum_t& edat) const;
+        bool grab(port_t const& port, edge_datum_t& edat);
+
+        size_t ticket;
+        datum_t status;
+        inputs_t inputs;
+        outputs_t outputs;
+    };
+
+    // Holds a step's place in line for pushing its outputs and the space
+    // reserved for them on the output edges.
+    class commit_turn
+    {
+      public:
+        commit_turn(priv* d_, size_t ticket_, bool reserved_);
+        ~commit_turn();
+
+        void wait();
+      private:
+        priv* const d;
+        size_t const ticket;
+        bool const reserved;
+        bool waited;
+    };
+
+    bool can_step_reentrantly() const;
+    bool reentrant_step(bool only_if_ready);
+    staged_step* current_step() const;
+
+    static void release_staged_step(staged_step* step);
+
+    static stamp_t advance_stamp(stamp_t& port_stamp);
+
+    // Accumulates what edge_data_info computes without building a list of
+    // the data first.
+    class data_summary
+    {
+      public:
+        data_summary();
+        ~data_summary();
+
+        void add(edge_datum_t const& edat);
+
+        bool in_sync;
+        datum::type_t max_status;
+        stamp_t first_stamp;
+    };
 
     name_t name;
     type_t type;
@@ -174,6 +287,45 @@ class process::priv
 
     typedef boost::ptr_map<port_t, mutex_t> output_mutex_map_t;
 
+    class input_handle_info_t
+    {
+      public:
+        input_handle_info_t(port_t const& port_, edge_t const& edge_);
+        ~input_handle_info_t();
+
+        port_t port;
+        edge_t edge;
+    };
+
+    class output_handle_info_t
+    {
+      public:
+        output_handle_info_t(port_t const& port_, output_port_info_t* info_, mutex_t* mut_);
+        ~output_handle_info_t();
+
+        port_t port;
+        output_port_info_t* info;
+        mutex_t* mut;
+    };
+
+    typedef std::vector<input_handle_info_t> input_handles_t;
+    typedef std::vector<output_handle_info_t> output_handles_t;
+
+    input_handle_info_t const& input_handle(port_handle const& handle) const;
+    output_handle_info_t const& output_handle(port_handle const& handle) const;
+
+    // The data path once a port name or handle has been resolved.
+    edge_t const* input_edge(port_t const& port) const;
+    edge_datum_t peek_input(port_t const& port, edge_t const* edge, size_t idx) const;
+    edge_datum_t grab_input(port_t const& port, edge_t const* edge) const;
+    bool stage_output(port_t const& port, edge_datum_t const& edat, bool stamped) const;
+    static void push_to_edges(mutex_t& mut, output_port_info_t const* info, edge_datum_t const& edat);
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+    static void push_to_edges(mutex_t& mut, output_port_info_t const* info, edge_datum_t&& edat);
+#endif
+    stamp_t next_output_stamp(output_handle_info_t const& handle) const;
+    void refresh_output_handles(port_t const& port, output_port_info_t& info);
+
     typedef port_t tag_t;
 
     typedef boost::optional<port_type_t> flow_tag_port_type_t;
@@ -200,6 +352,9 @@ class process::priv
     mutable output_mutex_map_t output_mutexes;
     mutable mutex_t output_edges_mut;
 
+    input_handles_t input_handles;
+    output_handles_t output_handles;
+
     process* const q;
     config_t conf;
 
@@ -222,13 +377,39 @@ class process::priv
     bool initialized;
     bool output_stamps_made;
     bool is_complete;
+    bool heartbeat_connected;
+
+    step_callback_t step_callback;
 
     data_check_t check_input_level;
 
     stamp_t stamp_for_inputs;
 
+    // Scratch space for peeking at inputs; kept to avoid allocating per step.
+    edge_data_t peeked_data;
+    // Inputs whose data for the current stamp was dropped by their edge.
+    port_set_t dropped_inputs;
+
+    bool reentrant;
+    // Serializes taking inputs for reentrant steps.
+    boost::mutex stage_mut;
+    bool stage_complete;
+    size_t next_ticket;
+    // Steps which have taken their inputs but not yet pushed their outputs.
+    size_t staged_steps;
+    // Reentrant steps push their outputs in the order they took their inputs.
+    boost::mutex commit_mut;
+    boost::condition_variable commit_cond;
+    size_t commit_ticket;
+    boost::thread_specific_ptr<staged_step> staged;
+
     mutex_t reconfigure_mut;
 
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+    mutable boost::mutex statistics_mut;
+    process_statistics stats;
+#endif
+
     static config::value_t const default_name;
 };
 
@@ -269,6 +450,7 @@ ::init()
 
   _init();
 
+  d->reentrant = d->can_step_reentrantly();
   d->initialized = true;
 }
 
@@ -293,11 +475,19 @@ ::step()
     throw uninitialized_exception(d->name);
   }
 
-  /// \todo Make reentrant.
+  if (d->reentrant)
+  {
+    d->reentrant_step(false);
+
+    return;
+  }
 
   /// \todo Are there any pre-_step actions?
 
   bool complete = false;
+  bool ran = false;
+  statistic_t wall_ns = 0;
+  statistic_t cpu_ns = 0;
 
   if (d->is_complete)
   {
@@ -317,28 +507,135 @@ ::step()
     }
     else
     {
-      // We don't want to reconfigure while the subclass is running. Since the
-      // base class shouldn't be messed with while configuring, we only need to
-      // lock around the base class _step method call.
-      priv::shared_lock_t const lock(d->reconfigure_mut);
+      d->run_step(wall_ns, cpu_ns);
+      ran = true;
+    }
 
-      (void)lock;
+    d->stamp_for_inputs = stamp_t();
+  }
+
+  d->finish_step(complete, ran, wall_ns, cpu_ns);
+}
+
+bool
+process
+::ready() const
+{
+  if (!d->configured)
+  {
+    throw unconfigured_exception(d->name);
+  }
+
+  if (!d->initialized || !d->output_stamps_made)
+  {
+    throw uninitialized_exception(d->name);
+  }
+
+  if (d->is_complete)
+  {
+    return true;
+  }
+
+  if (!d->reentrant)
+  {
+    return (d->inputs_available() && d->outputs_have_space());
+  }
+
+  // Other steps may be taking inputs right now.
+  boost::mutex::scoped_lock const lock(d->stage_mut);
+
+  (void)lock;
+
+  return (d->inputs_available() && d->outputs_have_space());
+}
 
-      _step();
+bool
+process
+::try_step()
+{
+  if (d->reentrant)
+  {
+    if (!d->output_stamps_made)
+    {
+      throw uninitialized_exception(d->name);
     }
 
-    d->stamp_for_inputs = stamp_t();
+    // Readiness must be checked while no other step is taking its inputs.
+    return d->reentrant_step(true);
+  }
+
+  if (!ready())
+  {
+    return false;
   }
 
-  /// \todo Are there any post-_step actions?
+  step();
 
-  d->run_heartbeat();
+  return true;
+}
 
-  /// \todo Should this really be done here?
-  if (complete || d->required_outputs_done())
+bool
+process
+::is_reentrant() const
+{
+  return d->reentrant;
+}
+
+void
+process
+::set_step_callback(step_callback_t const& callback)
+{
+  d->step_callback = callback;
+}
+
+process_statistics
+process
+::statistics() const
+{
+  process_statistics stats;
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  {
+    boost::mutex::scoped_lock const lock(d->statistics_mut);
+
+    (void)lock;
+
+    stats = d->stats;
+  }
+
+  for (priv::input_edge_map_t::const_iterator i = d->input_edges.begin(); i != d->input_edges.end(); ++i)
+  {
+    priv::input_port_info_t const& info = *i->second;
+    edge_statistics const edge_stats = info.edge->statistics();
+
+    stats.grab_blocked_ns += edge_stats.grab_blocked_ns;
+  }
+
+  priv::shared_lock_t const lock(d->output_edges_mut);
+
+  (void)lock;
+
+  for (priv::output_edge_map_t::const_iterator i = d->output_edges.begin(); i != d->output_edges.end(); ++i)
   {
-    mark_process_as_complete();
+    priv::output_port_info_t const& info = *i->second;
+
+    BOOST_FOREACH (edge_t const& edge, info.edges)
+    {
+      edge_statistics const edge_stats = edge->statistics();
+
+      stats.push_blocked_ns += edge_stats.push_blocked_ns;
+    }
   }
+#endif
+
+  return stats;
+}
+
+bool
+process
+::is_complete() const
+{
+  return d->is_complete;
 }
 
 process::properties_t
@@ -539,6 +836,11 @@ ::process(config_t const& config)
     config_type,
     config::value_t(),
     config::description_t("The type of the process."));
+  declare_configuration_key(
+    config_replicas,
+    config::value_t("1"),
+    config::description_t("The number of copies of the process to run. Only "
+                          "processes which are replicable may use more than one."));
 
   d->name = config_value<name_t>(config_name);
   d->type = config_value<type_t>(config_type);
@@ -572,6 +874,8 @@ void
 process
 ::_reset()
 {
+  d->input_handles.clear();
+  d->output_handles.clear();
   d->input_edges.clear();
 
   {
@@ -580,6 +884,7 @@ ::_reset()
     (void)lock;
 
     d->output_edges.clear();
+    d->heartbeat_connected = false;
   }
 
   d->configured = false;
@@ -685,7 +990,8 @@ ::_set_input_port_type(port_t const& port, port_type_t const& new_type)
 
     if (!tag.empty())
     {
-      ports_t const& iports = d->input_flow_tag_ports[tag];
+      // Copies since querying port information may declare new ports.
+      ports_t const iports = d->input_flow_tag_ports[tag];
 
       BOOST_FOREACH (port_t const& iport, iports)
       {
@@ -699,7 +1005,7 @@ ::_set_input_port_type(port_t const& port, port_type_t const& new_type)
           iport_info->frequency);
       }
 
-      ports_t const& oports = d->output_flow_tag_ports[tag];
+      ports_t const oports = d->output_flow_tag_ports[tag];
 
       BOOST_FOREACH (port_t const& oport, oports)
       {
@@ -756,7 +1062,8 @@ ::_set_output_port_type(port_t const& port, port_type_t const& new_type)
 
     if (!tag.empty())
     {
-      ports_t const& iports = d->input_flow_tag_ports[tag];
+      // Copies since querying port information may declare new ports.
+      ports_t const iports = d->input_flow_tag_ports[tag];
 
       BOOST_FOREACH (port_t const& iport, iports)
       {
@@ -770,7 +1077,7 @@ ::_set_output_port_type(port_t const& port, port_type_t const& new_type)
           iport_info->frequency);
       }
 
-      ports_t const& oports = d->output_flow_tag_ports[tag];
+      ports_t const oports = d->output_flow_tag_ports[tag];
 
       BOOST_FOREACH (port_t const& oport, oports)
       {
@@ -1158,6 +1465,28 @@ ::has_input_port_edge(port_t const& port) const
   return (0 != d->input_edges.count(port));
 }
 
+size_t
+process
+::input_port_datum_count(port_t const& port) const
+{
+  if (!d->input_ports.count(port))
+  {
+    throw no_such_port_exception(d->name, port);
+  }
+
+  priv::input_edge_map_t::const_iterator const e = d->input_edges.find(port);
+
+  if (e == d->input_edges.end())
+  {
+    return size_t(0);
+  }
+
+  priv::input_port_info_t const& info = *e->second;
+  edge_t const& edge = info.edge;
+
+  return edge->datum_count();
+}
+
 size_t
 process
 ::count_output_port_edges(port_t const& port) const
@@ -1191,28 +1520,56 @@ ::count_output_port_edges(port_t const& port) const
   return edges.size();
 }
 
-edge_datum_t
+size_t
 process
-::peek_at_port(port_t const& port, size_t idx) const
+::output_port_free_space(port_t const& port) const
 {
-  if (!d->input_ports.count(port))
+  if (!d->output_ports.count(port))
   {
     throw no_such_port_exception(d->name, port);
   }
 
-  priv::input_edge_map_t::const_iterator const e = d->input_edges.find(port);
+  priv::shared_lock_t lock(d->output_edges_mut);
 
-  if (e == d->input_edges.end())
+  (void)lock;
+
+  size_t space = std::numeric_limits<size_t>::max();
+
+  priv::output_edge_map_t::const_iterator const e = d->output_edges.find(port);
+
+  if (e == d->output_edges.end())
   {
-    static std::string const reason = "Data was requested from the port";
+    return space;
+  }
+
+  priv::mutex_t& mut = d->output_mutexes[port];
+
+  priv::shared_lock_t const port_lock(mut);
+
+  (void)port_lock;
+
+  priv::output_port_info_t const& info = *e->second;
+
+  edges_t const& edges = info.edges;
+
+  BOOST_FOREACH (edge_t const& edge, edges)
+  {
+    size_t const capacity = edge->capacity();
+    size_t const count = edge->datum_count();
+    size_t const limit = (capacity ? capacity : std::numeric_limits<size_t>::max());
+    size_t const edge_space = ((count < limit) ? (limit - count) : 0);
 
-    throw missing_connection_exception(d->name, port, reason);
+    space = std::min(space, edge_space);
   }
 
-  priv::input_port_info_t const& info = *e->second;
-  edge_t const& edge = info.edge;
+  return space;
+}
 
-  return edge->peek_datum(idx);
+edge_datum_t
+process
+::peek_at_port(port_t const& port, size_t idx) const
+{
+  return d->peek_input(port, d->input_edge(port), idx);
 }
 
 datum_t
@@ -1228,24 +1585,7 @@ edge_datum_t
 process
 ::grab_from_port(port_t const& port) const
 {
-  if (!d->input_ports.count(port))
-  {
-    throw no_such_port_exception(d->name, port);
-  }
-
-  priv::input_edge_map_t::const_iterator const e = d->input_edges.find(port);
-
-  if (e == d->input_edges.end())
-  {
-    static std::string const reason = "Data was requested from the port";
-
-    throw missing_connection_exception(d->name, port, reason);
-  }
-
-  priv::input_port_info_t const& info = *e->second;
-  edge_t const& edge = info.edge;
-
-  return edge->get_datum();
+  return d->grab_input(port, d->input_edge(port));
 }
 
 datum_t
@@ -1266,7 +1606,12 @@ ::push_to_port(port_t const& port, edge_datum_t const& dat) const
     throw no_such_port_exception(d->name, port);
   }
 
-  priv::shared_lock_t lock(d->output_edges_mut);
+  if (d->stage_output(port, dat, true))
+  {
+    return;
+  }
+
+  priv::shared_lock_t const lock(d->output_edges_mut);
 
   (void)lock;
 
@@ -1277,21 +1622,38 @@ ::push_to_port(port_t const& port, edge_datum_t const& dat) const
     return;
   }
 
-  priv::mutex_t& mut = d->output_mutexes[port];
+  priv::push_to_edges(d->output_mutexes[port], e->second, dat);
+}
 
-  priv::shared_lock_t const port_lock(mut);
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+void
+process
+::push_to_port(port_t const& port, edge_datum_t&& dat) const
+{
+  if (!d->output_ports.count(port))
+  {
+    throw no_such_port_exception(d->name, port);
+  }
 
-  (void)port_lock;
+  if (d->stage_output(port, dat, true))
+  {
+    return;
+  }
 
-  priv::output_port_info_t const& info = *e->second;
+  priv::shared_lock_t const lock(d->output_edges_mut);
 
-  edges_t const& edges = info.edges;
+  (void)lock;
 
-  BOOST_FOREACH (edge_t const& edge, edges)
+  priv::output_edge_map_t::const_iterator const e = d->output_edges.find(port);
+
+  if (e == d->output_edges.end())
   {
-    edge->push_datum(dat);
+    return;
   }
+
+  priv::push_to_edges(d->output_mutexes[port], e->second, std::move(dat));
 }
+#endif
 
 void
 process
@@ -1302,46 +1664,240 @@ ::push_datum_to_port(port_t const& port, datum_t const& dat) const
     throw no_such_port_exception(d->name, port);
   }
 
-  stamp_t push_stamp;
-
+  // Stamps are only assigned once it is this step's turn to push.
+  if (d->stage_output(port, edge_datum_t(dat, stamp_t()), false))
   {
-    priv::shared_lock_t lock(d->output_edges_mut);
+    return;
+  }
 
-    (void)lock;
+  stamp_t push_stamp = d->next_output_stamp(port);
 
-    priv::output_edge_map_t::iterator const e = d->output_edges.find(port);
+  if (!push_stamp)
+  {
+    return;
+  }
 
-    if (e == d->output_edges.end())
-    {
-      return;
-    }
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+  push_to_port(port, edge_datum_t(datum_t(dat), std::move(push_stamp)));
+#else
+  push_to_port(port, edge_datum_t(dat, push_stamp));
+#endif
+}
 
-    priv::mutex_t& mut = d->output_mutexes[port];
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+void
+process
+::push_datum_to_port(port_t const& port, datum_t&& dat) const
+{
+  if (!d->output_ports.count(port))
+  {
+    throw no_such_port_exception(d->name, port);
+  }
 
-    priv::upgrade_lock_t port_lock(mut);
+  if (d->stage_output(port, edge_datum_t(dat, stamp_t()), false))
+  {
+    return;
+  }
 
-    priv::output_port_info_t& info = *e->second;
-    stamp_t& port_stamp = info.stamp;
+  stamp_t push_stamp = d->next_output_stamp(port);
 
-    if (!port_stamp)
-    {
-      static std::string const reason = "The stamp for an output port was not initialized";
+  if (!push_stamp)
+  {
+    return;
+  }
 
-      throw std::runtime_error(reason);
-    }
+  push_to_port(port, edge_datum_t(std::move(dat), std::move(push_stamp)));
+}
+#endif
+
+process::port_handle
+process
+::input_port_handle(port_t const& port)
+{
+  if (!d->input_ports.count(port))
+  {
+    throw no_such_port_exception(d->name, port);
+  }
 
+  for (size_t i = 0; i < d->input_handles.size(); ++i)
+  {
+    if (d->input_handles[i].port == port)
     {
-      priv::upgrade_to_unique_lock_t const port_write_lock(port_lock);
+      return port_handle(i, false);
+    }
+  }
+
+  priv::input_edge_map_t::const_iterator const e = d->input_edges.find(port);
 
-      (void)port_write_lock;
+  edge_t edge;
 
-      push_stamp = port_stamp;
-      port_stamp = stamp::incremented_stamp(port_stamp);
+  if (e != d->input_edges.end())
+  {
+    edge = e->second->edge;
+  }
+
+  d->input_handles.push_back(priv::input_handle_info_t(port, edge));
+
+  return port_handle(d->input_handles.size() - 1, false);
+}
+
+process::port_handle
+process
+::output_port_handle(port_t const& port)
+{
+  if (!d->output_ports.count(port))
+  {
+    throw no_such_port_exception(d->name, port);
+  }
+
+  for (size_t i = 0; i < d->output_handles.size(); ++i)
+  {
+    if (d->output_handles[i].port == port)
+    {
+      return port_handle(i, true);
     }
   }
 
-  push_to_port(port, edge_datum_t(dat, push_stamp));
+  priv::unique_lock_t const lock(d->output_edges_mut);
+
+  (void)lock;
+
+  priv::output_edge_map_t::iterator const e = d->output_edges.find(port);
+
+  priv::output_port_info_t* info = NULL;
+  // The mutex is resolved even without edges since connecting to the port
+  // later fills in the handle under it.
+  priv::mutex_t* const mut = &d->output_mutexes[port];
+
+  if (e != d->output_edges.end())
+  {
+    info = e->second;
+  }
+
+  d->output_handles.push_back(priv::output_handle_info_t(port, info, mut));
+
+  return port_handle(d->output_handles.size() - 1, true);
+}
+
+edge_datum_t
+process
+::peek_at_port(port_handle const& handle, size_t idx) const
+{
+  priv::input_handle_info_t const& info = d->input_handle(handle);
+
+  return d->peek_input(info.port, &info.edge, idx);
+}
+
+datum_t
+process
+::peek_at_datum_on_port(port_handle const& handle, size_t idx) const
+{
+  edge_datum_t const edat = peek_at_port(handle, idx);
+
+  return edat.datum;
+}
+
+edge_datum_t
+process
+::grab_from_port(port_handle const& handle) const
+{
+  priv::input_handle_info_t const& info = d->input_handle(handle);
+
+  return d->grab_input(info.port, &info.edge);
+}
+
+datum_t
+process
+::grab_datum_from_port(port_handle const& handle) const
+{
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+  return grab_from_port(handle).datum;
+#else
+  edge_datum_t const edat = grab_from_port(handle);
+
+  return edat.datum;
+#endif
+}
+
+void
+process
+::push_to_port(port_handle const& handle, edge_datum_t const& dat) const
+{
+  priv::output_handle_info_t const& info = d->output_handle(handle);
+
+  if (d->stage_output(info.port, dat, true))
+  {
+    return;
+  }
+
+  // Output ports may gain edges at any time, but connecting updates the
+  // handle under the port lock, so only the port lock is needed here.
+  priv::push_to_edges(*info.mut, info.info, dat);
+}
+
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+void
+process
+::push_to_port(port_handle const& handle, edge_datum_t&& dat) const
+{
+  priv::output_handle_info_t const& info = d->output_handle(handle);
+
+  if (d->stage_output(info.port, dat, true))
+  {
+    return;
+  }
+
+  priv::push_to_edges(*info.mut, info.info, std::move(dat));
+}
+#endif
+
+void
+process
+::push_datum_to_port(port_handle const& handle, datum_t const& dat) const
+{
+  priv::output_handle_info_t const& info = d->output_handle(handle);
+
+  if (d->stage_output(info.port, edge_datum_t(dat, stamp_t()), false))
+  {
+    return;
+  }
+
+  stamp_t push_stamp = d->next_output_stamp(info);
+
+  if (!push_stamp)
+  {
+    return;
+  }
+
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+  push_to_port(handle, edge_datum_t(datum_t(dat), std::move(push_stamp)));
+#else
+  push_to_port(handle, edge_datum_t(dat, push_stamp));
+#endif
+}
+
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+void
+process
+::push_datum_to_port(port_handle const& handle, datum_t&& dat) const
+{
+  priv::output_handle_info_t const& info = d->output_handle(handle);
+
+  if (d->stage_output(info.port, edge_datum_t(dat, stamp_t()), false))
+  {
+    return;
+  }
+
+  stamp_t push_stamp = d->next_output_stamp(info);
+
+  if (!push_stamp)
+  {
+    return;
+  }
+
+  push_to_port(handle, edge_datum_t(std::move(dat), std::move(push_stamp)));
 }
+#endif
 
 config_t
 process
@@ -1361,31 +1917,14 @@ process::data_info_t
 process
 ::edge_data_info(edge_data_t const& data)
 {
-  bool in_sync = true;
-  datum::type_t max_type = datum::data;
-
-  edge_datum_t const& fst = data[0];
-  stamp_t const& st = fst.stamp;
+  priv::data_summary summary;
 
   BOOST_FOREACH (edge_datum_t const& edat, data)
   {
-    datum_t const& dat = edat.datum;
-    stamp_t const& st2 = edat.stamp;
-
-    datum::type_t const type = dat->type();
-
-    if (max_type < type)
-    {
-      max_type = type;
-    }
-
-    if (*st != *st2)
-    {
-      in_sync = false;
-    }
+    summary.add(edat);
   }
 
-  return boost::make_shared<data_info>(in_sync, max_type);
+  return boost::make_shared<data_info>(summary.in_sync, summary.max_status);
 }
 
 config::value_t
@@ -1592,6 +2131,8 @@ ::priv(process* proc, config_t const& c)
   , config_keys()
   , input_edges()
   , output_edges()
+  , input_handles()
+  , output_handles()
   , q(proc)
   , conf(c)
   , static_inputs()
@@ -1607,8 +2148,21 @@ ::priv(process* proc, config_t const& c)
   , initialized(false)
   , output_stamps_made(false)
   , is_complete(false)
+  , heartbeat_connected(false)
+  , step_callback()
   , check_input_level(check_valid)
   , stamp_for_inputs()
+  , peeked_data()
+  , dropped_inputs()
+  , reentrant(false)
+  , stage_mut()
+  , stage_complete(false)
+  , next_ticket(0)
+  , staged_steps(0)
+  , commit_mut()
+  , commit_cond()
+  , commit_ticket(0)
+  , staged(&release_staged_step)
 {
 }
 
@@ -1617,10 +2171,53 @@ process::priv
 {
 }
 
+process::priv::data_summary
+::data_summary()
+  : in_sync(true)
+  , max_status(datum::data)
+  , first_stamp()
+{
+}
+
+process::priv::data_summary
+::~data_summary()
+{
+}
+
+void
+process::priv::data_summary
+::add(edge_datum_t const& edat)
+{
+  datum::type_t const type = edat.datum->type();
+
+  if (max_status < type)
+  {
+    max_status = type;
+  }
+
+  stamp_t const& st = edat.stamp;
+
+  if (!first_stamp)
+  {
+    first_stamp = st;
+  }
+  else if (*first_stamp != *st)
+  {
+    in_sync = false;
+  }
+}
+
 void
 process::priv
 ::run_heartbeat()
 {
+  // Schedulers use the step callback now; only pay for the heartbeat datum
+  // when something is actually listening.
+  if (!heartbeat_connected)
+  {
+    return;
+  }
+
   datum_t dat;
 
   if (is_complete)
@@ -1675,111 +2272,650 @@ ::connect_output_port(port_t const& port, edge_t const& edge)
   edges_t& edges = info.edges;
 
   edges.push_back(edge);
+
+  refresh_output_handles(port, info);
+
+  if (port == port_heartbeat)
+  {
+    heartbeat_connected = true;
+  }
 }
 
-datum_t
+void
 process::priv
-::check_required_input()
+::run_step(statistic_t& wall_ns, statistic_t& cpu_ns)
 {
-  if ((check_input_level == check_none) ||
-      required_inputs.empty())
+  // We don't want to reconfigure while the subclass is running. Since the
+  // base class shouldn't be messed with while configuring, we only need to
+  // lock around the base class _step method call.
+  shared_lock_t const lock(reconfigure_mut);
+
+  (void)lock;
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  statistic_t const wall_start = wall_clock_ns();
+  statistic_t const cpu_start = thread_cpu_ns();
+#endif
+
+  q->_step();
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  wall_ns = wall_clock_ns() - wall_start;
+  cpu_ns = thread_cpu_ns() - cpu_start;
+#else
+  (void)wall_ns;
+  (void)cpu_ns;
+#endif
+}
+
+void
+process::priv
+::finish_step(bool complete, bool ran, statistic_t wall_ns, statistic_t cpu_ns)
+{
+  record_step(ran, wall_ns, cpu_ns);
+
+  run_heartbeat();
+
+  /// \todo Should this really be done here?
+  if (complete || required_outputs_done())
   {
-    return datum_t();
+    q->mark_process_as_complete();
   }
 
-  edge_data_t first_data;
-  edge_data_t data;
-
-  BOOST_FOREACH (port_t const& port, required_inputs)
+  if (step_callback)
   {
-    input_edge_map_t::const_iterator const i = input_edges.find(port);
+    step_callback(is_complete);
+  }
+}
 
-    if (i == input_edges.end())
-    {
-      continue;
-    }
+bool
+process::priv
+::can_step_reentrantly() const
+{
+  properties_t const consts = q->properties();
 
-    input_port_info_t const& info = *i->second;
-    edge_t const& iedge = info.edge;
+  if (consts.count(property_no_reentrancy))
+  {
+    return false;
+  }
 
-    edge_datum_t const first_edat = iedge->peek_datum();
-    datum_t const& first_dat = first_edat.datum;
-    datum::type_t const first_type = first_dat->type();
+  // Processes which pick their own inputs cannot have them taken up front.
+  if (check_input_level == check_none)
+  {
+    return false;
+  }
 
-    first_data.push_back(first_edat);
-    data.push_back(first_edat);
+  // Each step must take exactly one datum from each connected port so that
+  // the inputs can be split between steps before they run.
+  for (input_edge_map_t::const_iterator i = input_edges.begin(); i != input_edges.end(); ++i)
+  {
+    port_t const& port = i->first;
 
-    if ((first_type == datum::flush) ||
-        (first_type == datum::complete))
+    if (!required_inputs.count(port))
     {
-      continue;
+      return false;
     }
 
-    port_info_t const& port_info = q->input_port_info(port);
-    port_frequency_t const& freq = port_info->frequency;
-
-    frequency_component_t const rel_count = freq.numerator();
+    port_map_t::const_iterator const p = input_ports.find(port);
 
-    for (frequency_component_t j = 0; j < rel_count; ++j)
+    if (p == input_ports.end())
     {
-      edge_datum_t const edat = iedge->peek_datum(j);
+      return false;
+    }
 
-      data.push_back(edat);
+    port_frequency_t const& freq = p->second->frequency;
+
+    if (freq != port_frequency_t(1))
+    {
+      return false;
     }
   }
 
-  data_info_t const first_info = edge_data_info(first_data);
+  return true;
+}
+
+bool
+process::priv
+::reentrant_step(bool only_if_ready)
+{
+  staged_step step;
+  bool skip = false;
 
-  if (check_sync <= check_input_level)
   {
-    if (!first_info->in_sync)
+    boost::mutex::scoped_lock const lock(stage_mut);
+
+    (void)lock;
+
+    if (is_complete || stage_complete)
     {
-      static datum::error_t const err_string = datum::error_t("Required input edges are not synchronized.");
+      skip = true;
+    }
+    else
+    {
+      if (only_if_ready && !(inputs_available() && outputs_have_space()))
+      {
+        return false;
+      }
 
-      return datum::error_datum(err_string);
+      try
+      {
+        step.status = check_required_input();
+
+        if (step.status)
+        {
+          grab_from_input_edges();
+
+          stage_complete = (step.status->type() == datum::complete);
+        }
+        else
+        {
+          for (input_edge_map_t::const_iterator i = input_edges.begin(); i != input_edges.end(); ++i)
+          {
+            input_port_info_t const& info = *i->second;
+
+            step.inputs[i->first] = info.edge->get_datum();
+          }
+        }
+      }
+      catch (datum_requested_after_complete const&)
+      {
+        // Another step marked the process as complete while waiting for data.
+        stage_complete = true;
+        skip = true;
+      }
+
+      stamp_for_inputs = stamp_t();
     }
 
-    // Save the stamp for the inputs.
-    edge_datum_t const& edat = first_data[0];
-    stamp_for_inputs = edat.stamp;
-  }
+    if (!skip)
+    {
+      ++staged_steps;
+    }
 
-  if (check_input_level < check_valid)
-  {
-    return datum_t();
+    step.ticket = next_ticket++;
   }
 
-  data_info_t const info = edge_data_info(data);
+  commit_turn turn(this, step.ticket, !skip);
+
+  bool ran = false;
+  statistic_t wall_ns = 0;
+  statistic_t cpu_ns = 0;
 
-  switch (info->max_status)
+  if (!skip && !step.status)
   {
-    case datum::data:
-      break;
-    case datum::empty:
-      return datum::empty_datum();
-    case datum::flush:
-      q->_flush();
-      return datum::flush_datum();
-    case datum::complete:
-      return datum::complete_datum();
-    case datum::error:
-    {
-      static datum::error_t const err_string = datum::error_t("Error in a required input edge.");
+    staged.reset(&step);
 
-      return datum::error_datum(err_string);
+    try
+    {
+      run_step(wall_ns, cpu_ns);
     }
-    case datum::invalid:
-    default:
+    catch (...)
     {
-      static datum::error_t const err_string = datum::error_t("Unrecognized datum type in a required input edge.");
+      staged.release();
 
-      return datum::error_datum(err_string);
+      throw;
+    }
+
+    staged.release();
+
+    ran = true;
+  }
+
+  turn.wait();
+
+  bool complete = false;
+
+  if (step.status)
+  {
+    push_to_output_edges(step.status);
+
+    complete = (step.status->type() == datum::complete);
+  }
+
+  BOOST_FOREACH (staged_step::output_t const& output, step.outputs)
+  {
+    if (output.stamped)
+    {
+      q->push_to_port(output.port, output.edat);
+    }
+    else
+    {
+      q->push_datum_to_port(output.port, output.edat.datum);
+    }
+  }
+
+  finish_step(complete, ran, wall_ns, cpu_ns);
+
+  return true;
+}
+
+process::priv::staged_step*
+process::priv
+::current_step() const
+{
+  if (!reentrant)
+  {
+    return NULL;
+  }
+
+  return staged.get();
+}
+
+void
+process::priv
+::release_staged_step(staged_step* /*step*/)
+{
+  // Staged steps live on the stack of the step which owns them.
+}
+
+process::priv::staged_step
+::staged_step()
+  : ticket(0)
+  , status()
+  , inputs()
+  , outputs()
+{
+}
+
+process::priv::staged_step
+::~staged_step()
+{
+}
+
+bool
+process::priv::staged_step
+::peek(port_t const& port, edge_datum_t& edat) const
+{
+  inputs_t::const_iterator const i = inputs.find(port);
+
+  if (i == inputs.end())
+  {
+    return false;
+  }
+
+  edat = i->second;
+
+  return true;
+}
+
+bool
+process::priv::staged_step
+::grab(port_t const& port, edge_datum_t& edat)
+{
+  inputs_t::iterator const i = inputs.find(port);
+
+  if (i == inputs.end())
+  {
+    return false;
+  }
+
+  edat = i->second;
+  inputs.erase(i);
+
+  return true;
+}
+
+process::priv::staged_step::output_t
+::output_t(port_t const& port_, edge_datum_t const& edat_, bool stamped_)
+  : port(port_)
+  , edat(edat_)
+  , stamped(stamped_)
+{
+}
+
+process::priv::staged_step::output_t
+::~output_t()
+{
+}
+
+process::priv::commit_turn
+::commit_turn(priv* d_, size_t ticket_, bool reserved_)
+  : d(d_)
+  , ticket(ticket_)
+  , reserved(reserved_)
+  , waited(false)
+{
+}
+
+process::priv::commit_turn
+::~commit_turn()
+{
+  // Even failed steps must give up their turn or later steps never finish.
+  wait();
+
+  if (reserved)
+  {
+    boost::mutex::scoped_lock const lock(d->stage_mut);
+
+    (void)lock;
+
+    --d->staged_steps;
+  }
+
+  {
+    boost::mutex::scoped_lock const lock(d->commit_mut);
+
+    (void)lock;
+
+    ++d->commit_ticket;
+  }
+
+  d->commit_cond.notify_all();
+}
+
+void
+process::priv::commit_turn
+::wait()
+{
+  if (waited)
+  {
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(d->commit_mut);
+
+  while (d->commit_ticket != ticket)
+  {
+    d->commit_cond.wait(lock);
+  }
+
+  waited = true;
+}
+
+bool
+process::priv
+::inputs_available() const
+{
+  // Processes which do not check their inputs choose which ports to read
+  // from in _step, so there is nothing to predict.
+  if (check_input_level == check_none)
+  {
+    return true;
+  }
+
+  BOOST_FOREACH (port_t const& port, required_inputs)
+  {
+    input_edge_map_t::const_iterator const i = input_edges.find(port);
+
+    if (i == input_edges.end())
+    {
+      continue;
+    }
+
+    input_port_info_t const& info = *i->second;
+    edge_t const& iedge = info.edge;
+
+    if (iedge->is_downstream_complete())
+    {
+      continue;
+    }
+
+    edge_datum_t edat;
+
+    if (!iedge->try_peek_datum(edat))
+    {
+      return false;
+    }
+
+    datum::type_t const dat_type = edat.datum->type();
+
+    // These are passed along on their own regardless of the frequency.
+    if ((dat_type == datum::flush) ||
+        (dat_type == datum::complete))
+    {
+      continue;
+    }
+
+    port_map_t::const_iterator const p = input_ports.find(port);
+
+    if (p == input_ports.end())
+    {
+      continue;
+    }
+
+    port_frequency_t const& freq = p->second->frequency;
+    frequency_component_t const rel_count = freq.numerator();
+
+    if ((1 < rel_count) && !iedge->try_peek_datum(edat, rel_count - 1))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+process::priv
+::outputs_have_space() const
+{
+  // Staged steps have not pushed their outputs yet, so leave room for them
+  // as well so that replaying them never blocks.
+  size_t const count = (1 + staged_steps);
+
+  shared_lock_t const lock(output_edges_mut);
+
+  (void)lock;
+
+  for (output_edge_map_t::const_iterator i = output_edges.begin(); i != output_edges.end(); ++i)
+  {
+    mutex_t& mut = output_mutexes[i->first];
+
+    shared_lock_t const port_lock(mut);
+
+    (void)port_lock;
+
+    output_port_info_t const& info = *i->second;
+
+    BOOST_FOREACH (edge_t const& oedge, info.edges)
+    {
+      if (!oedge->has_space_for(count))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+datum_t
+process::priv
+::check_required_input()
+{
+  dropped_inputs.clear();
+
+  if ((check_input_level == check_none) ||
+      required_inputs.empty())
+  {
+    return datum_t();
+  }
+
+  // The first datum of each edge determines synchronization while all of
+  // the data which will be grabbed determines validity.
+  data_summary first_info;
+  data_summary info;
+
+  BOOST_FOREACH (port_t const& port, required_inputs)
+  {
+    input_edge_map_t::const_iterator const i = input_edges.find(port);
+
+    if (i == input_edges.end())
+    {
+      continue;
+    }
+
+    input_port_info_t const& edge_info = *i->second;
+    edge_t const& iedge = edge_info.edge;
+
+    // Required ports are always declared, so avoid the copy from input_port_info.
+    port_info_t const& port_info = input_ports.find(port)->second;
+    port_frequency_t const& freq = port_info->frequency;
+
+    frequency_component_t const rel_count = freq.numerator();
+
+    // Everything the step will use is looked at with one lock on the edge;
+    // a flush or completion packet at the front comes back on its own.
+    peeked_data.clear();
+    iedge->peek_step_data(peeked_data, std::max(rel_count, frequency_component_t(1)));
+
+    first_info.add(peeked_data.front());
+
+    BOOST_FOREACH (edge_datum_t const& edat, peeked_data)
+    {
+      info.add(edat);
+    }
+  }
+
+  peeked_data.clear();
+
+  if (check_sync <= check_input_level)
+  {
+    stamp_t stamp = first_info.first_stamp;
+
+    if (!first_info.in_sync)
+    {
+      if (!skip_dropped_inputs(stamp))
+      {
+        static datum::error_t const err_string = datum::error_t("Required input edges are not synchronized.");
+
+        return datum::error_datum(err_string);
+      }
+
+      // Only the inputs which still have the stamp are used for the step.
+      info = data_summary();
+
+      BOOST_FOREACH (port_t const& port, required_inputs)
+      {
+        input_edge_map_t::const_iterator const i = input_edges.find(port);
+
+        if ((i == input_edges.end()) || dropped_inputs.count(port))
+        {
+          continue;
+        }
+
+        port_frequency_t const& freq = input_ports.find(port)->second->frequency;
+        frequency_component_t const rel_count = freq.numerator();
+
+        peeked_data.clear();
+        i->second->edge->peek_step_data(peeked_data, std::max(rel_count, frequency_component_t(1)));
+
+        BOOST_FOREACH (edge_datum_t const& edat, peeked_data)
+        {
+          info.add(edat);
+        }
+      }
+
+      peeked_data.clear();
+
+      // The dropped data is treated as empty data.
+      if (info.max_status < datum::empty)
+      {
+        info.max_status = datum::empty;
+      }
+    }
+
+    // Save the stamp for the inputs.
+    stamp_for_inputs = stamp;
+  }
+
+  if (check_input_level < check_valid)
+  {
+    return datum_t();
+  }
+
+  switch (info.max_status)
+  {
+    case datum::data:
+      break;
+    case datum::empty:
+      return datum::empty_datum();
+    case datum::flush:
+      q->_flush();
+      return datum::flush_datum();
+    case datum::complete:
+      return datum::complete_datum();
+    case datum::error:
+    {
+      static datum::error_t const err_string = datum::error_t("Error in a required input edge.");
+
+      return datum::error_datum(err_string);
+    }
+    case datum::invalid:
+    default:
+    {
+      static datum::error_t const err_string = datum::error_t("Unrecognized datum type in a required input edge.");
+
+      return datum::error_datum(err_string);
     }
   }
 
   return datum_t();
 }
 
+bool
+process::priv
+::skip_dropped_inputs(stamp_t& oldest)
+{
+  // A dropping edge removes whole packets, so its front may be ahead of the
+  // other inputs. The step for the oldest stamp then runs as if the edges
+  // which dropped it had delivered empty data.
+  oldest = stamp_t();
+
+  BOOST_FOREACH (port_t const& port, required_inputs)
+  {
+    input_edge_map_t::const_iterator const i = input_edges.find(port);
+
+    if (i == input_edges.end())
+    {
+      continue;
+    }
+
+    edge_datum_t edat;
+
+    if (!i->second->edge->try_peek_datum(edat))
+    {
+      continue;
+    }
+
+    if (!oldest || (*edat.stamp < *oldest))
+    {
+      oldest = edat.stamp;
+    }
+  }
+
+  BOOST_FOREACH (port_t const& port, required_inputs)
+  {
+    input_edge_map_t::const_iterator const i = input_edges.find(port);
+
+    if (i == input_edges.end())
+    {
+      continue;
+    }
+
+    edge_t const& iedge = i->second->edge;
+    edge_datum_t edat;
+
+    if (!iedge->try_peek_datum(edat) || (*edat.stamp == *oldest))
+    {
+      continue;
+    }
+
+    stamp_t const dropped = iedge->newest_dropped_stamp();
+
+    if (!dropped || (*dropped < *oldest))
+    {
+      dropped_inputs.clear();
+
+      return false;
+    }
+
+    dropped_inputs.insert(port);
+  }
+
+  return true;
+}
+
 void
 process::priv
 ::grab_from_input_edges()
@@ -1789,7 +2925,15 @@ ::grab_from_input_edges()
     port_t const& port = iport.first;
     port_info_t const& info = iport.second;
 
-    if (!q->has_input_port_edge(port))
+    input_edge_map_t::const_iterator const e = input_edges.find(port);
+
+    if (e == input_edges.end())
+    {
+      continue;
+    }
+
+    // Nothing is left on the edge for the stamp being stepped.
+    if (dropped_inputs.count(port))
     {
       continue;
     }
@@ -1806,24 +2950,33 @@ ::grab_from_input_edges()
     }
 
     frequency_component_t const count = freq.numerator();
+    edge_t const& edge = e->second->edge;
 
-    for (frequency_component_t j = 0; j < count; ++j)
+    if (count == 1)
     {
-      datum_t const dat = q->grab_datum_from_port(port);
-      datum::type_t const dat_type = dat->type();
+      edge->pop_datum();
 
-      // If the first datum is a flush or above, don't grab any more.
-      if (!j && (datum::flush <= dat_type))
-      {
-        break;
-      }
+      continue;
+    }
+
+    edge_datum_t const first_edat = edge->peek_datum();
+    datum::type_t const first_type = first_edat.datum->type();
+
+    // If the first datum is a flush or above, don't grab any more.
+    if (datum::flush <= first_type)
+    {
+      edge->pop_datum();
+
+      continue;
     }
+
+    edge->get_data(count);
   }
 }
 
 void
 process::priv
-::push_to_output_edges(datum_t const& dat) const
+::push_to_output_edges(datum_t const& dat)
 {
   datum::type_t const dat_type = dat->type();
 
@@ -1854,10 +3007,324 @@ ::push_to_output_edges(datum_t const& dat) const
 
     frequency_component_t const count = freq.numerator();
 
-    for (frequency_component_t j = 0; j < count; ++j)
+    if (count == 1)
     {
       q->push_datum_to_port(port, dat);
     }
+    else
+    {
+      push_copies_to_port(port, dat, count);
+    }
+  }
+}
+
+void
+process::priv
+::record_step(bool ran, statistic_t wall_ns, statistic_t cpu_ns)
+{
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  boost::mutex::scoped_lock const lock(statistics_mut);
+
+  (void)lock;
+
+  ++stats.steps;
+
+  if (ran)
+  {
+    stats.step_wall_ns += wall_ns;
+    stats.step_cpu_ns += cpu_ns;
+    stats.step_wall_histogram.add(wall_ns);
+  }
+#else
+  (void)ran;
+  (void)wall_ns;
+  (void)cpu_ns;
+#endif
+}
+
+stamp_t
+process::priv
+::next_output_stamp(port_t const& port)
+{
+  shared_lock_t lock(output_edges_mut);
+
+  (void)lock;
+
+  output_edge_map_t::iterator const e = output_edges.find(port);
+
+  if (e == output_edges.end())
+  {
+    return stamp_t();
+  }
+
+  mutex_t& mut = output_mutexes[port];
+
+  unique_lock_t const port_lock(mut);
+
+  (void)port_lock;
+
+  output_port_info_t& info = *e->second;
+
+  return advance_stamp(info.stamp);
+}
+
+stamp_t
+process::priv
+::next_output_stamp(output_handle_info_t const& handle) const
+{
+  unique_lock_t const port_lock(*handle.mut);
+
+  (void)port_lock;
+
+  if (!handle.info)
+  {
+    return stamp_t();
+  }
+
+  return advance_stamp(handle.info->stamp);
+}
+
+stamp_t
+process::priv
+::advance_stamp(stamp_t& port_stamp)
+{
+  if (!port_stamp)
+  {
+    static std::string const reason = "The stamp for an output port was not initialized";
+
+    throw std::runtime_error(reason);
+  }
+
+  stamp_t push_stamp = stamp::incremented_stamp(port_stamp);
+
+  push_stamp.swap(port_stamp);
+
+  return push_stamp;
+}
+
+void
+process::priv
+::refresh_output_handles(port_t const& port, output_port_info_t& info)
+{
+  // Callers hold the port lock which pushes through handles take.
+  BOOST_FOREACH (output_handle_info_t& handle, output_handles)
+  {
+    if (handle.port == port)
+    {
+      handle.info = &info;
+    }
+  }
+}
+
+process::priv::input_handle_info_t const&
+process::priv
+::input_handle(port_handle const& handle) const
+{
+  if (handle.output || (input_handles.size() <= handle.index))
+  {
+    throw invalid_port_handle_exception(name);
+  }
+
+  return input_handles[handle.index];
+}
+
+process::priv::output_handle_info_t const&
+process::priv
+::output_handle(port_handle const& handle) const
+{
+  if (!handle.output || (output_handles.size() <= handle.index))
+  {
+    throw invalid_port_handle_exception(name);
+  }
+
+  return output_handles[handle.index];
+}
+
+edge_t const*
+process::priv
+::input_edge(port_t const& port) const
+{
+  if (!input_ports.count(port))
+  {
+    throw no_such_port_exception(name, port);
+  }
+
+  input_edge_map_t::const_iterator const e = input_edges.find(port);
+
+  if (e == input_edges.end())
+  {
+    return NULL;
+  }
+
+  return &e->second->edge;
+}
+
+edge_datum_t
+process::priv
+::peek_input(port_t const& port, edge_t const* edge, size_t idx) const
+{
+  staged_step const* const staged = current_step();
+  edge_datum_t edat;
+
+  if (staged && !idx && staged->peek(port, edat))
+  {
+    return edat;
+  }
+
+  if (!edge || !*edge)
+  {
+    static std::string const reason = "Data was requested from the port";
+
+    throw missing_connection_exception(name, port, reason);
+  }
+
+  return (*edge)->peek_datum(idx);
+}
+
+edge_datum_t
+process::priv
+::grab_input(port_t const& port, edge_t const* edge) const
+{
+  staged_step* const staged = current_step();
+  edge_datum_t edat;
+
+  if (staged && staged->grab(port, edat))
+  {
+    return edat;
+  }
+
+  if (!edge || !*edge)
+  {
+    static std::string const reason = "Data was requested from the port";
+
+    throw missing_connection_exception(name, port, reason);
+  }
+
+  return (*edge)->get_datum();
+}
+
+bool
+process::priv
+::stage_output(port_t const& port, edge_datum_t const& edat, bool stamped) const
+{
+  staged_step* const staged = current_step();
+
+  if (!staged)
+  {
+    return false;
+  }
+
+  staged->outputs.push_back(staged_step::output_t(port, edat, stamped));
+
+  return true;
+}
+
+void
+process::priv
+::push_to_edges(mutex_t& mut, output_port_info_t const* info, edge_datum_t const& edat)
+{
+  shared_lock_t const port_lock(mut);
+
+  (void)port_lock;
+
+  if (!info)
+  {
+    return;
+  }
+
+  BOOST_FOREACH (edge_t const& edge, info->edges)
+  {
+    edge->push_datum(edat);
+  }
+}
+
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+void
+process::priv
+::push_to_edges(mutex_t& mut, output_port_info_t const* info, edge_datum_t&& edat)
+{
+  shared_lock_t const port_lock(mut);
+
+  (void)port_lock;
+
+  if (!info)
+  {
+    return;
+  }
+
+  edges_t const& edges = info->edges;
+
+  if (edges.empty())
+  {
+    return;
+  }
+
+  // Only fanning out needs copies; the last edge takes the packet itself.
+  edges_t::const_iterator const last = edges.end() - 1;
+
+  for (edges_t::const_iterator i = edges.begin(); i != last; ++i)
+  {
+    (*i)->push_datum(edat);
+  }
+
+  (*last)->push_datum(std::move(edat));
+}
+#endif
+
+void
+process::priv
+::push_copies_to_port(port_t const& port, datum_t const& dat, frequency_component_t count)
+{
+  edge_data_t data;
+
+  data.reserve(count);
+
+  shared_lock_t lock(output_edges_mut);
+
+  (void)lock;
+
+  output_edge_map_t::iterator const e = output_edges.find(port);
+
+  if (e == output_edges.end())
+  {
+    return;
+  }
+
+  mutex_t& mut = output_mutexes[port];
+  output_port_info_t& info = *e->second;
+
+  // Stamp the whole batch at once, but only hold the port exclusively while
+  // stamping. Pushing may block on a full edge and readiness checks must still
+  // be able to look at the port in the meantime. Steps of reentrant processes
+  // push in commit order, so batches are not interleaved.
+  {
+    unique_lock_t const port_lock(mut);
+
+    (void)port_lock;
+
+    stamp_t& port_stamp = info.stamp;
+
+    if (!port_stamp)
+    {
+      static std::string const reason = "The stamp for an output port was not initialized";
+
+      throw std::runtime_error(reason);
+    }
+
+    for (frequency_component_t j = 0; j < count; ++j)
+    {
+      data.push_back(edge_datum_t(dat, port_stamp));
+      port_stamp = stamp::incremented_stamp(port_stamp);
+    }
+  }
+
+  shared_lock_t const port_lock(mut);
+
+  (void)port_lock;
+
+  BOOST_FOREACH (edge_t const& edge, info.edges)
+  {
+    edge->push_data(data);
   }
 }
 
@@ -1974,6 +3441,8 @@ ::make_output_stamps()
       stamp_t& stamp = oinfo.stamp;
 
       stamp = stamp::new_stamp(port_increment);
+
+      refresh_output_handles(port_name, oinfo);
     }
   }
 
@@ -2003,4 +3472,29 @@ process::priv::output_port_info_t
 {
 }
 
+process::priv::input_handle_info_t
+::input_handle_info_t(port_t const& port_, edge_t const& edge_)
+  : port(port_)
+  , edge(edge_)
+{
+}
+
+process::priv::input_handle_info_t
+::~input_handle_info_t()
+{
+}
+
+process::priv::output_handle_info_t
+::output_handle_info_t(port_t const& port_, output_port_info_t* info_, mutex_t* mut_)
+  : port(port_)
+  , info(info_)
+  , mut(mut_)
+{
+}
+
+process::priv::output_handle_info_t
+::~output_handle_info_t()
+{
+}
+
 }
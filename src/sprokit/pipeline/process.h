@@ -36,9 +36,11 @@
 #include "edge.h"
 #include "config.h"
 #include "datum.h"
+#include "statistics.h"
 #include "types.h"
 
 #include <boost/cstdint.hpp>
+#include <boost/function.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/rational.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -67,7 +69,8 @@ typedef std::vector<process_t> processes_t;
  *
  * \oports
  *
- * \oport{_heartbeat} Carries the status of the process.
+ * \oport{_heartbeat} Carries the status of the process. Only filled when
+ *                    connected; prefer \ref process::set_step_callback.
  *
  * \section initialization Initialization Routine
  *
@@ -247,6 +250,50 @@ class SPROKIT_PIPELINE_EXPORT process
       check_valid
     } data_check_t;
 
+    /**
+     * \brief Type for a function notified after each step of the process.
+     *
+     * The argument is \c true if the process has completed.
+     */
+    typedef boost::function<void (bool)> step_callback_t;
+
+    /**
+     * \class port_handle process.h <sprokit/pipeline/process.h>
+     *
+     * \brief A pre-resolved reference to a port for use on the data path.
+     *
+     * Handles are obtained from \ref process::input_port_handle and \ref
+     * process::output_port_handle and are only meaningful to the process which
+     * resolved them. They are invalidated when the process is reset.
+     */
+    class SPROKIT_PIPELINE_EXPORT port_handle
+    {
+      public:
+        /**
+         * \brief Constructor.
+         *
+         * Creates a handle which does not refer to any port.
+         */
+        port_handle();
+        /**
+         * \brief Destructor.
+         */
+        ~port_handle();
+
+        /**
+         * \brief Query whether the handle refers to a port.
+         *
+         * \returns True if the handle has been resolved.
+         */
+        bool is_valid() const;
+      private:
+        friend class process;
+        SPROKIT_PIPELINE_NO_EXPORT port_handle(size_t index_, bool output_);
+
+        size_t index;
+        bool output;
+    };
+
     /**
      * \brief Pre-connection initialization.
      *
@@ -284,6 +331,14 @@ class SPROKIT_PIPELINE_EXPORT process
     /**
      * \brief Step through one iteration of the process.
      *
+     * Processes without the \ref property_no_reentrancy property may be
+     * stepped from multiple threads at once if every connected input port
+     * is required and has a frequency of one. The inputs for each step are
+     * taken in turn before \ref _step is called and the outputs are pushed
+     * in that same order once \ref _step returns, so downstream processes
+     * see the same stream as if the steps ran one at a time. Otherwise,
+     * steps are serialized by the caller as before.
+     *
      * \preconds
      *
      * \precond{\c this was initialized}
@@ -295,6 +350,82 @@ class SPROKIT_PIPELINE_EXPORT process
      */
     void step();
 
+    /**
+     * \brief Query whether a step would be able to run without blocking.
+     *
+     * A process is ready when every connected required input has enough
+     * data for its frequency (or a flush or complete datum at its head) and
+     * no output edge is full. A completed process is always ready since
+     * stepping it is a no-op. Inputs are not considered if the process
+     * turned off data checking with \ref set_data_checking_level. For a
+     * \link is_reentrant reentrant\endlink process, each step which has
+     * taken its inputs but not yet pushed its outputs also keeps a place
+     * free on every output edge.
+     *
+     * \note The answer is only a hint if \ref _step pushes more than one
+     * datum per output port or grabs from optional ports.
+     *
+     * \throws unconfigured_exception Thrown if called before \ref configure.
+     * \throws uninitialized_exception Thrown if called before \ref init.
+     *
+     * \returns True if the process may be stepped without blocking.
+     */
+    bool ready() const;
+
+    /**
+     * \brief Step the process only if it is \ref ready.
+     *
+     * Since a process is the only consumer of its input edges and the only
+     * producer to its output edges, readiness cannot be lost between the
+     * check and the step.
+     *
+     * \throws unconfigured_exception Thrown if called before \ref configure.
+     * \throws uninitialized_exception Thrown if called before \ref init.
+     *
+     * \returns True if the process was stepped, false otherwise.
+     */
+    bool try_step();
+
+    /**
+     * \brief Query whether steps may run concurrently.
+     *
+     * This is decided when the process is initialized based on its
+     * properties and connections. See \ref step for the requirements.
+     *
+     * \returns True if \ref step may be called from multiple threads at once.
+     */
+    bool is_reentrant() const;
+
+    /**
+     * \brief Set the function to call after each step.
+     *
+     * The callback is called from within \ref step on the thread stepping the
+     * process. This is the preferred way for a scheduler to learn that a
+     * process has completed rather than monitoring \ref port_heartbeat.
+     *
+     * \note This should not be called while the process is being stepped.
+     *
+     * \param callback The function to call. An empty function removes the
+     *                 current callback.
+     */
+    void set_step_callback(step_callback_t const& callback);
+
+    /**
+     * \brief Query whether the process has completed.
+     *
+     * \returns True if the process has completed, false otherwise.
+     */
+    bool is_complete() const;
+
+    /**
+     * \brief Statistics about the execution of the process.
+     *
+     * Time spent blocked is gathered from the edges connected to the process.
+     *
+     * \returns A snapshot of the statistics for the process.
+     */
+    process_statistics statistics() const;
+
     /**
      * \brief Query for the properties on the process.
      *
@@ -457,18 +588,27 @@ class SPROKIT_PIPELINE_EXPORT process
 
     /// A property which indicates that the process cannot be run in a thread of its own.
     static property_t const property_no_threads;
-    /// A property which indicates that the process is not reentrant.
+    /**
+     * \brief A property which indicates that the process is not reentrant.
+     *
+     * This is set by default; processes whose \ref _step only touches the
+     * data for the current step may remove it to be stepped concurrently.
+     */
     static property_t const property_no_reentrancy;
     /// A property which indicates that the input of the process is not synchronized.
     static property_t const property_unsync_input;
     /// A property which indicates that the output of the process is not synchronized.
     static property_t const property_unsync_output;
+    /// A property which indicates that copies of the process may run on disjoint parts of a stream.
+    static property_t const property_replicable;
     /// The name of the heartbeat port.
     static port_t const port_heartbeat;
     /// The name of the configuration value for the name.
     static config::key_t const config_name;
     /// The name of the configuration value for the type.
     static config::key_t const config_type;
+    /// The name of the configuration value for the number of copies to run.
+    static config::key_t const config_replicas;
     /// A type which means that the type of the data is irrelevant.
     static port_type_t const type_any;
     /// A type which indicates that no actual data is ever created.
@@ -725,6 +865,14 @@ class SPROKIT_PIPELINE_EXPORT process
      * \return True if there is an edge connected to the \p port, or false if there is none.
      */
     bool has_input_port_edge(port_t const& port) const;
+    /**
+     * \brief Get the number of data waiting on an input port.
+     *
+     * \param port The port to query.
+     *
+     * \returns The number of data which may be grabbed from \p port without blocking.
+     */
+    size_t input_port_datum_count(port_t const& port) const;
     /**
      * \brief Get the number of connected edges for an output port.
      *
@@ -733,6 +881,19 @@ class SPROKIT_PIPELINE_EXPORT process
      * \returns The number of edges connected to the \p port.
      */
     size_t count_output_port_edges(port_t const& port) const;
+    /**
+     * \brief Get the space available for pushing to an output port.
+     *
+     * Pushing to a port blocks while any of its edges is full, so this is the
+     * least space available in any edge connected to the port. Unbounded
+     * edges count down from the largest value by the data queued in them so
+     * that shorter queues still report more space.
+     *
+     * \param port The port to query.
+     *
+     * \returns The number of data which may be pushed without blocking.
+     */
+    size_t output_port_free_space(port_t const& port) const;
 
     /**
      * \brief Peek at an edge datum packet from a port.
@@ -793,6 +954,17 @@ class SPROKIT_PIPELINE_EXPORT process
      * \param dat The edge datum to push.
      */
     void push_to_port(port_t const& port, edge_datum_t const& dat) const;
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+    /**
+     * \brief Move an edge datum packet out on a port.
+     *
+     * Only edges beyond the first connected to \p port receive copies.
+     *
+     * \param port The port to push to.
+     * \param dat The edge datum to push.
+     */
+    void push_to_port(port_t const& port, edge_datum_t&& dat) const;
+#endif
     /**
      * \brief Output a datum packet on a port.
      *
@@ -800,6 +972,15 @@ class SPROKIT_PIPELINE_EXPORT process
      * \param dat The datum to push.
      */
     void push_datum_to_port(port_t const& port, datum_t const& dat) const;
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+    /**
+     * \brief Move a datum packet out on a port.
+     *
+     * \param port The port to push to.
+     * \param dat The datum to push.
+     */
+    void push_datum_to_port(port_t const& port, datum_t&& dat) const;
+#endif
     /**
      * \brief Output a result on a port.
      *
@@ -809,6 +990,120 @@ class SPROKIT_PIPELINE_EXPORT process
     template <typename T>
     void push_to_port_as(port_t const& port, T const& dat) const;
 
+    /**
+     * \brief Resolve an input port for repeated access.
+     *
+     * Connections are fixed once the process is initialized, so this should
+     * be called from \ref process::_init(). Data methods which take the
+     * returned handle avoid looking up the port by name on each call.
+     *
+     * \throws no_such_port_exception Thrown if \p port does not exist.
+     *
+     * \param port The port to resolve.
+     *
+     * \returns A handle for \p port.
+     */
+    port_handle input_port_handle(port_t const& port);
+    /**
+     * \brief Resolve an output port for repeated access.
+     *
+     * Unlike input ports, output ports may be connected after initialization;
+     * handles pick up such edges as they are connected.
+     *
+     * \see input_port_handle
+     *
+     * \throws no_such_port_exception Thrown if \p port does not exist.
+     *
+     * \param port The port to resolve.
+     *
+     * \returns A handle for \p port.
+     */
+    port_handle output_port_handle(port_t const& port);
+
+    /**
+     * \brief Peek at an edge datum packet from a resolved port.
+     *
+     * \param handle The input port to look at.
+     * \param idx The element within the queue to look at.
+     *
+     * \returns The datum available on the port.
+     */
+    edge_datum_t peek_at_port(port_handle const& handle, size_t idx = 0) const;
+    /**
+     * \brief Peek at a datum packet from a resolved port.
+     *
+     * \param handle The input port to look at.
+     * \param idx The element within the queue to look at.
+     *
+     * \returns The datum available on the port.
+     */
+    datum_t peek_at_datum_on_port(port_handle const& handle, size_t idx = 0) const;
+    /**
+     * \brief Grab an edge datum packet from a resolved port.
+     *
+     * \param handle The input port to get data from.
+     *
+     * \returns The datum available on the port.
+     */
+    edge_datum_t grab_from_port(port_handle const& handle) const;
+    /**
+     * \brief Grab a datum packet from a resolved port.
+     *
+     * \param handle The input port to get data from.
+     *
+     * \returns The datum available on the port.
+     */
+    datum_t grab_datum_from_port(port_handle const& handle) const;
+    /**
+     * \brief Grab a datum from a resolved port as a certain type.
+     *
+     * \param handle The input port to get data from.
+     *
+     * \returns The datum from the port.
+     */
+    template <typename T>
+    T grab_from_port_as(port_handle const& handle) const;
+    /**
+     * \brief Output an edge datum packet on a resolved port.
+     *
+     * \param handle The output port to push to.
+     * \param dat The edge datum to push.
+     */
+    void push_to_port(port_handle const& handle, edge_datum_t const& dat) const;
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+    /**
+     * \brief Move an edge datum packet out on a resolved port.
+     *
+     * \param handle The output port to push to.
+     * \param dat The edge datum to push.
+     */
+    void push_to_port(port_handle const& handle, edge_datum_t&& dat) const;
+#endif
+    /**
+     * \brief Output a datum packet on a resolved port.
+     *
+     * \param handle The output port to push to.
+     * \param dat The datum to push.
+     */
+    void push_datum_to_port(port_handle const& handle, datum_t const& dat) const;
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+    /**
+     * \brief Move a datum packet out on a resolved port.
+     *
+     * \param handle The output port to push to.
+     * \param dat The datum to push.
+     */
+    void push_datum_to_port(port_handle const& handle, datum_t&& dat) const;
+#endif
+    /**
+     * \brief Output a result on a resolved port.
+     *
+     * \param handle The output port to push to.
+     * \param dat The result to push.
+     */
+    template <typename T>
+    void push_to_port_as(port_handle const& handle, T const& dat) const;
+
     /**
      * \brief The configuration for the process.
      *
@@ -913,6 +1208,22 @@ ::push_to_port_as(port_t const& port, T const& dat) const
   push_datum_to_port(port, datum::new_datum(dat));
 }
 
+template <typename T>
+T
+process
+::grab_from_port_as(port_handle const& handle) const
+{
+  return grab_datum_from_port(handle)->get_datum<T>();
+}
+
+template <typename T>
+void
+process
+::push_to_port_as(port_handle const& handle, T const& dat) const
+{
+  push_datum_to_port(handle, datum::new_datum(dat));
+}
+
 }
 
 #endif // SPROKIT_PIPELINE_PROCESS_H
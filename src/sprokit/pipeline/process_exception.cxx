@@ -412,6 +412,25 @@ missing_connection_exception
 {
 }
 
+invalid_port_handle_exception
+::invalid_port_handle_exception(process::name_t const& name) SPROKIT_NOTHROW
+  : process_exception()
+  , m_name(name)
+{
+  std::ostringstream sstr;
+
+  sstr << "A port handle which was not resolved "
+          "by the process \'" << m_name << "\' "
+          "was used";
+
+  m_what = sstr.str();
+}
+
+invalid_port_handle_exception
+::~invalid_port_handle_exception() SPROKIT_NOTHROW
+{
+}
+
 process_configuration_exception
 ::process_configuration_exception() SPROKIT_NOTHROW
   : process_exception()
@@ -607,6 +607,32 @@ class SPROKIT_PIPELINE_EXPORT missing_connection_exception
     std::string const m_reason;
 };
 
+/**
+ * \class invalid_port_handle_exception process_exception.h <sprokit/pipeline/process_exception.h>
+ *
+ * \brief Thrown when a port handle which was not resolved by the process is used.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT invalid_port_handle_exception
+  : public process_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param name The name of the process.
+     */
+    invalid_port_handle_exception(process::name_t const& name) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~invalid_port_handle_exception() throw();
+
+    /// The name of the \ref process.
+    process::name_t const m_name;
+};
+
 /**
  * \class process_configuration_exception process_exception.h <sprokit/pipeline/process_exception.h>
  *
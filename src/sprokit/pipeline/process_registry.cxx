@@ -36,10 +36,12 @@
 #include "types.h"
 
 #include <boost/thread/locks.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <utility>
@@ -65,6 +67,17 @@ class process_registry::priv
 
     typedef std::set<module_t> loaded_modules_t;
     loaded_modules_t loaded_modules;
+
+    void load_deferred(process::type_t const& type);
+
+    typedef std::map<process::type_t, module_loader_t> deferred_store_t;
+    deferred_store_t deferred;
+
+    typedef boost::recursive_mutex mutex_t;
+    typedef boost::unique_lock<mutex_t> unique_lock_t;
+
+    // Loading a module registers types from within the loader.
+    mutex_t deferred_mut;
 };
 
 static process_registry_t reg_self = process_registry_t();
@@ -89,6 +102,28 @@ ::register_process(process::type_t const& type, description_t const& desc, proce
   }
 
   d->registry[type] = priv::process_typeinfo_t(desc, ctor);
+
+  priv::unique_lock_t const lock(d->deferred_mut);
+
+  (void)lock;
+
+  d->deferred.erase(type);
+}
+
+void
+process_registry
+::register_deferred_process(process::type_t const& type, module_loader_t const& loader)
+{
+  if (d->registry.count(type))
+  {
+    return;
+  }
+
+  priv::unique_lock_t const lock(d->deferred_mut);
+
+  (void)lock;
+
+  d->deferred[type] = loader;
 }
 
 process_t
@@ -100,6 +135,8 @@ ::create_process(process::type_t const& type, process::name_t const& name, confi
     throw null_process_registry_config_exception();
   }
 
+  d->load_deferred(type);
+
   priv::process_store_t::const_iterator const i = d->registry.find(type);
 
   if (i == d->registry.end())
@@ -126,6 +163,19 @@ ::types() const
     ts.push_back(type);
   }
 
+  priv::unique_lock_t const lock(d->deferred_mut);
+
+  (void)lock;
+
+  BOOST_FOREACH (priv::deferred_store_t::value_type const& entry, d->deferred)
+  {
+    process::type_t const& type = entry.first;
+
+    ts.push_back(type);
+  }
+
+  std::sort(ts.begin(), ts.end());
+
   return ts;
 }
 
@@ -133,6 +183,8 @@ process_registry::description_t
 process_registry
 ::description(process::type_t const& type) const
 {
+  d->load_deferred(type);
+
   priv::process_store_t::const_iterator const i = d->registry.find(type);
 
   if (i == d->registry.end())
@@ -191,6 +243,8 @@ process_registry::priv
 ::priv()
   : registry()
   , loaded_modules()
+  , deferred()
+  , deferred_mut()
 {
 }
 
@@ -199,4 +253,41 @@ process_registry::priv
 {
 }
 
+void
+process_registry::priv
+::load_deferred(process::type_t const& type)
+{
+  unique_lock_t const lock(deferred_mut);
+
+  (void)lock;
+
+  if (registry.count(type))
+  {
+    return;
+  }
+
+  deferred_store_t::iterator const i = deferred.find(type);
+
+  if (i != deferred.end())
+  {
+    module_loader_t const loader = i->second;
+
+    deferred.erase(i);
+    loader();
+
+    return;
+  }
+
+  // The type may come from a module with an outdated manifest; load whatever
+  // is left before giving up on it.
+  while (!deferred.empty())
+  {
+    deferred_store_t::iterator const j = deferred.begin();
+    module_loader_t const loader = j->second;
+
+    deferred.erase(j);
+    loader();
+  }
+}
+
 }
@@ -70,6 +70,8 @@ class SPROKIT_PIPELINE_EXPORT process_registry
     typedef std::string description_t;
     /// The type of a module name.
     typedef std::string module_t;
+    /// The type of a function which loads a module.
+    typedef boost::function<void ()> module_loader_t;
 
     /**
      * \brief Destructor.
@@ -89,6 +91,16 @@ class SPROKIT_PIPELINE_EXPORT process_registry
      * \param ctor The function which creates the process of the \p type.
      */
     void register_process(process::type_t const& type, description_t const& desc, process_ctor_t ctor);
+    /**
+     * \brief Add a process type provided by a module which has not been loaded.
+     *
+     * The \p loader is called the first time the type is used. It is expected
+     * to register the type. Types which are already registered are ignored.
+     *
+     * \param type The name of the \ref process type.
+     * \param loader The function which loads the module providing \p type.
+     */
+    void register_deferred_process(process::type_t const& type, module_loader_t const& loader);
     /**
      * \brief Create process of a specific type.
      *
@@ -32,12 +32,18 @@
 #include "scheduler_exception.h"
 
 #include "pipeline.h"
+#include "statistics.h"
+#include "utils.h"
 
 #include <boost/thread/locks.hpp>
 #ifndef BOOST_NO_HAVE_REVERSE_LOCK
 #include <boost/thread/reverse_lock.hpp>
 #endif
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/foreach.hpp>
+
+#include <fstream>
 
 /**
  * \file scheduler.cxx
@@ -51,13 +57,15 @@ namespace sprokit
 class scheduler::priv
 {
   public:
-    priv(scheduler* sched, pipeline_t const& pipe);
+    priv(scheduler* sched, pipeline_t const& pipe, config_t const& conf);
     ~priv();
 
     void stop();
+    void dump_statistics() const;
 
     scheduler* const q;
     pipeline_t const p;
+    config_t const config;
     bool paused;
     bool running;
 
@@ -70,8 +78,12 @@ class scheduler::priv
     typedef boost::upgrade_to_unique_lock<mutex_t> upgrade_to_unique_lock_t;
 
     mutex_t mut;
+
+    static config::key_t const config_affinity;
 };
 
+config::key_t const scheduler::priv::config_affinity = config::key_t("affinity");
+
 scheduler
 ::~scheduler()
 {
@@ -91,7 +103,24 @@ ::scheduler(pipeline_t const& pipe, config_t const& config)
     throw null_scheduler_pipeline_exception();
   }
 
-  d.reset(new priv(this, pipe));
+  d.reset(new priv(this, pipe, config));
+
+  // Catch bad processor lists before anything runs.
+  BOOST_FOREACH (config::key_t const& key, config->available_values())
+  {
+    if ((key != priv::config_affinity) &&
+        !boost::starts_with(key, priv::config_affinity + config::block_sep))
+    {
+      continue;
+    }
+
+    config::value_t const value = config->get_value<config::value_t>(key);
+
+    if (!parse_cpu_list(value))
+    {
+      throw invalid_affinity_exception(key, value);
+    }
+  }
 }
 
 void
@@ -147,6 +176,7 @@ ::wait()
   if (d->running)
   {
     d->stop();
+    d->dump_statistics();
   }
 }
 
@@ -235,10 +265,37 @@ ::pipeline() const
   return d->p;
 }
 
+cpu_ids_t
+scheduler
+::affinity(process::name_t const& name) const
+{
+  process::name_t cur_name = name;
+
+  while (!cur_name.empty())
+  {
+    config::key_t const key = priv::config_affinity + config::block_sep + cur_name;
+
+    if (d->config->has_value(key))
+    {
+      return *parse_cpu_list(d->config->get_value<config::value_t>(key));
+    }
+
+    cur_name = d->p->parent_cluster(cur_name);
+  }
+
+  if (d->config->has_value(priv::config_affinity))
+  {
+    return *parse_cpu_list(d->config->get_value<config::value_t>(priv::config_affinity));
+  }
+
+  return cpu_ids_t();
+}
+
 scheduler::priv
-::priv(scheduler* sched, pipeline_t const& pipe)
+::priv(scheduler* sched, pipeline_t const& pipe, config_t const& conf)
   : q(sched)
   , p(pipe)
+  , config(conf)
   , paused(false)
   , running(false)
   , mut()
@@ -270,4 +327,36 @@ ::stop()
   running = false;
 }
 
+void
+scheduler::priv
+::dump_statistics() const
+{
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  static envvar_name_t const statistics_envvar = envvar_name_t("SPROKIT_STATISTICS_PATH");
+
+  envvar_value_t const path = get_envvar(statistics_envvar);
+
+  if (!path || path->empty())
+  {
+    return;
+  }
+
+  std::ofstream fout(path->c_str());
+
+  if (!fout.good())
+  {
+    throw statistics_write_exception(*path);
+  }
+
+  write_statistics(fout, p);
+
+  fout.flush();
+
+  if (!fout.good())
+  {
+    throw statistics_write_exception(*path);
+  }
+#endif
+}
+
 }
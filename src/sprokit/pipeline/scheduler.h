@@ -33,7 +33,9 @@
 
 #include "pipeline-config.h"
 
+#include "process.h"
 #include "types.h"
+#include "utils.h"
 
 #include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -52,6 +54,17 @@ namespace sprokit
  *
  * \brief The base class for execution strategies on a \ref pipeline.
  *
+ * \configs
+ *
+ * \config{affinity} The processors the scheduler's threads may run on, given
+ *                   as a list such as \c 0-3,8. Unset means no restriction.
+ * \config{affinity:\portvar{name}} The processors for the thread running the
+ *                                  process or cluster \portvar{name}. Settings
+ *                                  for a cluster apply to all of the processes
+ *                                  within it.
+ *
+ * Implementations decide which of their threads these settings apply to.
+ *
  * \ingroup base_classes
  */
 class SPROKIT_PIPELINE_EXPORT scheduler
@@ -72,7 +85,12 @@ class SPROKIT_PIPELINE_EXPORT scheduler
     /**
      * \brief Wait until execution is finished.
      *
+     * If the \c SPROKIT_STATISTICS_PATH environment variable is set, the
+     * statistics for the pipeline are written to it as JSON once execution
+     * has finished.
+     *
      * \throws restart_scheduler_exception Thrown when the scheduler has not been started.
+     * \throws statistics_write_exception Thrown when the statistics could not be written.
      */
     void wait();
     /**
@@ -143,6 +161,18 @@ class SPROKIT_PIPELINE_EXPORT scheduler
      * \returns The pipeline.
      */
     pipeline_t pipeline() const;
+
+    /**
+     * \brief The processors a thread should be pinned to.
+     *
+     * The most specific setting is used: the process itself, then each
+     * cluster it is within from the innermost outward, then the default.
+     *
+     * \param name The process the thread will run, or empty for the default.
+     *
+     * \returns The processors to pin to; empty if there is no restriction.
+     */
+    cpu_ids_t affinity(process::name_t const& name = process::name_t()) const;
   private:
     class SPROKIT_PIPELINE_NO_EXPORT priv;
     boost::scoped_ptr<priv> d;
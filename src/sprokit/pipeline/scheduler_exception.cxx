@@ -213,4 +213,41 @@ stop_before_start_exception
 {
 }
 
+invalid_affinity_exception
+::invalid_affinity_exception(config::key_t const& key, config::value_t const& value) SPROKIT_NOTHROW
+  : scheduler_exception()
+  , m_key(key)
+  , m_value(value)
+{
+  std::ostringstream sstr;
+
+  sstr << "The processor list \'" << m_value << "\' "
+          "given for \'" << m_key << "\' is not valid";
+
+  m_what = sstr.str();
+}
+
+invalid_affinity_exception
+::~invalid_affinity_exception() SPROKIT_NOTHROW
+{
+}
+
+statistics_write_exception
+::statistics_write_exception(std::string const& path) SPROKIT_NOTHROW
+  : scheduler_exception()
+  , m_path(path)
+{
+  std::ostringstream sstr;
+
+  sstr << "The statistics could not be written "
+          "to \'" << m_path << "\'";
+
+  m_what = sstr.str();
+}
+
+statistics_write_exception
+::~statistics_write_exception() SPROKIT_NOTHROW
+{
+}
+
 }
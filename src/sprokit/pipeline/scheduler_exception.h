@@ -33,6 +33,7 @@
 
 #include "pipeline-config.h"
 
+#include "config.h"
 #include "types.h"
 
 #include <string>
@@ -280,6 +281,61 @@ class SPROKIT_PIPELINE_EXPORT stop_before_start_exception
     ~stop_before_start_exception() throw();
 };
 
+/**
+ * \class invalid_affinity_exception scheduler_exception.h <sprokit/pipeline/scheduler_exception.h>
+ *
+ * \brief Thrown when a scheduler is given a processor list which cannot be parsed.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT invalid_affinity_exception
+  : public scheduler_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param key The configuration key with the processor list.
+     * \param value The processor list.
+     */
+    invalid_affinity_exception(config::key_t const& key, config::value_t const& value) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~invalid_affinity_exception() throw();
+
+    /// The configuration key with the processor list.
+    config::key_t const m_key;
+    /// The processor list.
+    config::value_t const m_value;
+};
+
+/**
+ * \class statistics_write_exception scheduler_exception.h <sprokit/pipeline/scheduler_exception.h>
+ *
+ * \brief Thrown when the statistics for a pipeline could not be written.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT statistics_write_exception
+  : public scheduler_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param path The path the statistics were to be written to.
+     */
+    statistics_write_exception(std::string const& path) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~statistics_write_exception() throw();
+
+    /// The path the statistics were to be written to.
+    std::string const m_path;
+};
+
 }
 
 #endif // SPROKIT_PIPELINE_SCHEDULER_EXCEPTION_H
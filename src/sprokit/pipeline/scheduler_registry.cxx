@@ -34,10 +34,12 @@
 #include "types.h"
 
 #include <boost/thread/locks.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
 #include <map>
 #include <set>
 
@@ -64,6 +66,17 @@ class scheduler_registry::priv
 
     typedef std::set<module_t> loaded_modules_t;
     loaded_modules_t loaded_modules;
+
+    void load_deferred(type_t const& type);
+
+    typedef std::map<type_t, module_loader_t> deferred_store_t;
+    deferred_store_t deferred;
+
+    typedef boost::recursive_mutex mutex_t;
+    typedef boost::unique_lock<mutex_t> unique_lock_t;
+
+    // Loading a module registers types from within the loader.
+    mutex_t deferred_mut;
 };
 
 static scheduler_registry_t reg_self = scheduler_registry_t();
@@ -88,6 +101,28 @@ ::register_scheduler(type_t const& type, description_t const& desc, scheduler_ct
   }
 
   d->registry[type] = priv::scheduler_typeinfo_t(desc, ctor);
+
+  priv::unique_lock_t const lock(d->deferred_mut);
+
+  (void)lock;
+
+  d->deferred.erase(type);
+}
+
+void
+scheduler_registry
+::register_deferred_scheduler(type_t const& type, module_loader_t const& loader)
+{
+  if (d->registry.count(type))
+  {
+    return;
+  }
+
+  priv::unique_lock_t const lock(d->deferred_mut);
+
+  (void)lock;
+
+  d->deferred[type] = loader;
 }
 
 scheduler_t
@@ -104,6 +139,8 @@ ::create_scheduler(type_t const& type, pipeline_t const& pipe, config_t const& c
     throw null_scheduler_registry_pipeline_exception();
   }
 
+  d->load_deferred(type);
+
   priv::scheduler_store_t::const_iterator const i = d->registry.find(type);
 
   if (i == d->registry.end())
@@ -127,6 +164,19 @@ ::types() const
     ts.push_back(type);
   }
 
+  priv::unique_lock_t const lock(d->deferred_mut);
+
+  (void)lock;
+
+  BOOST_FOREACH (priv::deferred_store_t::value_type const& entry, d->deferred)
+  {
+    type_t const& type = entry.first;
+
+    ts.push_back(type);
+  }
+
+  std::sort(ts.begin(), ts.end());
+
   return ts;
 }
 
@@ -134,6 +184,8 @@ scheduler_registry::description_t
 scheduler_registry
 ::description(type_t const& type) const
 {
+  d->load_deferred(type);
+
   priv::scheduler_store_t::const_iterator const i = d->registry.find(type);
 
   if (i == d->registry.end())
@@ -192,6 +244,8 @@ scheduler_registry::priv
 ::priv()
   : registry()
   , loaded_modules()
+  , deferred()
+  , deferred_mut()
 {
 }
 
@@ -200,4 +254,41 @@ scheduler_registry::priv
 {
 }
 
+void
+scheduler_registry::priv
+::load_deferred(type_t const& type)
+{
+  unique_lock_t const lock(deferred_mut);
+
+  (void)lock;
+
+  if (registry.count(type))
+  {
+    return;
+  }
+
+  deferred_store_t::iterator const i = deferred.find(type);
+
+  if (i != deferred.end())
+  {
+    module_loader_t const loader = i->second;
+
+    deferred.erase(i);
+    loader();
+
+    return;
+  }
+
+  // The type may come from a module with an outdated manifest; load whatever
+  // is left before giving up on it.
+  while (!deferred.empty())
+  {
+    deferred_store_t::iterator const j = deferred.begin();
+    module_loader_t const loader = j->second;
+
+    deferred.erase(j);
+    loader();
+  }
+}
+
 }
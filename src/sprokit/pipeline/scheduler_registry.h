@@ -73,6 +73,8 @@ class SPROKIT_PIPELINE_EXPORT scheduler_registry
     typedef std::vector<type_t> types_t;
     /// The type of a module name.
     typedef std::string module_t;
+    /// The type of a function which loads a module.
+    typedef boost::function<void ()> module_loader_t;
 
     /**
      * \brief Destructor.
@@ -92,6 +94,16 @@ class SPROKIT_PIPELINE_EXPORT scheduler_registry
      * \param ctor The function which creates the scheduler of the \p type.
      */
     void register_scheduler(type_t const& type, description_t const& desc, scheduler_ctor_t ctor);
+    /**
+     * \brief Add a scheduler type provided by a module which has not been loaded.
+     *
+     * The \p loader is called the first time the type is used. It is expected
+     * to register the type. Types which are already registered are ignored.
+     *
+     * \param type The name of the \ref scheduler type.
+     * \param loader The function which loads the module providing \p type.
+     */
+    void register_deferred_scheduler(type_t const& type, module_loader_t const& loader);
     /**
      * \brief Create scheduler of a specific type.
      *
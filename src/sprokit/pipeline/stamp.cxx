@@ -30,6 +30,9 @@
 
 #include "stamp.h"
 
+#include "pool.h"
+
+#include <new>
 #include <stdexcept>
 
 /**
@@ -41,11 +44,17 @@
 namespace sprokit
 {
 
+typedef pool_allocator<stamp> stamp_allocator_t;
+typedef pool_deleter<stamp> stamp_deleter_t;
+
 stamp_t
 stamp
 ::new_stamp(increment_t increment)
 {
-  return stamp_t(new stamp(increment, 0));
+  void* const mem = pool_allocate(sizeof(stamp));
+  stamp const* const st = new (mem) stamp(increment, 0);
+
+  return stamp_t(st, stamp_deleter_t(), stamp_allocator_t());
 }
 
 stamp_t
@@ -59,7 +68,10 @@ ::incremented_stamp(stamp_t const& st)
     throw std::runtime_error(reason);
   }
 
-  return stamp_t(new stamp(st->m_increment, st->m_index + st->m_increment));
+  void* const mem = pool_allocate(sizeof(stamp));
+  stamp const* const new_st = new (mem) stamp(st->m_increment, st->m_index + st->m_increment);
+
+  return stamp_t(new_st, stamp_deleter_t(), stamp_allocator_t());
 }
 
 bool
@@ -0,0 +1,288 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "statistics.h"
+
+#include "edge.h"
+#include "pipeline.h"
+#include "process.h"
+
+#include <boost/foreach.hpp>
+
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+#include <cstring>
+
+/**
+ * \file statistics.cxx
+ *
+ * \brief Implementation of runtime statistics.
+ */
+
+namespace sprokit
+{
+
+static void write_json_string(std::ostream& ostr, std::string const& str);
+
+duration_histogram
+::duration_histogram()
+{
+  std::memset(buckets, 0, sizeof(buckets));
+}
+
+duration_histogram
+::~duration_histogram()
+{
+}
+
+void
+duration_histogram
+::add(statistic_t ns)
+{
+  ++buckets[bucket_for(ns)];
+}
+
+size_t
+duration_histogram
+::bucket_for(statistic_t ns)
+{
+  size_t bucket = 0;
+
+  while (ns && (bucket + 1 < bucket_count))
+  {
+    ns >>= 1;
+    ++bucket;
+  }
+
+  return bucket;
+}
+
+process_statistics
+::process_statistics()
+  : steps(0)
+  , step_wall_ns(0)
+  , step_cpu_ns(0)
+  , step_wall_histogram()
+  , push_blocked_ns(0)
+  , grab_blocked_ns(0)
+{
+}
+
+process_statistics
+::~process_statistics()
+{
+}
+
+edge_statistics
+::edge_statistics()
+  : pushed(0)
+  , grabbed(0)
+  , high_water_mark(0)
+  , occupancy_sum(0)
+  , push_blocked_ns(0)
+  , grab_blocked_ns(0)
+  , dropped(0)
+{
+}
+
+edge_statistics
+::~edge_statistics()
+{
+}
+
+double
+edge_statistics
+::mean_occupancy() const
+{
+  if (!pushed)
+  {
+    return 0.;
+  }
+
+  return (double(occupancy_sum) / double(pushed));
+}
+
+void
+write_statistics(std::ostream& ostr, pipeline_t const& pipe)
+{
+  process::names_t const names = pipe->process_names();
+
+  ostr << "{" << std::endl;
+  ostr << "  \"processes\": [";
+
+  bool first = true;
+
+  BOOST_FOREACH (process::name_t const& name, names)
+  {
+    process_t const proc = pipe->process_by_name(name);
+    process_statistics const stats = proc->statistics();
+
+    ostr << (first ? "" : ",") << std::endl;
+    first = false;
+
+    ostr << "    {\"name\": ";
+    write_json_string(ostr, name);
+    ostr << ", \"type\": ";
+    write_json_string(ostr, proc->type());
+    ostr << ", \"steps\": " << stats.steps
+         << ", \"step_wall_ns\": " << stats.step_wall_ns
+         << ", \"step_cpu_ns\": " << stats.step_cpu_ns
+         << ", \"push_blocked_ns\": " << stats.push_blocked_ns
+         << ", \"grab_blocked_ns\": " << stats.grab_blocked_ns
+         << ", \"step_wall_histogram\": {";
+
+    bool first_bucket = true;
+
+    for (size_t i = 0; i < duration_histogram::bucket_count; ++i)
+    {
+      statistic_t const count = stats.step_wall_histogram.buckets[i];
+
+      if (!count)
+      {
+        continue;
+      }
+
+      // Key each bucket by the exclusive upper bound of its durations.
+      statistic_t const bound = (statistic_t(1) << i);
+
+      ostr << (first_bucket ? "" : ", ") << "\"" << bound << "\": " << count;
+      first_bucket = false;
+    }
+
+    ostr << "}}";
+  }
+
+  ostr << std::endl << "  ]," << std::endl;
+  ostr << "  \"edges\": [";
+
+  first = true;
+
+  // Edges only exist once the pipeline has been setup.
+  if (pipe->is_setup() && pipe->setup_successful())
+  {
+    BOOST_FOREACH (process::name_t const& name, names)
+    {
+      process_t const proc = pipe->process_by_name(name);
+      process::ports_t const ports = proc->output_ports();
+
+      BOOST_FOREACH (process::port_t const& port, ports)
+      {
+        process::port_addrs_t const receivers = pipe->receivers_for_port(name, port);
+
+        BOOST_FOREACH (process::port_addr_t const& receiver, receivers)
+        {
+          process::name_t const& down_name = receiver.first;
+          process::port_t const& down_port = receiver.second;
+
+          edge_t const edge = pipe->edge_for_connection(name, port, down_name, down_port);
+
+          if (!edge)
+          {
+            continue;
+          }
+
+          edge_statistics const stats = edge->statistics();
+
+          ostr << (first ? "" : ",") << std::endl;
+          first = false;
+
+          ostr << "    {\"upstream\": ";
+          write_json_string(ostr, name);
+          ostr << ", \"upstream_port\": ";
+          write_json_string(ostr, port);
+          ostr << ", \"downstream\": ";
+          write_json_string(ostr, down_name);
+          ostr << ", \"downstream_port\": ";
+          write_json_string(ostr, down_port);
+          ostr << ", \"pushed\": " << stats.pushed
+               << ", \"grabbed\": " << stats.grabbed
+               << ", \"count\": " << edge->datum_count()
+               << ", \"high_water_mark\": " << stats.high_water_mark
+               << ", \"mean_occupancy\": " << stats.mean_occupancy()
+               << ", \"push_blocked_ns\": " << stats.push_blocked_ns
+               << ", \"grab_blocked_ns\": " << stats.grab_blocked_ns
+               << ", \"dropped\": " << stats.dropped
+               << "}";
+        }
+      }
+    }
+  }
+
+  ostr << std::endl << "  ]" << std::endl;
+  ostr << "}" << std::endl;
+}
+
+void
+write_json_string(std::ostream& ostr, std::string const& str)
+{
+  ostr << '"';
+
+  BOOST_FOREACH (char const ch, str)
+  {
+    switch (ch)
+    {
+      case '"':
+        ostr << "\\\"";
+        break;
+      case '\\':
+        ostr << "\\\\";
+        break;
+      case '\n':
+        ostr << "\\n";
+        break;
+      case '\t':
+        ostr << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20)
+        {
+          std::ios::fmtflags const flags = ostr.flags();
+          char const fill = ostr.fill();
+
+          ostr << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+               << int(static_cast<unsigned char>(ch));
+
+          ostr.flags(flags);
+          ostr.fill(fill);
+        }
+        else
+        {
+          ostr << ch;
+        }
+        break;
+    }
+  }
+
+  ostr << '"';
+}
+
+}
@@ -0,0 +1,186 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_STATISTICS_H
+#define SPROKIT_PIPELINE_STATISTICS_H
+
+#include "pipeline-config.h"
+
+#include "types.h"
+
+#include <boost/cstdint.hpp>
+
+#include <iosfwd>
+
+#include <cstddef>
+
+/**
+ * \file statistics.h
+ *
+ * \brief Runtime statistics for \link process processes\endlink and \link edge edges\endlink.
+ *
+ * Statistics are only collected when sprokit is built with
+ * \c SPROKIT_ENABLE_INSTRUMENTATION. Otherwise, all counters read as zero.
+ * It is off by default since timing each step reads the clocks and takes a
+ * lock on every step.
+ */
+
+namespace sprokit
+{
+
+/// A count of events or nanoseconds.
+typedef boost::uint64_t statistic_t;
+
+/**
+ * \class duration_histogram statistics.h <sprokit/pipeline/statistics.h>
+ *
+ * \brief A histogram of durations with power-of-two buckets.
+ *
+ * Bucket \c 0 counts durations of zero nanoseconds and bucket \c i counts
+ * durations in the range [2<sup>i-1</sup>, 2<sup>i</sup>) nanoseconds. The
+ * last bucket also counts any longer durations.
+ */
+class SPROKIT_PIPELINE_EXPORT duration_histogram
+{
+  public:
+    /**
+     * \brief Constructor.
+     */
+    duration_histogram();
+    /**
+     * \brief Destructor.
+     */
+    ~duration_histogram();
+
+    /**
+     * \brief Count a duration.
+     *
+     * \param ns The duration in nanoseconds.
+     */
+    void add(statistic_t ns);
+
+    /**
+     * \brief The bucket a duration belongs in.
+     *
+     * \param ns The duration in nanoseconds.
+     *
+     * \returns The index of the bucket for \p ns.
+     */
+    static size_t bucket_for(statistic_t ns);
+
+    /// The number of buckets in the histogram.
+    static size_t const bucket_count = 48;
+
+    /// The number of durations in each bucket.
+    statistic_t buckets[bucket_count];
+};
+
+/**
+ * \class process_statistics statistics.h <sprokit/pipeline/statistics.h>
+ *
+ * \brief Statistics about the execution of a \ref process.
+ */
+class SPROKIT_PIPELINE_EXPORT process_statistics
+{
+  public:
+    /**
+     * \brief Constructor.
+     */
+    process_statistics();
+    /**
+     * \brief Destructor.
+     */
+    ~process_statistics();
+
+    /// The number of times the process has been stepped.
+    statistic_t steps;
+    /// Wall time spent within \ref process::_step.
+    statistic_t step_wall_ns;
+    /// Thread CPU time spent within \ref process::_step.
+    statistic_t step_cpu_ns;
+    /// The distribution of wall times of \ref process::_step.
+    duration_histogram step_wall_histogram;
+    /// Time spent waiting for space on output edges.
+    statistic_t push_blocked_ns;
+    /// Time spent waiting for data on input edges.
+    statistic_t grab_blocked_ns;
+};
+
+/**
+ * \class edge_statistics statistics.h <sprokit/pipeline/statistics.h>
+ *
+ * \brief Statistics about the data which has moved through an \ref edge.
+ */
+class SPROKIT_PIPELINE_EXPORT edge_statistics
+{
+  public:
+    /**
+     * \brief Constructor.
+     */
+    edge_statistics();
+    /**
+     * \brief Destructor.
+     */
+    ~edge_statistics();
+
+    /**
+     * \brief The average number of data in the edge after a push.
+     *
+     * \returns The mean occupancy of the edge.
+     */
+    double mean_occupancy() const;
+
+    /// The number of data pushed into the edge.
+    statistic_t pushed;
+    /// The number of data removed from the edge.
+    statistic_t grabbed;
+    /// The largest number of data in the edge at once.
+    statistic_t high_water_mark;
+    /// The sum of the number of data in the edge after each push.
+    statistic_t occupancy_sum;
+    /// Time the upstream process spent waiting for space.
+    statistic_t push_blocked_ns;
+    /// Time the downstream process spent waiting for data.
+    statistic_t grab_blocked_ns;
+    /// The number of data discarded by the overflow policy of the edge.
+    statistic_t dropped;
+};
+
+/**
+ * \brief Write the statistics for a pipeline as JSON.
+ *
+ * \param ostr The stream to write to.
+ * \param pipe The pipeline to report on.
+ */
+SPROKIT_PIPELINE_EXPORT void write_statistics(std::ostream& ostr, pipeline_t const& pipe);
+
+}
+
+#endif // SPROKIT_PIPELINE_STATISTICS_H
@@ -68,6 +68,10 @@ class edge;
 /// A typedef used to handle \link edge edges\endlink.
 typedef boost::shared_ptr<edge> edge_t;
 
+class memory_budget;
+/// A typedef used to handle \link memory_budget memory budgets\endlink.
+typedef boost::shared_ptr<memory_budget> memory_budget_t;
+
 class pipeline;
 /// A typedef used to handle \link pipeline pipelines\endlink.
 typedef boost::shared_ptr<pipeline> pipeline_t;
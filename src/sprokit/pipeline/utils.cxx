@@ -67,6 +67,11 @@
 #include <sys/prctl.h>
 #endif
 
+#ifdef __linux__
+#define PIN_THREAD_USING_SCHED
+#include <sched.h>
+#endif
+
 #if defined(_WIN32) || defined(_WIN64)
 #include <boost/scoped_array.hpp>
 
@@ -75,6 +80,14 @@
 #include <cstdlib>
 #endif
 
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+
 /**
  * \file utils.cxx
  *
@@ -136,6 +149,118 @@ name_thread(thread_name_t const& name)
   return ret;
 }
 
+bool
+pin_thread(cpu_ids_t const& cpus)
+{
+  if (cpus.empty())
+  {
+    return false;
+  }
+
+#ifdef PIN_THREAD_USING_SCHED
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+
+  BOOST_FOREACH (cpu_id_t const cpu, cpus)
+  {
+    if (CPU_SETSIZE <= cpu)
+    {
+      return false;
+    }
+
+    CPU_SET(cpu, &set);
+  }
+
+  // A pid of zero means the calling thread.
+  int const ret = sched_setaffinity(0, sizeof(set), &set);
+
+  return (ret == 0);
+#elif defined(_WIN32) || defined(_WIN64)
+  DWORD_PTR mask = 0;
+
+  BOOST_FOREACH (cpu_id_t const cpu, cpus)
+  {
+    if ((sizeof(DWORD_PTR) * 8) <= cpu)
+    {
+      return false;
+    }
+
+    mask |= (DWORD_PTR(1) << cpu);
+  }
+
+  DWORD_PTR const ret = SetThreadAffinityMask(GetCurrentThread(), mask);
+
+  return (ret != 0);
+#else
+  return false;
+#endif
+}
+
+cpu_ids_opt_t
+parse_cpu_list(std::string const& list)
+{
+  static cpu_id_t const max_cpu_id = 65535;
+
+  typedef std::vector<std::string> parts_t;
+
+  parts_t parts;
+
+  boost::split(parts, list, boost::is_any_of(","));
+
+  cpu_ids_t cpus;
+
+  try
+  {
+    BOOST_FOREACH (std::string part, parts)
+    {
+      boost::trim(part);
+
+      std::string::size_type const dash = part.find('-');
+
+      // Signs would be accepted by the cast, so only allow digits and the
+      // range separator.
+      if ((part.find_first_not_of("0123456789-") != std::string::npos) ||
+          ((dash != std::string::npos) && (part.find('-', dash + 1) != std::string::npos)))
+      {
+        return cpu_ids_opt_t();
+      }
+
+      cpu_id_t first;
+      cpu_id_t last;
+
+      if (dash == std::string::npos)
+      {
+        first = last = boost::lexical_cast<cpu_id_t>(part);
+      }
+      else
+      {
+        first = boost::lexical_cast<cpu_id_t>(part.substr(0, dash));
+        last = boost::lexical_cast<cpu_id_t>(part.substr(dash + 1));
+      }
+
+      if ((last < first) || (max_cpu_id < last))
+      {
+        return cpu_ids_opt_t();
+      }
+
+      for (cpu_id_t cpu = first; cpu <= last; ++cpu)
+      {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  catch (boost::bad_lexical_cast const&)
+  {
+    return cpu_ids_opt_t();
+  }
+
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+
+  return cpus;
+}
+
 envvar_value_t
 get_envvar(envvar_name_t const& name)
 {
@@ -36,6 +36,7 @@
 #include <boost/optional.hpp>
 
 #include <string>
+#include <vector>
 
 /**
  * \file utils.h
@@ -49,6 +50,13 @@ namespace sprokit
 /// The type for the name of a thread.
 typedef std::string thread_name_t;
 
+/// The type for the identifier of a processor.
+typedef unsigned int cpu_id_t;
+/// The type for a set of processors.
+typedef std::vector<cpu_id_t> cpu_ids_t;
+/// The type for a set of processors which may not have been given.
+typedef boost::optional<cpu_ids_t> cpu_ids_opt_t;
+
 /// The type for an environment variable name.
 typedef std::string envvar_name_t;
 /// The type of an environment variable value.
@@ -70,6 +78,30 @@ typedef boost::optional<std::string> envvar_value_t;
  */
 SPROKIT_PIPELINE_EXPORT bool name_thread(thread_name_t const& name);
 
+/**
+ * \brief Restrict the thread that the function was called from to a set of processors.
+ *
+ * \note This is only supported on Linux and Windows. On Windows, only the
+ * first 64 processors may be used.
+ *
+ * \param cpus The processors the thread may run on.
+ *
+ * \returns True if the thread was pinned, false otherwise.
+ */
+SPROKIT_PIPELINE_EXPORT bool pin_thread(cpu_ids_t const& cpus);
+
+/**
+ * \brief Parse a list of processors.
+ *
+ * The list is a comma-separated list of processor numbers or inclusive ranges
+ * such as \c 0-3,8,10-11. Processor numbers may not be above 65535.
+ *
+ * \param list The list to parse.
+ *
+ * \returns The sorted processors in the list, \c NULL if the list is malformed.
+ */
+SPROKIT_PIPELINE_EXPORT cpu_ids_opt_t parse_cpu_list(std::string const& list);
+
 /**
  * \brief Retrieve the value of an environment variable.
  *
@@ -35,6 +35,7 @@
 #include <sprokit/pipeline_util/include-paths.h>
 #endif
 #include "path.h"
+#include "pipe_cache.h"
 #include "pipe_grammar.h"
 
 #include <sprokit/pipeline/pipeline.h>
@@ -65,7 +66,9 @@ static envvar_name_t const sprokit_include_envvar = envvar_name_t("SPROKIT_PIPE_
 static std::string const include_directive = "!include ";
 static char const comment_marker = '#';
 
-static void flatten_pipe_declaration(std::stringstream& sstr, std::istream& istr, path_t const& inc_root);
+static std::string flatten_pipe(std::istream& istr, path_t const& inc_root, paths_t* deps);
+static void flatten_pipe_declaration(std::stringstream& sstr, std::istream& istr, path_t const& inc_root, paths_t* deps);
+static std::string include_search_path();
 static bool is_separator(char ch);
 
 pipe_blocks
@@ -82,22 +85,35 @@ load_pipe_blocks_from_file(path_t const& fname)
 }
 
 pipe_blocks
-load_pipe_blocks(std::istream& istr, path_t const& inc_root)
+load_pipe_blocks_from_file(path_t const& fname, path_t const& cache_dir)
 {
-  std::stringstream sstr;
+  pipe_cache const cache(cache_dir, fname, include_search_path());
 
-  sstr.exceptions(std::stringstream::failbit | std::stringstream::badbit);
+  pipe_blocks blocks;
 
-  try
-  {
-    flatten_pipe_declaration(sstr, istr, inc_root);
-  }
-  catch (std::ios_base::failure const& e)
+  if (cache.load(blocks))
   {
-    throw stream_failure_exception(e.what());
+    return blocks;
   }
 
-  return parse_pipe_blocks_from_string(sstr.str());
+  std::stringstream sstr;
+  std::string const str = fname.string<std::string>();
+
+  sstr << include_directive << str;
+
+  paths_t deps;
+
+  blocks = parse_pipe_blocks_from_string(flatten_pipe(sstr, fname.parent_path(), &deps));
+
+  cache.store(deps, blocks);
+
+  return blocks;
+}
+
+pipe_blocks
+load_pipe_blocks(std::istream& istr, path_t const& inc_root)
+{
+  return parse_pipe_blocks_from_string(flatten_pipe(istr, inc_root, NULL));
 }
 
 cluster_blocks
@@ -114,8 +130,41 @@ load_cluster_blocks_from_file(path_t const& fname)
   return blocks;
 }
 
+cluster_blocks
+load_cluster_blocks_from_file(path_t const& fname, path_t const& cache_dir)
+{
+  pipe_cache const cache(cache_dir, fname, include_search_path());
+
+  cluster_blocks blocks;
+
+  if (cache.load(blocks))
+  {
+    return blocks;
+  }
+
+  std::stringstream sstr;
+  path_t::string_type const& fstr = fname.native();
+  std::string const str(fstr.begin(), fstr.end());
+
+  sstr << include_directive << str;
+
+  paths_t deps;
+
+  blocks = parse_cluster_blocks_from_string(flatten_pipe(sstr, fname.parent_path(), &deps));
+
+  cache.store(deps, blocks);
+
+  return blocks;
+}
+
 cluster_blocks
 load_cluster_blocks(std::istream& istr, path_t const& inc_root)
+{
+  return parse_cluster_blocks_from_string(flatten_pipe(istr, inc_root, NULL));
+}
+
+std::string
+flatten_pipe(std::istream& istr, path_t const& inc_root, paths_t* deps)
 {
   std::stringstream sstr;
 
@@ -123,18 +172,18 @@ load_cluster_blocks(std::istream& istr, path_t const& inc_root)
 
   try
   {
-    flatten_pipe_declaration(sstr, istr, inc_root);
+    flatten_pipe_declaration(sstr, istr, inc_root, deps);
   }
   catch (std::ios_base::failure const& e)
   {
     throw stream_failure_exception(e.what());
   }
 
-  return parse_cluster_blocks_from_string(sstr.str());
+  return sstr.str();
 }
 
 void
-flatten_pipe_declaration(std::stringstream& sstr, std::istream& istr, path_t const& inc_root)
+flatten_pipe_declaration(std::stringstream& sstr, std::istream& istr, path_t const& inc_root, paths_t* deps)
 {
   typedef path_t include_path_t;
   typedef std::vector<include_path_t> include_paths_t;
@@ -215,7 +264,12 @@ flatten_pipe_declaration(std::stringstream& sstr, std::istream& istr, path_t con
         throw file_open_exception(file_path);
       }
 
-      flatten_pipe_declaration(sstr, fin, file_path.parent_path());
+      if (deps)
+      {
+        deps->push_back(file_path);
+      }
+
+      flatten_pipe_declaration(sstr, fin, file_path.parent_path(), deps);
 
       fin.close();
     }
@@ -231,6 +285,19 @@ flatten_pipe_declaration(std::stringstream& sstr, std::istream& istr, path_t con
   }
 }
 
+std::string
+include_search_path()
+{
+  envvar_value_t const extra_include_dirs = get_envvar(sprokit_include_envvar);
+
+  if (!extra_include_dirs)
+  {
+    return default_include_dirs;
+  }
+
+  return (*extra_include_dirs + "\n" + default_include_dirs);
+}
+
 bool
 is_separator(char ch)
 {
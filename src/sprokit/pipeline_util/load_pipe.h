@@ -56,6 +56,19 @@ namespace sprokit
  */
 SPROKIT_PIPELINE_UTIL_EXPORT pipe_blocks load_pipe_blocks_from_file(path_t const& fname);
 
+/**
+ * \brief Convert a pipeline description file into a collection of pipeline blocks using a cache.
+ *
+ * The parsed blocks are stored in \p cache_dir and reused as long as the file
+ * and everything it includes are unchanged.
+ *
+ * \param fname The file to load the pipeline blocks from.
+ * \param cache_dir The directory to keep cached blocks in.
+ *
+ * \returns A new set of pipeline blocks.
+ */
+SPROKIT_PIPELINE_UTIL_EXPORT pipe_blocks load_pipe_blocks_from_file(path_t const& fname, path_t const& cache_dir);
+
 /**
  * \brief Convert a pipeline description into a pipeline.
  *
@@ -75,6 +88,19 @@ SPROKIT_PIPELINE_UTIL_EXPORT pipe_blocks load_pipe_blocks(std::istream& istr, pa
  */
 cluster_blocks SPROKIT_PIPELINE_UTIL_EXPORT load_cluster_blocks_from_file(path_t const& fname);
 
+/**
+ * \brief Convert a cluster description file into a collection of cluster blocks using a cache.
+ *
+ * The parsed blocks are stored in \p cache_dir and reused as long as the file
+ * and everything it includes are unchanged.
+ *
+ * \param fname The file to load the cluster blocks from.
+ * \param cache_dir The directory to keep cached blocks in.
+ *
+ * \returns A new set of cluster blocks.
+ */
+cluster_blocks SPROKIT_PIPELINE_UTIL_EXPORT load_cluster_blocks_from_file(path_t const& fname, path_t const& cache_dir);
+
 /**
  * \brief Convert a cluster description into a cluster.
  *
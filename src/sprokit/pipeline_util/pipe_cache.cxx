@@ -0,0 +1,926 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "pipe_cache.h"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
+#include <boost/variant.hpp>
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstring>
+
+/**
+ * \file pipe_cache.cxx
+ *
+ * \brief Implementation of the cache of parsed pipeline declarations.
+ */
+
+namespace sprokit
+{
+
+namespace
+{
+
+typedef boost::uint64_t cache_word_t;
+typedef std::pair<std::string, cache_word_t> dependency_t;
+typedef std::vector<dependency_t> dependencies_t;
+
+class bad_cache
+{
+};
+
+class cache_writer
+{
+  public:
+    cache_writer();
+    ~cache_writer();
+
+    void write(cache_word_t value);
+    void write(std::string const& str);
+    template <typename T>
+    void write(std::vector<T> const& vec);
+    template <typename T>
+    void write(boost::optional<T> const& opt);
+    template <typename T, typename U>
+    void write(std::pair<T, U> const& pair);
+    void write(config_key_options_t const& options);
+    void write(config_key_t const& key);
+    void write(config_value_t const& value);
+    void write(config_pipe_block const& block);
+    void write(process_pipe_block const& block);
+    void write(connect_pipe_block const& block);
+    void write(cluster_config_t const& config);
+    void write(cluster_input_t const& input);
+    void write(cluster_output_t const& output);
+    void write(cluster_pipe_block const& block);
+    void write(pipe_block const& block);
+    void write(cluster_block const& block);
+    void write(cluster_subblock_t const& subblock);
+
+    std::string const& data() const;
+  private:
+    template <typename V>
+    void write_variant(V const& variant);
+
+    std::string m_data;
+};
+
+class write_visitor
+  : public boost::static_visitor<>
+{
+  public:
+    write_visitor(cache_writer& writer);
+    ~write_visitor();
+
+    template <typename T>
+    void operator () (T const& value) const;
+  private:
+    cache_writer& m_writer;
+};
+
+class cache_reader
+{
+  public:
+    cache_reader(char const* begin, size_t size);
+    ~cache_reader();
+
+    void read(cache_word_t& value);
+    void read(std::string& str);
+    template <typename T>
+    void read(std::vector<T>& vec);
+    template <typename T>
+    void read(boost::optional<T>& opt);
+    template <typename T, typename U>
+    void read(std::pair<T, U>& pair);
+    void read(config_key_options_t& options);
+    void read(config_key_t& key);
+    void read(config_value_t& value);
+    void read(config_pipe_block& block);
+    void read(process_pipe_block& block);
+    void read(connect_pipe_block& block);
+    void read(cluster_config_t& config);
+    void read(cluster_input_t& input);
+    void read(cluster_output_t& output);
+    void read(cluster_pipe_block& block);
+    void read(pipe_block& block);
+    void read(cluster_block& block);
+    void read(cluster_subblock_t& subblock);
+
+    bool done() const;
+  private:
+    template <typename T, typename V>
+    void read_alternative(V& variant);
+    size_t read_count();
+
+    char const* m_pos;
+    char const* const m_end;
+};
+
+template <typename T>
+class block_kind
+{
+};
+
+template <>
+class block_kind<pipe_blocks>
+{
+  public:
+    static cache_word_t const value = 1;
+};
+
+template <>
+class block_kind<cluster_blocks>
+{
+  public:
+    static cache_word_t const value = 2;
+};
+
+}
+
+static char const cache_magic[] = "sprkpipe";
+static size_t const cache_magic_size = (sizeof(cache_magic) - 1);
+static cache_word_t const cache_version = 1;
+static std::string const cache_suffix = std::string(".pipec");
+
+template <typename T>
+static path_t cache_path(path_t const& cache_dir, path_t const& fname, std::string const& include_dirs);
+static cache_word_t hash_bytes(cache_word_t hash, char const* data, size_t size);
+static bool hash_file(path_t const& path, cache_word_t& hash);
+
+pipe_cache
+::pipe_cache(path_t const& cache_dir, path_t const& fname, std::string const& include_dirs)
+  : m_fname(boost::filesystem::absolute(fname))
+  , m_include_dirs(include_dirs)
+  , m_cache_dir(cache_dir)
+{
+}
+
+pipe_cache
+::~pipe_cache()
+{
+}
+
+bool
+pipe_cache
+::load(pipe_blocks& blocks) const
+{
+  return load_blocks(blocks);
+}
+
+bool
+pipe_cache
+::load(cluster_blocks& blocks) const
+{
+  return load_blocks(blocks);
+}
+
+void
+pipe_cache
+::store(paths_t const& deps, pipe_blocks const& blocks) const
+{
+  store_blocks(deps, blocks);
+}
+
+void
+pipe_cache
+::store(paths_t const& deps, cluster_blocks const& blocks) const
+{
+  store_blocks(deps, blocks);
+}
+
+template <typename T>
+bool
+pipe_cache
+::load_blocks(T& blocks) const
+{
+  path_t const path = cache_path<T>(m_cache_dir, m_fname, m_include_dirs);
+
+  boost::system::error_code ec;
+
+  if (!boost::filesystem::is_regular_file(path, ec))
+  {
+    return false;
+  }
+
+  try
+  {
+    boost::interprocess::file_mapping const mapping(path.string<std::string>().c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region const region(mapping, boost::interprocess::read_only);
+
+    cache_reader reader(static_cast<char const*>(region.get_address()), region.get_size());
+
+    std::string magic;
+    cache_word_t version;
+    cache_word_t kind;
+
+    reader.read(magic);
+    reader.read(version);
+    reader.read(kind);
+
+    if ((magic != cache_magic) ||
+        (version != cache_version) ||
+        (kind != block_kind<T>::value))
+    {
+      return false;
+    }
+
+    dependencies_t deps;
+
+    reader.read(deps);
+
+    BOOST_FOREACH (dependency_t const& dep, deps)
+    {
+      cache_word_t hash;
+
+      if (!hash_file(path_t(dep.first), hash) || (hash != dep.second))
+      {
+        return false;
+      }
+    }
+
+    T cached_blocks;
+
+    reader.read(cached_blocks);
+
+    if (!reader.done())
+    {
+      return false;
+    }
+
+    blocks.swap(cached_blocks);
+  }
+  catch (boost::interprocess::interprocess_exception const&)
+  {
+    return false;
+  }
+  catch (bad_cache const&)
+  {
+    /// \todo Log a warning that the cache is corrupt.
+    return false;
+  }
+
+  return true;
+}
+
+template <typename T>
+void
+pipe_cache
+::store_blocks(paths_t const& deps, T const& blocks) const
+{
+  cache_writer writer;
+
+  writer.write(std::string(cache_magic, cache_magic_size));
+  writer.write(cache_version);
+  writer.write(block_kind<T>::value);
+
+  dependencies_t dep_hashes;
+
+  BOOST_FOREACH (path_t const& dep, deps)
+  {
+    cache_word_t hash;
+
+    path_t const abs_dep = boost::filesystem::absolute(dep);
+
+    if (!hash_file(abs_dep, hash))
+    {
+      return;
+    }
+
+    dep_hashes.push_back(dependency_t(abs_dep.string<std::string>(), hash));
+  }
+
+  writer.write(dep_hashes);
+  writer.write(blocks);
+
+  boost::system::error_code ec;
+
+  boost::filesystem::create_directories(m_cache_dir, ec);
+
+  if (ec)
+  {
+    /// \todo Log a warning that the cache directory could not be created.
+    return;
+  }
+
+  path_t const path = cache_path<T>(m_cache_dir, m_fname, m_include_dirs);
+
+  // Write to a temporary file so that concurrent readers never see a partial
+  // cache.
+  path_t const tmp_path = path_t(path.string<std::string>() + "." + boost::filesystem::unique_path().string<std::string>());
+
+  {
+    std::string const& data = writer.data();
+
+    boost::filesystem::ofstream fout(tmp_path, std::ios_base::out | std::ios_base::binary);
+
+    fout.write(data.data(), data.size());
+
+    if (!fout.good())
+    {
+      fout.close();
+      boost::filesystem::remove(tmp_path, ec);
+
+      return;
+    }
+  }
+
+  boost::filesystem::rename(tmp_path, path, ec);
+
+  if (ec)
+  {
+    boost::filesystem::remove(tmp_path, ec);
+  }
+}
+
+template <typename T>
+path_t
+cache_path(path_t const& cache_dir, path_t const& fname, std::string const& include_dirs)
+{
+  cache_word_t const kind = block_kind<T>::value;
+  std::string const fname_str = fname.string<std::string>();
+
+  // Includes are resolved differently if the search path changes.
+  cache_word_t key = hash_bytes(0, reinterpret_cast<char const*>(&kind), sizeof(kind));
+  key = hash_bytes(key, fname_str.data(), fname_str.size());
+  key = hash_bytes(key, include_dirs.data(), include_dirs.size());
+
+  std::ostringstream sstr;
+
+  sstr << std::hex << std::setw(16) << std::setfill('0') << key << cache_suffix;
+
+  return (cache_dir / sstr.str());
+}
+
+cache_word_t
+hash_bytes(cache_word_t hash, char const* data, size_t size)
+{
+  // FNV-1a is used since the hash must be stable between runs.
+  static cache_word_t const fnv_offset = 0xcbf29ce484222325ULL;
+  static cache_word_t const fnv_prime = 0x100000001b3ULL;
+
+  if (!hash)
+  {
+    hash = fnv_offset;
+  }
+
+  for (size_t i = 0; i < size; ++i)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= fnv_prime;
+  }
+
+  return hash;
+}
+
+bool
+hash_file(path_t const& path, cache_word_t& hash)
+{
+  boost::filesystem::ifstream fin(path, std::ios_base::in | std::ios_base::binary);
+
+  if (!fin.good())
+  {
+    return false;
+  }
+
+  static size_t const chunk_size = 65536;
+
+  std::vector<char> buffer(chunk_size);
+
+  hash = 0;
+
+  while (fin)
+  {
+    fin.read(&buffer[0], chunk_size);
+
+    hash = hash_bytes(hash, &buffer[0], size_t(fin.gcount()));
+  }
+
+  return fin.eof();
+}
+
+namespace
+{
+
+cache_writer
+::cache_writer()
+  : m_data()
+{
+}
+
+cache_writer
+::~cache_writer()
+{
+}
+
+void
+cache_writer
+::write(cache_word_t value)
+{
+  m_data.append(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+
+void
+cache_writer
+::write(std::string const& str)
+{
+  write(cache_word_t(str.size()));
+
+  m_data.append(str);
+}
+
+template <typename T>
+void
+cache_writer
+::write(std::vector<T> const& vec)
+{
+  write(cache_word_t(vec.size()));
+
+  BOOST_FOREACH (T const& elem, vec)
+  {
+    write(elem);
+  }
+}
+
+template <typename T>
+void
+cache_writer
+::write(boost::optional<T> const& opt)
+{
+  write(cache_word_t(opt ? 1 : 0));
+
+  if (opt)
+  {
+    write(*opt);
+  }
+}
+
+template <typename T, typename U>
+void
+cache_writer
+::write(std::pair<T, U> const& pair)
+{
+  write(pair.first);
+  write(pair.second);
+}
+
+void
+cache_writer
+::write(config_key_options_t const& options)
+{
+  write(options.flags);
+  write(options.provider);
+}
+
+void
+cache_writer
+::write(config_key_t const& key)
+{
+  write(key.key_path);
+  write(key.options);
+}
+
+void
+cache_writer
+::write(config_value_t const& value)
+{
+  write(value.key);
+  write(value.value);
+}
+
+void
+cache_writer
+::write(config_pipe_block const& block)
+{
+  write(block.key);
+  write(block.values);
+}
+
+void
+cache_writer
+::write(process_pipe_block const& block)
+{
+  write(block.name);
+  write(block.type);
+  write(block.config_values);
+}
+
+void
+cache_writer
+::write(connect_pipe_block const& block)
+{
+  write(block.from);
+  write(block.to);
+}
+
+void
+cache_writer
+::write(cluster_config_t const& config)
+{
+  write(config.description);
+  write(config.config_value);
+}
+
+void
+cache_writer
+::write(cluster_input_t const& input)
+{
+  write(input.description);
+  write(input.from);
+  write(input.targets);
+}
+
+void
+cache_writer
+::write(cluster_output_t const& output)
+{
+  write(output.description);
+  write(output.from);
+  write(output.to);
+}
+
+void
+cache_writer
+::write(cluster_pipe_block const& block)
+{
+  write(block.type);
+  write(block.description);
+  write(block.subblocks);
+}
+
+void
+cache_writer
+::write(pipe_block const& block)
+{
+  write_variant(block);
+}
+
+void
+cache_writer
+::write(cluster_block const& block)
+{
+  write_variant(block);
+}
+
+void
+cache_writer
+::write(cluster_subblock_t const& subblock)
+{
+  write_variant(subblock);
+}
+
+std::string const&
+cache_writer
+::data() const
+{
+  return m_data;
+}
+
+template <typename V>
+void
+cache_writer
+::write_variant(V const& variant)
+{
+  write(cache_word_t(variant.which()));
+
+  boost::apply_visitor(write_visitor(*this), variant);
+}
+
+write_visitor
+::write_visitor(cache_writer& writer)
+  : m_writer(writer)
+{
+}
+
+write_visitor
+::~write_visitor()
+{
+}
+
+template <typename T>
+void
+write_visitor
+::operator () (T const& value) const
+{
+  m_writer.write(value);
+}
+
+cache_reader
+::cache_reader(char const* begin, size_t size)
+  : m_pos(begin)
+  , m_end(begin + size)
+{
+}
+
+cache_reader
+::~cache_reader()
+{
+}
+
+void
+cache_reader
+::read(cache_word_t& value)
+{
+  if (size_t(m_end - m_pos) < sizeof(value))
+  {
+    throw bad_cache();
+  }
+
+  // The mapping may not be aligned for the word.
+  memcpy(&value, m_pos, sizeof(value));
+  m_pos += sizeof(value);
+}
+
+void
+cache_reader
+::read(std::string& str)
+{
+  size_t const size = read_count();
+
+  str.assign(m_pos, size);
+  m_pos += size;
+}
+
+template <typename T>
+void
+cache_reader
+::read(std::vector<T>& vec)
+{
+  size_t const size = read_count();
+
+  vec.resize(size);
+
+  BOOST_FOREACH (T& elem, vec)
+  {
+    read(elem);
+  }
+}
+
+template <typename T>
+void
+cache_reader
+::read(boost::optional<T>& opt)
+{
+  cache_word_t present;
+
+  read(present);
+
+  if (present)
+  {
+    T value;
+
+    read(value);
+
+    opt = value;
+  }
+  else
+  {
+    opt = boost::none;
+  }
+}
+
+template <typename T, typename U>
+void
+cache_reader
+::read(std::pair<T, U>& pair)
+{
+  read(pair.first);
+  read(pair.second);
+}
+
+void
+cache_reader
+::read(config_key_options_t& options)
+{
+  read(options.flags);
+  read(options.provider);
+}
+
+void
+cache_reader
+::read(config_key_t& key)
+{
+  read(key.key_path);
+  read(key.options);
+}
+
+void
+cache_reader
+::read(config_value_t& value)
+{
+  read(value.key);
+  read(value.value);
+}
+
+void
+cache_reader
+::read(config_pipe_block& block)
+{
+  read(block.key);
+  read(block.values);
+}
+
+void
+cache_reader
+::read(process_pipe_block& block)
+{
+  read(block.name);
+  read(block.type);
+  read(block.config_values);
+}
+
+void
+cache_reader
+::read(connect_pipe_block& block)
+{
+  read(block.from);
+  read(block.to);
+}
+
+void
+cache_reader
+::read(cluster_config_t& config)
+{
+  read(config.description);
+  read(config.config_value);
+}
+
+void
+cache_reader
+::read(cluster_input_t& input)
+{
+  read(input.description);
+  read(input.from);
+  read(input.targets);
+}
+
+void
+cache_reader
+::read(cluster_output_t& output)
+{
+  read(output.description);
+  read(output.from);
+  read(output.to);
+}
+
+void
+cache_reader
+::read(cluster_pipe_block& block)
+{
+  read(block.type);
+  read(block.description);
+  read(block.subblocks);
+}
+
+void
+cache_reader
+::read(pipe_block& block)
+{
+  cache_word_t which;
+
+  read(which);
+
+  switch (which)
+  {
+    case 0:
+      read_alternative<config_pipe_block>(block);
+      break;
+    case 1:
+      read_alternative<process_pipe_block>(block);
+      break;
+    case 2:
+      read_alternative<connect_pipe_block>(block);
+      break;
+    default:
+      throw bad_cache();
+  }
+}
+
+void
+cache_reader
+::read(cluster_block& block)
+{
+  cache_word_t which;
+
+  read(which);
+
+  switch (which)
+  {
+    case 0:
+      read_alternative<config_pipe_block>(block);
+      break;
+    case 1:
+      read_alternative<process_pipe_block>(block);
+      break;
+    case 2:
+      read_alternative<connect_pipe_block>(block);
+      break;
+    case 3:
+      read_alternative<cluster_pipe_block>(block);
+      break;
+    default:
+      throw bad_cache();
+  }
+}
+
+void
+cache_reader
+::read(cluster_subblock_t& subblock)
+{
+  cache_word_t which;
+
+  read(which);
+
+  switch (which)
+  {
+    case 0:
+      read_alternative<cluster_config_t>(subblock);
+      break;
+    case 1:
+      read_alternative<cluster_input_t>(subblock);
+      break;
+    case 2:
+      read_alternative<cluster_output_t>(subblock);
+      break;
+    default:
+      throw bad_cache();
+  }
+}
+
+bool
+cache_reader
+::done() const
+{
+  return (m_pos == m_end);
+}
+
+template <typename T, typename V>
+void
+cache_reader
+::read_alternative(V& variant)
+{
+  T value;
+
+  read(value);
+
+  variant = value;
+}
+
+size_t
+cache_reader
+::read_count()
+{
+  cache_word_t count;
+
+  read(count);
+
+  // Every element takes at least a byte, so larger counts are corrupt.
+  if (count > cache_word_t(m_end - m_pos))
+  {
+    throw bad_cache();
+  }
+
+  return size_t(count);
+}
+
+}
+
+}
@@ -0,0 +1,120 @@
+/*ckwg +29
+ * Copyright 2013 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_UTIL_PIPE_CACHE_H
+#define SPROKIT_PIPELINE_UTIL_PIPE_CACHE_H
+
+#include "pipeline_util-config.h"
+
+#include "path.h"
+#include "pipe_declaration_types.h"
+
+#include <string>
+
+/**
+ * \file pipe_cache.h
+ *
+ * \brief A cache of parsed pipeline declarations.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class pipe_cache pipe_cache.h "pipe_cache.h"
+ *
+ * \brief A binary cache of the blocks parsed from a declaration file.
+ *
+ * Each declaration file has its own cache file within the cache directory. The
+ * cache records the contents of every file which went into the blocks and is
+ * ignored if any of them have changed. The cache is stored in the native byte
+ * order and is not meant to be shared between machines.
+ */
+class SPROKIT_PIPELINE_UTIL_NO_EXPORT pipe_cache
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param cache_dir The directory to store caches in.
+     * \param fname The declaration file to cache.
+     * \param include_dirs The directories searched for includes.
+     */
+    pipe_cache(path_t const& cache_dir, path_t const& fname, std::string const& include_dirs);
+    /**
+     * \brief Destructor.
+     */
+    ~pipe_cache();
+
+    /**
+     * \brief Load blocks from the cache.
+     *
+     * \param blocks Where to store the blocks.
+     *
+     * \returns True if the cache was up-to-date, false otherwise.
+     */
+    bool load(pipe_blocks& blocks) const;
+    /**
+     * \brief Load blocks from the cache.
+     *
+     * \param blocks Where to store the blocks.
+     *
+     * \returns True if the cache was up-to-date, false otherwise.
+     */
+    bool load(cluster_blocks& blocks) const;
+
+    /**
+     * \brief Store blocks in the cache.
+     *
+     * \param deps The files which were read to create the blocks.
+     * \param blocks The blocks to store.
+     */
+    void store(paths_t const& deps, pipe_blocks const& blocks) const;
+    /**
+     * \brief Store blocks in the cache.
+     *
+     * \param deps The files which were read to create the blocks.
+     * \param blocks The blocks to store.
+     */
+    void store(paths_t const& deps, cluster_blocks const& blocks) const;
+  private:
+    template <typename T>
+    bool load_blocks(T& blocks) const;
+    template <typename T>
+    void store_blocks(paths_t const& deps, T const& blocks) const;
+
+    path_t const m_fname;
+    std::string const m_include_dirs;
+    path_t const m_cache_dir;
+};
+
+}
+
+#endif // SPROKIT_PIPELINE_UTIL_PIPE_CACHE_H
@@ -51,6 +51,7 @@
 #include <boost/bind.hpp>
 
 #include <algorithm>
+#include <iostream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -62,6 +63,7 @@ namespace
 {
 
 static std::string const split_str = "=";
+static sprokit::path_t const stdin_path = sprokit::path_t("-");
 
 }
 
@@ -79,11 +81,20 @@ ::pipeline_builder(boost::program_options::variables_map const& vm, boost::progr
   {
     sprokit::path_t const ipath = vm["pipeline"].as<sprokit::path_t>();
 
-    istream_t const istr = open_istream(ipath);
+    if (vm.count("pipe-cache") && (ipath != stdin_path))
+    {
+      sprokit::path_t const cache_dir = vm["pipe-cache"].as<sprokit::path_t>();
 
-    /// \todo Include paths?
+      m_blocks = sprokit::load_pipe_blocks_from_file(ipath, cache_dir);
+    }
+    else
+    {
+      istream_t const istr = open_istream(ipath);
 
-    load_pipeline(*istr);
+      /// \todo Include paths?
+
+      load_pipeline(*istr);
+    }
   }
 
   load_from_options(vm);
@@ -237,6 +248,7 @@ pipeline_input_options()
 
   desc.add_options()
     ("pipeline,p", boost::program_options::value<sprokit::path_t>()->value_name("FILE"), "pipeline")
+    ("pipe-cache", boost::program_options::value<sprokit::path_t>()->value_name("DIR"), "directory to cache parsed pipelines in")
   ;
 
   return desc;
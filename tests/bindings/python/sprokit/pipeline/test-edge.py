@@ -75,6 +75,7 @@ def test_api_calls():
     e.has_data()
     e.full_of_data()
     e.datum_count()
+    e.buffered_bytes()
 
     d = datum.complete()
     s = stamp.new_stamp(1)
@@ -102,6 +103,8 @@ def test_api_calls():
 
     e.config_dependency
     e.config_capacity
+    e.config_capacity_bytes
+    e.config_overflow_policy
 
 
 def test_datum_api_calls():
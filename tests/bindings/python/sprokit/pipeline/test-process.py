@@ -97,9 +97,11 @@ def test_api_calls():
     process.PythonProcess.property_no_reentrancy
     process.PythonProcess.property_unsync_input
     process.PythonProcess.property_unsync_output
+    process.PythonProcess.property_replicable
     process.PythonProcess.port_heartbeat
     process.PythonProcess.config_name
     process.PythonProcess.config_type
+    process.PythonProcess.config_replicas
     process.PythonProcess.type_any
     process.PythonProcess.type_none
     process.PythonProcess.type_data_dependent
@@ -261,6 +263,177 @@ def test_flags_as_set():
         test_error(".update() does not work: expected 4, got %d" % len(a))
 
 
+def setup_single_process(proc):
+    from sprokit.pipeline import pipeline
+
+    p = pipeline.Pipeline()
+
+    p.add_process(proc)
+    p.setup_pipeline()
+
+    return p
+
+
+def test_class_override():
+    from sprokit.pipeline import config
+    from sprokit.pipeline import process
+
+    class Counter(process.PythonProcess):
+        def __init__(self, conf):
+            process.PythonProcess.__init__(self, conf)
+
+            self.configured = False
+            self.steps = 0
+
+        def _configure(self):
+            self.configured = True
+
+            self._base_configure()
+
+        def _step(self):
+            self.steps += 1
+
+            self._base_step()
+
+    c = config.empty_config()
+    c.set_value(process.PythonProcess.config_name, 'counter')
+
+    proc = Counter(c)
+
+    # Keep the pipeline alive while stepping.
+    p = setup_single_process(proc)
+
+    if not proc.configured:
+        test_error("A class override of _configure was not called")
+
+    proc.step()
+    proc.step()
+
+    if not proc.steps == 2:
+        test_error("A class override of _step was called %d times rather than 2" % proc.steps)
+
+
+def test_instance_override():
+    from sprokit.pipeline import config
+    from sprokit.pipeline import process
+
+    calls = []
+
+    c = config.empty_config()
+    c.set_value(process.PythonProcess.config_name, 'instance')
+
+    proc = process.PythonProcess(c)
+
+    proc._step = lambda: calls.append('first')
+
+    # Keep the pipeline alive while stepping.
+    p = setup_single_process(proc)
+
+    proc.step()
+
+    # Instance attributes are looked up on every call, so a replacement is seen.
+    proc._step = lambda: calls.append('second')
+
+    proc.step()
+
+    if not calls == ['first', 'second']:
+        test_error("Instance overrides of _step were not looked up on each call: %s" % calls)
+
+
+def test_grab_push_with_gil_held():
+    from sprokit.pipeline import config
+    from sprokit.pipeline import datum
+    from sprokit.pipeline import edge
+    from sprokit.pipeline import modules
+    from sprokit.pipeline import pipeline
+    from sprokit.pipeline import process
+    from sprokit.pipeline import process_registry
+    from sprokit.pipeline import stamp
+    import threading
+    import time
+
+    stepping = threading.Event()
+
+    class Pass(process.PythonProcess):
+        def __init__(self, conf):
+            process.PythonProcess.__init__(self, conf)
+
+            # The input is not required so that the step itself waits on the edge.
+            self.declare_input_port('input', 'integer', process.PortFlags(), 'input port')
+            self.declare_output_port('output', 'integer', process.PortFlags(), 'output port')
+
+        def _step(self):
+            stepping.set()
+
+            self.push_value_to_port('output', self.grab_value_from_port('input'))
+
+            self._base_step()
+
+    modules.load_known_modules()
+
+    reg = process_registry.ProcessRegistry.self()
+
+    c = config.empty_config()
+    c.set_value(process.PythonProcess.config_name, 'pass')
+
+    proc = Pass(c)
+    source = reg.create_process('numbers', 'source', config.empty_config())
+    sink = reg.create_process('sink', 'sink', config.empty_config())
+
+    pc = config.empty_config()
+    pc.set_value('_edge:capacity', '1')
+
+    p = pipeline.Pipeline(pc)
+
+    p.add_process(source)
+    p.add_process(proc)
+    p.add_process(sink)
+
+    p.connect('source', 'number',
+              'pass', 'input')
+    p.connect('pass', 'output',
+              'sink', 'sink')
+
+    p.setup_pipeline()
+
+    iedge = p.input_edge_for_port('pass', 'input')
+    oedge = p.input_edge_for_port('sink', 'sink')
+
+    s = stamp.new_stamp(1)
+
+    # Fill the output so that pushing has to wait as well.
+    oedge.push_datum(edge.EdgeDatum(datum.new(0), s))
+
+    t = threading.Thread(target=proc.step)
+    t.daemon = True
+    t.start()
+
+    # Give the step time to start waiting on its input; this thread then needs
+    # the GIL back to run at all.
+    stepping.wait()
+    time.sleep(0.1)
+
+    total = 0
+    for i in range(10000):
+        total += i
+
+    iedge.push_datum(edge.EdgeDatum(datum.new(total), stamp.incremented_stamp(s)))
+
+    oedge.get_datum()
+
+    t.join(5)
+
+    if t.is_alive():
+        test_error("A step waiting on an edge did not let other threads run")
+
+        return
+
+    res = oedge.get_datum().datum.get_datum()
+
+    if not res == total:
+        test_error("Passed %d through the process rather than %d" % (res, total))
+
+
 if __name__ == '__main__':
     import os
     import sys
@@ -47,6 +47,7 @@ def test_api_calls():
     process_cluster.PythonProcessCluster.property_no_reentrancy
     process_cluster.PythonProcessCluster.property_unsync_input
     process_cluster.PythonProcessCluster.property_unsync_output
+    process_cluster.PythonProcessCluster.property_replicable
     process_cluster.PythonProcessCluster.type_any
     process_cluster.PythonProcessCluster.type_none
     process_cluster.PythonProcessCluster.type_data_dependent
@@ -68,9 +68,11 @@ def test_api_calls():
     process_registry.Process.property_no_reentrancy
     process_registry.Process.property_unsync_input
     process_registry.Process.property_unsync_output
+    process_registry.Process.property_replicable
     process_registry.Process.port_heartbeat
     process_registry.Process.config_name
     process_registry.Process.config_type
+    process_registry.Process.config_replicas
     process_registry.Process.type_any
     process_registry.Process.type_none
     process_registry.Process.type_data_dependent
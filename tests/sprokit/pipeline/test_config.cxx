@@ -32,6 +32,8 @@
 
 #include <sprokit/pipeline/config.h>
 
+#include <algorithm>
+
 #define TEST_ARGS ()
 
 DECLARE_TEST_MAP();
@@ -160,6 +162,49 @@ IMPLEMENT_TEST(get_value_type_mismatch)
   }
 }
 
+IMPLEMENT_TEST(get_value_after_set)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::key_t const block_name = sprokit::config::key_t("block");
+  sprokit::config::key_t const keya = sprokit::config::key_t("keya");
+
+  sprokit::config_t const subblock = config->subblock_view(block_name);
+
+  subblock->set_value(keya, sprokit::config::value_t("1"));
+
+  if (subblock->get_value<int>(keya) != 1)
+  {
+    TEST_ERROR("Did not retrieve the typed value that was set");
+  }
+
+  config->set_value(block_name + sprokit::config::block_sep + keya, sprokit::config::value_t("2"));
+
+  if (subblock->get_value<int>(keya) != 2)
+  {
+    TEST_ERROR("A changed value was not seen after a typed read");
+  }
+
+  if (subblock->get_value<long>(keya) != 2)
+  {
+    TEST_ERROR("Reading a value as another type did not convert it");
+  }
+
+  subblock->set_value(keya, sprokit::config::value_t("not_a_number"));
+
+  if (subblock->get_value<int>(keya, 3) != 3)
+  {
+    TEST_ERROR("A stale typed value was returned after the value changed");
+  }
+
+  subblock->unset_value(keya);
+
+  if (subblock->get_value<int>(keya, 4) != 4)
+  {
+    TEST_ERROR("A typed value was returned after the value was unset");
+  }
+}
+
 IMPLEMENT_TEST(bool_conversion)
 {
   sprokit::config_t const config = sprokit::config::empty_config();
@@ -590,6 +635,61 @@ IMPLEMENT_TEST(subblock_view_nested)
   }
 }
 
+IMPLEMENT_TEST(subblock_view_of_view)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::key_t const block_name = sprokit::config::key_t("block");
+  sprokit::config::key_t const other_block_name = sprokit::config::key_t("other_block");
+  sprokit::config::key_t const nested_block_name = block_name + sprokit::config::block_sep + other_block_name;
+
+  sprokit::config::key_t const keya = sprokit::config::key_t("keya");
+  sprokit::config::key_t const keyb = sprokit::config::key_t("keyb");
+  sprokit::config::key_t const global_key = sprokit::config::global_value + sprokit::config::block_sep + keya;
+
+  sprokit::config::value_t const valuea = sprokit::config::value_t("valuea");
+  sprokit::config::value_t const valueb = sprokit::config::value_t("valueb");
+
+  config->set_value(nested_block_name + sprokit::config::block_sep + keya, valuea);
+  config->set_value(block_name + sprokit::config::block_sep + keyb, valueb);
+  config->set_value(global_key, valuea);
+
+  sprokit::config_t const subblock = config->subblock_view(block_name)->subblock_view(other_block_name);
+
+  sprokit::config::value_t const get_valuea = subblock->get_value<sprokit::config::value_t>(keya);
+
+  if (valuea != get_valuea)
+  {
+    TEST_ERROR("A view of a view did not inherit expected keys");
+  }
+
+  if (subblock->has_value(keyb))
+  {
+    TEST_ERROR("A view of a view inherited a key from its parent block");
+  }
+
+  subblock->set_value(keyb, valueb);
+
+  sprokit::config::value_t const get_valueb = config->get_value<sprokit::config::value_t>(nested_block_name + sprokit::config::block_sep + keyb);
+
+  if (valueb != get_valueb)
+  {
+    TEST_ERROR("A value set through a view of a view was not set in the root");
+  }
+
+  sprokit::config::keys_t const keys = subblock->available_values();
+
+  if (keys.size() != 3)
+  {
+    TEST_ERROR("Did not retrieve correct number of keys from a view of a view");
+  }
+
+  if (std::count(keys.begin(), keys.end(), global_key) != 1)
+  {
+    TEST_ERROR("A global key is not available through a view of a view");
+  }
+}
+
 IMPLEMENT_TEST(subblock_view_match)
 {
   sprokit::config_t const config = sprokit::config::empty_config();
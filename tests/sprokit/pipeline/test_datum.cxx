@@ -32,10 +32,38 @@
 
 #include <sprokit/pipeline/datum.h>
 
+#include <boost/array.hpp>
+
+#include <vector>
+
 #define TEST_ARGS ()
 
 DECLARE_TEST_MAP();
 
+namespace
+{
+
+class sized_payload
+{
+  public:
+    size_t bytes;
+};
+
+}
+
+namespace sprokit
+{
+
+template <>
+size_t
+datum_size<sized_payload>
+::size(sized_payload const& value)
+{
+  return value.bytes;
+}
+
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -149,3 +177,144 @@ IMPLEMENT_TEST(new)
                    dat->get_datum<std::string>(),
                    "retrieving an int as a string");
 }
+
+IMPLEMENT_TEST(new_ref)
+{
+  std::vector<int> const datum(1000, 100);
+  sprokit::datum_t const dat = sprokit::datum::new_datum(datum);
+
+  std::vector<int> const& ref = dat->get_datum_ref<std::vector<int> >();
+  std::vector<int> const& ref2 = dat->get_datum_ref<std::vector<int> >();
+
+  if (datum != ref)
+  {
+    TEST_ERROR("Did not get same value out as put into datum");
+  }
+
+  if (&ref != &ref2)
+  {
+    TEST_ERROR("Accessing a datum by reference made a copy");
+  }
+
+  EXPECT_EXCEPTION(sprokit::bad_datum_cast_exception,
+                   dat->get_datum_ref<int>(),
+                   "retrieving a vector as an int");
+}
+
+IMPLEMENT_TEST(new_large)
+{
+  typedef boost::array<double, 32> large_t;
+
+  large_t datum;
+
+  for (size_t i = 0; i < datum.size(); ++i)
+  {
+    datum[i] = double(i);
+  }
+
+  sprokit::datum_t const dat = sprokit::datum::new_datum(datum);
+
+  large_t const get_datum = dat->get_datum<large_t>();
+
+  if (datum != get_datum)
+  {
+    TEST_ERROR("Did not get same value out as put into datum");
+  }
+}
+
+IMPLEMENT_TEST(new_any)
+{
+  int const datum = 100;
+  sprokit::datum_t const dat = sprokit::datum::new_datum(boost::any(datum));
+
+  int const get_datum = dat->get_datum<int>();
+
+  if (datum != get_datum)
+  {
+    TEST_ERROR("Did not get same value out of a datum created from an any");
+  }
+
+  EXPECT_EXCEPTION(sprokit::bad_datum_cast_exception,
+                   dat->get_datum<std::string>(),
+                   "retrieving an int as a string from an any");
+
+  sprokit::datum_t const dat_typed = sprokit::datum::new_datum(datum);
+
+  boost::any const any = dat_typed->get_datum<boost::any>();
+
+  if (boost::any_cast<int>(any) != datum)
+  {
+    TEST_ERROR("Did not get same value out of a datum as an any");
+  }
+}
+
+IMPLEMENT_TEST(many)
+{
+  typedef std::vector<sprokit::datum_t> datums_t;
+
+  static size_t const count = 10000;
+
+  // Datums are recycled through a pool; make sure that live datums keep
+  // their values while others are released and reallocated.
+  datums_t datums;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    datums.push_back(sprokit::datum::new_datum(i));
+  }
+
+  for (size_t i = 0; i < count; i += 2)
+  {
+    datums[i] = sprokit::datum::error_datum("released");
+  }
+
+  for (size_t i = 0; i < count; i += 2)
+  {
+    datums[i] = sprokit::datum::new_datum(i);
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    size_t const value = datums[i]->get_datum<size_t>();
+
+    if (value != i)
+    {
+      TEST_ERROR("Datum " << i << " has the value " << value << " after "
+                 "other datums were recycled");
+    }
+  }
+}
+
+IMPLEMENT_TEST(size)
+{
+  if (sprokit::datum::empty_datum()->size())
+  {
+    TEST_ERROR("An empty datum holds memory");
+  }
+
+  if (sprokit::datum::error_datum("An error")->size())
+  {
+    TEST_ERROR("An error datum holds memory");
+  }
+
+  if (sprokit::datum::new_datum(100)->size() != sizeof(int))
+  {
+    TEST_ERROR("The size of a plain datum is not the size of its type");
+  }
+
+  std::vector<int> const vec(16);
+
+  if (sprokit::datum::new_datum(vec)->size() < (16 * sizeof(int)))
+  {
+    TEST_ERROR("The size of a vector datum does not include its elements");
+  }
+
+  sized_payload payload;
+
+  payload.bytes = 1 << 20;
+
+  if (sprokit::datum::new_datum(payload)->size() != payload.bytes)
+  {
+    TEST_ERROR("The size of a datum does not use the size hook of its type");
+  }
+}
@@ -34,6 +34,7 @@
 #include <sprokit/pipeline/datum.h>
 #include <sprokit/pipeline/edge.h>
 #include <sprokit/pipeline/edge_exception.h>
+#include <sprokit/pipeline/memory_budget.h>
 #include <sprokit/pipeline/modules.h>
 #include <sprokit/pipeline/process_registry.h>
 #include <sprokit/pipeline/stamp.h>
@@ -47,6 +48,7 @@
 #endif
 #include <boost/thread/thread.hpp>
 #include <boost/bind.hpp>
+#include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 
 #define TEST_ARGS ()
@@ -452,6 +454,974 @@ IMPLEMENT_TEST(capacity)
   }
 }
 
+IMPLEMENT_TEST(datum_references)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::datum_t const dat = sprokit::datum::new_datum(100);
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(sprokit::stamp::increment_t(1));
+
+  sprokit::edge_datum_t edat = sprokit::edge_datum_t(dat, stamp);
+
+#ifdef SPROKIT_HAVE_MOVE_OVERLOADS
+  edge->push_datum(std::move(edat));
+
+  if (edat.datum || edat.stamp)
+  {
+    TEST_ERROR("Pushing an rvalue into an edge did not move from it");
+  }
+#else
+  edge->push_datum(edat);
+
+  edat = sprokit::edge_datum_t();
+#endif
+
+  if (dat.use_count() != 2)
+  {
+    TEST_ERROR("The edge holds an unexpected number of references to the datum");
+  }
+
+  sprokit::edge_datum_t const got = edge->get_datum();
+
+  if (got.datum != dat)
+  {
+    TEST_ERROR("The pushed datum was not extracted from the edge");
+  }
+
+  if (dat.use_count() != 2)
+  {
+    TEST_ERROR("The edge kept a reference to an extracted datum");
+  }
+}
+
+static sprokit::edge_data_t make_data(size_t count);
+static void push_data(sprokit::edge_t edge, sprokit::edge_data_t data);
+
+IMPLEMENT_TEST(push_get_data)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(5);
+
+  edge->push_data(data);
+
+  if (edge->datum_count() != data.size())
+  {
+    TEST_ERROR("An edge does not have all of the pushed data");
+  }
+
+  sprokit::edge_data_t const first = edge->get_data(2);
+  sprokit::edge_data_t const rest = edge->get_data(3);
+
+  if (first.size() != 2 || rest.size() != 3)
+  {
+    TEST_ERROR("The wrong number of data were extracted from an edge");
+  }
+
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    sprokit::edge_datum_t const& edat = ((i < 2) ? first[i] : rest[i - 2]);
+
+    if (!(edat == data[i]))
+    {
+      TEST_ERROR("Datum " << i << " was not extracted in order");
+    }
+  }
+
+  if (edge->has_data())
+  {
+    TEST_ERROR("An edge has data after all of it was extracted");
+  }
+}
+
+IMPLEMENT_TEST(push_data_capacity)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(2);
+
+  config->set_value(sprokit::edge::config_capacity, value_capacity);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(10);
+
+  // The batch is larger than the edge, so it must trickle in as the data is
+  // extracted.
+  boost::thread thread = boost::thread(boost::bind(&push_data, edge, data));
+
+  sprokit::edge_data_t const got = edge->get_data(data.size());
+
+  thread.join();
+
+  if (got.size() != data.size())
+  {
+    TEST_ERROR("The wrong number of data were extracted from a bounded edge");
+  }
+
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    if (!(got[i] == data[i]))
+    {
+      TEST_ERROR("Datum " << i << " was not extracted in order from a bounded edge");
+    }
+  }
+}
+
+IMPLEMENT_TEST(has_space_for)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(3);
+
+  config->set_value(sprokit::edge::config_capacity, value_capacity);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(1);
+
+  edge->push_datum(data[0]);
+
+  if (!edge->has_space_for(2))
+  {
+    TEST_ERROR("An edge does not have space for data within its capacity");
+  }
+
+  if (edge->has_space_for(3))
+  {
+    TEST_ERROR("An edge has space for data beyond its capacity");
+  }
+
+  sprokit::config_t const config_bytes = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity_bytes = boost::lexical_cast<sprokit::config::value_t>(1024);
+
+  config_bytes->set_value(sprokit::edge::config_capacity_bytes, value_capacity_bytes);
+
+  sprokit::edge_t const edge_bytes = boost::make_shared<sprokit::edge>(config_bytes);
+
+  if (!edge_bytes->has_space_for(1))
+  {
+    TEST_ERROR("An empty edge with a memory capacity does not have space for a datum");
+  }
+
+  if (edge_bytes->has_space_for(2))
+  {
+    TEST_ERROR("An edge with a memory capacity promised space for data of unknown size");
+  }
+}
+
+IMPLEMENT_TEST(push_data_into_complete_batch)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  edge->mark_downstream_as_complete();
+
+  edge->push_data(make_data(3));
+
+  if (edge->has_data())
+  {
+    TEST_ERROR("Data was pushed into a complete edge");
+  }
+
+  EXPECT_EXCEPTION(sprokit::datum_requested_after_complete,
+                   edge->get_data(1),
+                   "requesting data after it is complete");
+}
+
+static sprokit::config_t lock_free_config(size_t capacity);
+
+IMPLEMENT_TEST(lock_free_push_get)
+{
+  sprokit::config_t const config = lock_free_config(2);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat1 = sprokit::datum::empty_datum();
+  sprokit::datum_t const dat2 = sprokit::datum::complete_datum();
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+
+  sprokit::edge_datum_t const edat1 = sprokit::edge_datum_t(dat1, stamp1);
+  sprokit::edge_datum_t const edat2 = sprokit::edge_datum_t(dat2, stamp2);
+
+  edge->push_datum(edat1);
+  edge->push_datum(edat2);
+
+  if (!edge->full_of_data())
+  {
+    TEST_ERROR("A lock-free edge is not full at capacity");
+  }
+
+  sprokit::edge_datum_t const peek_edat = edge->peek_datum(1);
+
+  if (peek_edat.datum != dat2)
+  {
+    TEST_ERROR("A lock-free edge did not peek at the right datum");
+  }
+
+  sprokit::edge_datum_t const get_edat1 = edge->get_datum();
+
+  if (get_edat1.datum != dat1)
+  {
+    TEST_ERROR("A lock-free edge did not return data in order");
+  }
+
+  // Wrap around the end of the ring.
+  edge->push_datum(edat1);
+  edge->pop_datum();
+
+  sprokit::edge_datum_t const get_edat2 = edge->get_datum();
+
+  if (get_edat2.datum != dat1)
+  {
+    TEST_ERROR("A lock-free edge did not return data in order after wrapping");
+  }
+
+  if (edge->has_data())
+  {
+    TEST_ERROR("A lock-free edge has data after removing all of it");
+  }
+}
+
+IMPLEMENT_TEST(lock_free_push_data_into_complete)
+{
+  sprokit::config_t const config = lock_free_config(1);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat = sprokit::datum::complete_datum();
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  sprokit::edge_datum_t const edat = sprokit::edge_datum_t(dat, stamp);
+
+  edge->push_datum(edat);
+
+  edge->mark_downstream_as_complete();
+
+  if (edge->datum_count())
+  {
+    TEST_ERROR("A complete lock-free edge did not flush data");
+  }
+
+  edge->push_datum(edat);
+
+  if (edge->datum_count())
+  {
+    TEST_ERROR("A complete lock-free edge accepted data");
+  }
+
+  EXPECT_EXCEPTION(sprokit::datum_requested_after_complete,
+                   edge->get_datum(),
+                   "getting data from a complete lock-free edge");
+}
+
+IMPLEMENT_TEST(lock_free_capacity)
+{
+  sprokit::config_t const config = lock_free_config(1);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat1 = sprokit::datum::empty_datum();
+  sprokit::datum_t const dat2 = sprokit::datum::complete_datum();
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+
+  sprokit::edge_datum_t const edat1 = sprokit::edge_datum_t(dat1, stamp1);
+  sprokit::edge_datum_t const edat2 = sprokit::edge_datum_t(dat2, stamp2);
+
+  // Fill the edge.
+  edge->push_datum(edat1);
+
+  boost::thread thread = boost::thread(boost::bind(&push_datum, edge, edat2));
+
+  // Give the other thread some time.
+  // XXX(boost): 1.50.0
+#if BOOST_VERSION < 105000
+  boost::this_thread::sleep(boost::posix_time::seconds(SECONDS_TO_WAIT));
+#else
+  boost::this_thread::sleep_for(WAIT_DURATION);
+#endif
+
+  // Make sure the edge still is at capacity.
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("A datum was pushed into a full lock-free edge");
+  }
+
+  // Let the other thread go (it should have been blocking).
+  edge->get_datum();
+
+  // Make sure the other thread completes.
+  thread.join();
+
+  // Make sure the edge still is at capacity.
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("The other thread did not push into the lock-free edge");
+  }
+}
+
+IMPLEMENT_TEST(statistics)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  edge->push_data(make_data(5));
+  edge->get_datum();
+  edge->get_data(2);
+  edge->pop_datum();
+
+  sprokit::edge_statistics const stats = edge->statistics();
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  if (stats.pushed != 5)
+  {
+    TEST_ERROR("The edge counted " << stats.pushed << " pushes rather than 5");
+  }
+
+  if (stats.grabbed != 4)
+  {
+    TEST_ERROR("The edge counted " << stats.grabbed << " grabs rather than 4");
+  }
+
+  if (stats.high_water_mark != 5)
+  {
+    TEST_ERROR("The high water mark of the edge is " << stats.high_water_mark << " "
+               "rather than 5");
+  }
+
+  // The edge held 1, 2, 3, 4, and then 5 data after each push.
+  if (stats.occupancy_sum != 15)
+  {
+    TEST_ERROR("The occupancy sum of the edge is " << stats.occupancy_sum << " "
+               "rather than 15");
+  }
+
+  if (stats.push_blocked_ns || stats.grab_blocked_ns)
+  {
+    TEST_ERROR("The edge recorded blocking when it never blocked");
+  }
+#else
+  if (stats.pushed || stats.grabbed || stats.high_water_mark)
+  {
+    TEST_ERROR("Statistics were collected without instrumentation");
+  }
+#endif
+}
+
+static void check_blocked_statistics(sprokit::edge_t const& edge);
+
+IMPLEMENT_TEST(statistics_blocked)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(1);
+
+  config->set_value(sprokit::edge::config_capacity, value_capacity);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  check_blocked_statistics(edge);
+}
+
+IMPLEMENT_TEST(lock_free_statistics_blocked)
+{
+  sprokit::config_t const config = lock_free_config(1);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  check_blocked_statistics(edge);
+}
+
+IMPLEMENT_TEST(inline_push_get)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(4);
+
+  config->set_value(sprokit::edge::config_capacity, value_capacity);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  edge->set_inline(true);
+
+  if (!edge->is_inline())
+  {
+    TEST_ERROR("An edge did not become inline");
+  }
+
+  sprokit::edge_data_t const data = make_data(4);
+
+  edge->push_datum(data[0]);
+  edge->push_datum(data[1]);
+
+  if (edge->datum_count() != 2)
+  {
+    TEST_ERROR("An inline edge does not count its data");
+  }
+
+  sprokit::edge_datum_t const peek_edat = edge->peek_datum(1);
+
+  if (peek_edat.datum != data[1].datum)
+  {
+    TEST_ERROR("An inline edge did not peek at the right datum");
+  }
+
+  edge->pop_datum();
+
+  sprokit::edge_datum_t const get_edat = edge->get_datum();
+
+  if (get_edat.datum != data[1].datum)
+  {
+    TEST_ERROR("An inline edge did not return data in order");
+  }
+
+  edge->push_data(data);
+
+  if (!edge->full_of_data())
+  {
+    TEST_ERROR("An inline edge is not full at capacity");
+  }
+
+  sprokit::edge_data_t const get_data = edge->get_data(data.size());
+
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    if (get_data[i].datum != data[i].datum)
+    {
+      TEST_ERROR("An inline edge did not return batched data in order");
+    }
+  }
+
+  edge->set_inline(false);
+
+  if (edge->is_inline())
+  {
+    TEST_ERROR("An edge did not stop being inline");
+  }
+}
+
+IMPLEMENT_TEST(inline_complete)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  edge->set_inline(true);
+
+  sprokit::edge_data_t const data = make_data(1);
+
+  edge->push_datum(data[0]);
+
+  edge->mark_downstream_as_complete();
+
+  edge->push_datum(data[0]);
+
+  if (edge->datum_count())
+  {
+    TEST_ERROR("A complete inline edge accepted data");
+  }
+
+  EXPECT_EXCEPTION(sprokit::datum_requested_after_complete,
+                   edge->get_datum(),
+                   "getting data from a complete inline edge");
+}
+
+IMPLEMENT_TEST(peek_range)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(3);
+
+  edge->push_data(data);
+
+  sprokit::edge_data_t peeked;
+
+  edge->peek_range(peeked, 2);
+
+  if (peeked.size() != 2)
+  {
+    TEST_ERROR("Peeking at a range returned " << peeked.size() << " data rather than 2");
+  }
+
+  for (size_t i = 0; i < peeked.size(); ++i)
+  {
+    if (peeked[i].datum != data[i].datum)
+    {
+      TEST_ERROR("Peeking at a range did not return data in order");
+    }
+  }
+
+  if (edge->datum_count() != data.size())
+  {
+    TEST_ERROR("Peeking at a range removed data from the edge");
+  }
+
+  edge->mark_downstream_as_complete();
+
+  EXPECT_EXCEPTION(sprokit::datum_requested_after_complete,
+                   edge->peek_range(peeked, 1),
+                   "peeking at a range in a complete edge");
+}
+
+IMPLEMENT_TEST(peek_step_data)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(sprokit::stamp::increment_t(1));
+
+  edge->push_datum(sprokit::edge_datum_t(sprokit::datum::complete_datum(), stamp));
+
+  sprokit::edge_data_t peeked;
+
+  // This would block if the completion packet did not end the group.
+  edge->peek_step_data(peeked, 3);
+
+  if (peeked.size() != 1)
+  {
+    TEST_ERROR("Peeking at a step's data with a completion packet at the "
+               "front returned " << peeked.size() << " data rather than 1");
+  }
+
+  edge->pop_datum();
+
+  sprokit::edge_data_t const data = make_data(3);
+
+  edge->push_data(data);
+
+  peeked.clear();
+  edge->peek_step_data(peeked, 3);
+
+  if (peeked.size() != 3)
+  {
+    TEST_ERROR("Peeking at a step's data returned " << peeked.size() << " data rather than 3");
+  }
+
+  for (size_t i = 0; i < peeked.size(); ++i)
+  {
+    if (peeked[i].datum != data[i].datum)
+    {
+      TEST_ERROR("Peeking at a step's data did not return data in order");
+    }
+  }
+
+  if (edge->datum_count() != data.size())
+  {
+    TEST_ERROR("Peeking at a step's data removed data from the edge");
+  }
+}
+
+IMPLEMENT_TEST(lock_free_peek_range)
+{
+  sprokit::config_t const config = lock_free_config(4);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(3);
+
+  edge->push_data(data);
+
+  // Wrap around the end of the ring.
+  edge->pop_datum();
+  edge->pop_datum();
+  edge->push_data(data);
+
+  sprokit::edge_data_t peeked;
+
+  edge->peek_range(peeked, 4);
+
+  if (peeked.size() != 4)
+  {
+    TEST_ERROR("Peeking at a range in a lock-free edge returned " << peeked.size() << " data rather than 4");
+  }
+
+  if ((peeked[0].datum != data[2].datum) ||
+      (peeked[3].datum != data[2].datum))
+  {
+    TEST_ERROR("Peeking at a range in a lock-free edge did not return data in order");
+  }
+}
+
+static sprokit::config_t overflow_config(size_t capacity, sprokit::config::value_t const& policy);
+static void check_overflow_bounded(sprokit::config::value_t const& policy);
+
+IMPLEMENT_TEST(invalid_overflow_policy)
+{
+  sprokit::config_t const config = overflow_config(1, "drop_everything");
+
+  EXPECT_EXCEPTION(sprokit::invalid_overflow_policy_exception,
+                   boost::make_shared<sprokit::edge>(config),
+                   "creating an edge with an unknown overflow policy");
+}
+
+IMPLEMENT_TEST(overflow_drop_oldest)
+{
+  sprokit::config_t const config = overflow_config(2, "drop_oldest");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(3);
+
+  edge->push_data(data);
+
+  if (edge->full_of_data())
+  {
+    TEST_ERROR("An edge which drops data reported being full");
+  }
+
+  if (edge->datum_count() != 2)
+  {
+    TEST_ERROR("An edge dropping the oldest data holds " << edge->datum_count() << " data rather than 2");
+  }
+
+  if (edge->get_datum().datum != data[1].datum)
+  {
+    TEST_ERROR("An edge dropping the oldest data did not drop the oldest datum");
+  }
+
+  if (edge->statistics().dropped != 1)
+  {
+    TEST_ERROR("An edge dropping the oldest data did not count the dropped datum");
+  }
+
+  sprokit::stamp_t const dropped = edge->newest_dropped_stamp();
+
+  if (!dropped || (*dropped != *data[0].stamp))
+  {
+    TEST_ERROR("An edge dropping the oldest data did not remember the dropped stamp");
+  }
+}
+
+IMPLEMENT_TEST(overflow_drop_newest)
+{
+  sprokit::config_t const config = overflow_config(2, "drop_newest");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(3);
+
+  edge->push_data(data);
+
+  if (edge->datum_count() != 2)
+  {
+    TEST_ERROR("An edge dropping the newest data holds " << edge->datum_count() << " data rather than 2");
+  }
+
+  if (edge->peek_datum(1).datum != data[1].datum)
+  {
+    TEST_ERROR("An edge dropping the newest data did not drop the newest datum");
+  }
+
+  sprokit::stamp_t const dropped = edge->newest_dropped_stamp();
+
+  if (!dropped || (*dropped != *data[2].stamp))
+  {
+    TEST_ERROR("An edge dropping the newest data did not remember the dropped stamp");
+  }
+
+  if (edge->statistics().dropped != 1)
+  {
+    TEST_ERROR("An edge dropping the newest data did not count the dropped datum");
+  }
+}
+
+IMPLEMENT_TEST(overflow_keep_latest)
+{
+  sprokit::config_t const config = overflow_config(3, "keep_latest");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(4);
+
+  edge->push_data(data);
+
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("An edge keeping the latest data holds " << edge->datum_count() << " data rather than 1");
+  }
+
+  if (edge->get_datum().datum != data[3].datum)
+  {
+    TEST_ERROR("An edge keeping the latest data did not keep the latest datum");
+  }
+
+  if (edge->statistics().dropped != 3)
+  {
+    TEST_ERROR("An edge keeping the latest data did not count the dropped data");
+  }
+}
+
+IMPLEMENT_TEST(overflow_keeps_control)
+{
+  sprokit::config_t const config = overflow_config(1, "drop_newest");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(1);
+
+  sprokit::stamp_t const stamp = sprokit::stamp::incremented_stamp(data[0].stamp);
+
+  sprokit::edge_datum_t const flush = sprokit::edge_datum_t(sprokit::datum::flush_datum(), stamp);
+  sprokit::edge_datum_t const complete = sprokit::edge_datum_t(sprokit::datum::complete_datum(), stamp);
+
+  edge->push_data(data);
+  edge->push_datum(flush);
+
+  // The datum is dropped to make room for the flush.
+  if ((edge->datum_count() != 1) ||
+      (edge->peek_datum().datum != flush.datum))
+  {
+    TEST_ERROR("An edge dropped a flush packet");
+  }
+
+  edge->push_datum(complete);
+
+  // Nothing may be dropped, so the edge goes over capacity.
+  if (edge->datum_count() != 2)
+  {
+    TEST_ERROR("An edge dropped a complete packet");
+  }
+
+  if (edge->statistics().dropped != 1)
+  {
+    TEST_ERROR("An edge counted control packets as dropped");
+  }
+}
+
+IMPLEMENT_TEST(overflow_drop_oldest_bounded)
+{
+  check_overflow_bounded("drop_oldest");
+}
+
+IMPLEMENT_TEST(overflow_drop_newest_bounded)
+{
+  check_overflow_bounded("drop_newest");
+}
+
+IMPLEMENT_TEST(overflow_keep_latest_bounded)
+{
+  check_overflow_bounded("keep_latest");
+}
+
+IMPLEMENT_TEST(capacity_bytes)
+{
+  size_t const datum_bytes = sizeof(size_t);
+
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(2 * datum_bytes);
+
+  config->set_value(sprokit::edge::config_capacity_bytes, value_capacity);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(3);
+
+  if (!edge->try_push_datum(data[0]) ||
+      !edge->try_push_datum(data[1]))
+  {
+    TEST_ERROR("An edge did not accept data within its memory capacity");
+  }
+
+  if (edge->buffered_bytes() != (2 * datum_bytes))
+  {
+    TEST_ERROR("An edge did not count the memory held by its data");
+  }
+
+  if (!edge->full_of_data())
+  {
+    TEST_ERROR("An edge at its memory capacity is not full");
+  }
+
+  if (edge->try_push_datum(data[2]))
+  {
+    TEST_ERROR("An edge accepted data beyond its memory capacity");
+  }
+
+  edge->get_datum();
+
+  if (edge->buffered_bytes() != datum_bytes)
+  {
+    TEST_ERROR("An edge did not release the memory of grabbed data");
+  }
+
+  if (!edge->try_push_datum(data[2]))
+  {
+    TEST_ERROR("An edge did not accept data after memory was released");
+  }
+}
+
+IMPLEMENT_TEST(capacity_bytes_oversized)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity_bytes, "1");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(2);
+
+  if (!edge->try_push_datum(data[0]))
+  {
+    TEST_ERROR("An empty edge did not accept a datum larger than its memory capacity");
+  }
+
+  if (edge->try_push_datum(data[1]))
+  {
+    TEST_ERROR("An edge accepted data beyond its memory capacity");
+  }
+}
+
+IMPLEMENT_TEST(memory_budget)
+{
+  size_t const datum_bytes = sizeof(size_t);
+
+  sprokit::memory_budget_t const budget = boost::make_shared<sprokit::memory_budget>(2 * datum_bytes);
+
+  sprokit::edge_t const edge_a = boost::make_shared<sprokit::edge>();
+  sprokit::edge_t const edge_b = boost::make_shared<sprokit::edge>();
+
+  edge_a->set_memory_budget(budget);
+  edge_b->set_memory_budget(budget);
+
+  sprokit::edge_data_t const data = make_data(4);
+
+  edge_a->push_data(sprokit::edge_data_t(data.begin(), data.begin() + 2));
+
+  if (!budget->exhausted())
+  {
+    TEST_ERROR("Pushing data into an edge did not use its memory budget");
+  }
+
+  if (!edge_a->full_of_data())
+  {
+    TEST_ERROR("An edge holding data is not full when its budget is exhausted");
+  }
+
+  if (!edge_b->try_push_datum(data[2]))
+  {
+    TEST_ERROR("An empty edge did not accept data when its budget is exhausted");
+  }
+
+  if (edge_b->try_push_datum(data[3]))
+  {
+    TEST_ERROR("An edge holding data accepted more when its budget is exhausted");
+  }
+
+  edge_a->get_data(2);
+
+  if (budget->used() != datum_bytes)
+  {
+    TEST_ERROR("Grabbing data from an edge did not release its memory from the budget");
+  }
+
+  if (!edge_b->try_push_datum(data[3]))
+  {
+    TEST_ERROR("An edge did not accept data once its budget had room");
+  }
+
+  edge_b->mark_downstream_as_complete();
+
+  if (budget->used())
+  {
+    TEST_ERROR("Completing an edge did not release its memory from the budget");
+  }
+}
+
+static void check_try_push_peek(sprokit::config_t const& config, std::string const& kind);
+
+IMPLEMENT_TEST(lock_free_capacity_bytes)
+{
+  sprokit::config_t const config = lock_free_config(2);
+
+  config->set_value(sprokit::edge::config_capacity_bytes, "16");
+
+  EXPECT_EXCEPTION(sprokit::lock_free_memory_limit_exception,
+                   boost::make_shared<sprokit::edge>(config),
+                   "creating a lock-free edge with a memory capacity");
+}
+
+IMPLEMENT_TEST(lock_free_memory_budget)
+{
+  sprokit::config_t const config = lock_free_config(2);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::memory_budget_t const budget = boost::make_shared<sprokit::memory_budget>(16);
+
+  sprokit::edge_data_t const data = make_data(1);
+
+  edge->push_data(data);
+
+  EXPECT_EXCEPTION(sprokit::lock_free_memory_limit_exception,
+                   edge->set_memory_budget(budget),
+                   "giving a lock-free edge a memory budget");
+
+  if (budget->used())
+  {
+    TEST_ERROR("A lock-free edge used a memory budget it rejected");
+  }
+
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("Rejecting a memory budget changed the data in a lock-free edge");
+  }
+
+  if (edge->get_datum().datum != data[0].datum)
+  {
+    TEST_ERROR("Rejecting a memory budget lost the data in a lock-free edge");
+  }
+}
+
+IMPLEMENT_TEST(try_push_peek)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(2);
+
+  config->set_value(sprokit::edge::config_capacity, value_capacity);
+
+  check_try_push_peek(config, "A");
+}
+
+IMPLEMENT_TEST(lock_free_try_push_peek)
+{
+  sprokit::config_t const config = lock_free_config(2);
+
+  check_try_push_peek(config, "A lock-free");
+}
+
+sprokit::config_t
+lock_free_config(size_t capacity)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(capacity);
+
+  config->set_value(sprokit::edge::config_capacity, value_capacity);
+  config->set_value(sprokit::edge::config_lock_free, "true");
+
+  return config;
+}
+
 void
 push_datum(sprokit::edge_t edge, sprokit::edge_datum_t edat)
 {
@@ -487,3 +1457,180 @@ push_datum(sprokit::edge_t edge, sprokit::edge_datum_t edat)
     TEST_ERROR("A datum was pushed into a full edge");
   }
 }
+
+sprokit::edge_data_t
+make_data(size_t count)
+{
+  sprokit::edge_data_t data;
+
+  sprokit::stamp_t stamp = sprokit::stamp::new_stamp(sprokit::stamp::increment_t(1));
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    sprokit::datum_t const dat = sprokit::datum::new_datum(i);
+
+    data.push_back(sprokit::edge_datum_t(dat, stamp));
+
+    stamp = sprokit::stamp::incremented_stamp(stamp);
+  }
+
+  return data;
+}
+
+void
+push_data(sprokit::edge_t edge, sprokit::edge_data_t data)
+{
+  edge->push_data(data);
+}
+
+void
+check_blocked_statistics(sprokit::edge_t const& edge)
+{
+  sprokit::edge_data_t const data = make_data(2);
+
+  // Fill the edge.
+  edge->push_datum(data[0]);
+
+  boost::thread thread = boost::thread(boost::bind(&push_datum, edge, data[1]));
+
+  // Give the other thread some time.
+  // XXX(boost): 1.50.0
+#if BOOST_VERSION < 105000
+  boost::this_thread::sleep(boost::posix_time::seconds(SECONDS_TO_WAIT));
+#else
+  boost::this_thread::sleep_for(WAIT_DURATION);
+#endif
+
+  // Let the other thread go (it should have been blocking).
+  edge->get_datum();
+
+  thread.join();
+
+  sprokit::edge_statistics const stats = edge->statistics();
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  if (!stats.push_blocked_ns)
+  {
+    TEST_ERROR("The time spent blocked on a full edge was not recorded");
+  }
+
+  if (stats.pushed != 2)
+  {
+    TEST_ERROR("The edge counted " << stats.pushed << " pushes rather than 2");
+  }
+
+  if (stats.high_water_mark != 1)
+  {
+    TEST_ERROR("The high water mark of the edge is " << stats.high_water_mark << " "
+               "rather than its capacity");
+  }
+#else
+  if (stats.push_blocked_ns)
+  {
+    TEST_ERROR("Statistics were collected without instrumentation");
+  }
+#endif
+}
+
+sprokit::config_t
+overflow_config(size_t capacity, sprokit::config::value_t const& policy)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(capacity);
+
+  config->set_value(sprokit::edge::config_capacity, value_capacity);
+  config->set_value(sprokit::edge::config_overflow_policy, policy);
+
+  return config;
+}
+
+void
+check_overflow_bounded(sprokit::config::value_t const& policy)
+{
+  size_t const capacity = 4;
+
+  sprokit::config_t const config = overflow_config(capacity, policy);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(10 * capacity);
+
+  // Nothing consumes from the edge, so the overflow policy must keep it from
+  // growing.
+  BOOST_FOREACH (sprokit::edge_datum_t const& edat, data)
+  {
+    edge->push_datum(edat);
+
+    if (capacity < edge->datum_count())
+    {
+      TEST_ERROR("An edge with the " << policy << " policy grew to "
+                 << edge->datum_count() << " packets beyond its capacity of " << capacity);
+
+      return;
+    }
+  }
+
+  if (edge->statistics().dropped != (data.size() - edge->datum_count()))
+  {
+    TEST_ERROR("An edge with the " << policy << " policy did not count all of the dropped data");
+  }
+}
+
+void
+check_try_push_peek(sprokit::config_t const& config, std::string const& kind)
+{
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::edge_data_t const data = make_data(3);
+
+  sprokit::edge_datum_t edat;
+
+  if (edge->try_peek_datum(edat))
+  {
+    TEST_ERROR(kind << " edge peeked at a datum while empty");
+  }
+
+  if (!edge->try_push_datum(data[0]) ||
+      !edge->try_push_datum(data[1]))
+  {
+    TEST_ERROR(kind << " edge did not accept data while it had space");
+  }
+
+  if (edge->try_push_datum(data[2]))
+  {
+    TEST_ERROR(kind << " edge accepted data while full");
+  }
+
+  if (edge->datum_count() != 2)
+  {
+    TEST_ERROR(kind << " edge holds " << edge->datum_count() << " data rather than 2");
+  }
+
+  if (!edge->try_peek_datum(edat, 1) ||
+      (edat.datum != data[1].datum))
+  {
+    TEST_ERROR(kind << " edge did not peek at the right datum");
+  }
+
+  if (edge->try_peek_datum(edat, 2))
+  {
+    TEST_ERROR(kind << " edge peeked past its data");
+  }
+
+  edge->mark_downstream_as_complete();
+
+  if (!edge->try_push_datum(data[2]))
+  {
+    TEST_ERROR(kind << " complete edge did not discard data");
+  }
+
+  if (edge->datum_count())
+  {
+    TEST_ERROR(kind << " complete edge accepted data");
+  }
+
+  EXPECT_EXCEPTION(sprokit::datum_requested_after_complete,
+                   edge->try_peek_datum(edat),
+                   "peeking at data in a complete edge");
+}
@@ -37,6 +37,11 @@
 #include <sprokit/pipeline/process_registry.h>
 #include <sprokit/pipeline/scheduler.h>
 #include <sprokit/pipeline/scheduler_registry.h>
+#include <sprokit/pipeline/utils.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
 
 #define TEST_ARGS ()
 
@@ -94,3 +99,84 @@ IMPLEMENT_TEST(has_directory)
 {
   sprokit::load_known_modules();
 }
+
+TEST_PROPERTY(ENVIRONMENT, SPROKIT_MODULE_PATH=@CMAKE_CURRENT_BINARY_DIR@/manifest)
+IMPLEMENT_TEST(manifest)
+{
+  sprokit::load_known_modules();
+
+  sprokit::process_registry_t const preg = sprokit::process_registry::self();
+
+  sprokit::process_registry::module_t const module = sprokit::process_registry::module_t("test_processes");
+
+  if (preg->is_module_loaded(module))
+  {
+    TEST_ERROR("A module with a manifest was loaded before its types were used");
+  }
+
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("test");
+
+  sprokit::process::types_t const types = preg->types();
+
+  if (std::find(types.begin(), types.end(), proc_type) == types.end())
+  {
+    TEST_ERROR("A type from a manifest is not available");
+  }
+
+  preg->create_process(proc_type, sprokit::process::name_t());
+
+  if (!preg->is_module_loaded(module))
+  {
+    TEST_ERROR("A module with a manifest was not loaded when its type was used");
+  }
+}
+
+TEST_PROPERTY(ENVIRONMENT, SPROKIT_MODULE_CACHE=@CMAKE_CURRENT_BINARY_DIR@/modules.cache)
+IMPLEMENT_TEST(cache)
+{
+  sprokit::load_known_modules();
+
+  sprokit::envvar_value_t const cache_path = sprokit::get_envvar("SPROKIT_MODULE_CACHE");
+
+  if (!cache_path)
+  {
+    TEST_ERROR("The cache path is not set");
+
+    return;
+  }
+
+  std::ifstream fin(cache_path->c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("The module cache was not written");
+
+    return;
+  }
+
+  bool found_process = false;
+  bool found_scheduler = false;
+  std::string line;
+
+  while (std::getline(fin, line))
+  {
+    if (line == "process numbers")
+    {
+      found_process = true;
+    }
+    else if (line == "scheduler sync")
+    {
+      found_scheduler = true;
+    }
+  }
+
+  if (!found_process)
+  {
+    TEST_ERROR("The module cache does not contain a known process");
+  }
+
+  if (!found_scheduler)
+  {
+    TEST_ERROR("The module cache does not contain a known scheduler");
+  }
+}
@@ -31,6 +31,8 @@
 #include <test_common.h>
 
 #include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/edge.h>
 #include <sprokit/pipeline/modules.h>
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/pipeline_exception.h>
@@ -39,6 +41,7 @@
 #include <sprokit/pipeline/process_exception.h>
 #include <sprokit/pipeline/process_registry.h>
 #include <sprokit/pipeline/scheduler.h>
+#include <sprokit/pipeline/stamp.h>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/make_shared.hpp>
@@ -1687,6 +1690,71 @@ IMPLEMENT_TEST(disconnect)
   }
 }
 
+IMPLEMENT_TEST(queries_after_disconnect)
+{
+  sprokit::process::type_t const typeu = sprokit::process::type_t("orphan");
+  sprokit::process::type_t const typed = sprokit::process::type_t("sink");
+  sprokit::process::name_t const nameu = sprokit::process::name_t("up");
+  sprokit::process::name_t const named1 = sprokit::process::name_t("down1");
+  sprokit::process::name_t const named2 = sprokit::process::name_t("down2");
+  sprokit::process::name_t const named3 = sprokit::process::name_t("down3");
+
+  sprokit::pipeline_t const pipe = create_pipeline();
+
+  pipe->add_process(create_process(typeu, nameu));
+  pipe->add_process(create_process(typed, named1));
+  pipe->add_process(create_process(typed, named2));
+  pipe->add_process(create_process(typed, named3));
+
+  sprokit::process::port_t const portu = sprokit::process::port_heartbeat;
+  sprokit::process::port_t const portd = sprokit::process::port_t("sink");
+
+  pipe->connect(nameu, portu,
+                named1, portd);
+  pipe->connect(nameu, portu,
+                named2, portd);
+  pipe->connect(nameu, portu,
+                named3, portd);
+
+  // Forgetting connections moves the others around.
+  pipe->disconnect(nameu, portu,
+                   named1, portd);
+  pipe->remove_process(named1);
+  pipe->remove_process(named2);
+
+  pipe->setup_pipeline();
+
+  sprokit::processes_t const downstream = pipe->downstream_for_process(nameu);
+
+  if ((downstream.size() != 1) ||
+      (downstream[0]->name() != named3))
+  {
+    TEST_ERROR("The downstream processes include forgotten connections");
+  }
+
+  sprokit::process::port_addrs_t const receivers = pipe->receivers_for_port(nameu, portu);
+
+  if (receivers.size() != 1)
+  {
+    TEST_ERROR("The receivers of a port include forgotten connections");
+  }
+
+  if (pipe->sender_for_port(named3, portd) != sprokit::process::port_addr_t(nameu, portu))
+  {
+    TEST_ERROR("The sender for a port is not the connected port");
+  }
+
+  if (!pipe->edge_for_connection(nameu, portu, named3, portd))
+  {
+    TEST_ERROR("The edge for a remaining connection was not found");
+  }
+
+  if (pipe->input_edge_for_port(named3, portd) != pipe->output_edges_for_port(nameu, portu)[0])
+  {
+    TEST_ERROR("The edge for a connection differs between its ends");
+  }
+}
+
 IMPLEMENT_TEST(disconnect_after_setup)
 {
   sprokit::process::type_t const typeu = sprokit::process::type_t("orphan");
@@ -1828,6 +1896,180 @@ IMPLEMENT_TEST(reconfigure_only_top_level)
   pipeline->reconfigure(new_conf);
 }
 
+IMPLEMENT_TEST(replicas_zero)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("pass");
+
+  sprokit::process::name_t const proc_name = sprokit::process::name_t("name");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value(sprokit::process::config_replicas, "0");
+
+  sprokit::process_t const process = create_process(proc_type, proc_name, conf);
+
+  sprokit::pipeline_t const pipeline = create_pipeline();
+
+  EXPECT_EXCEPTION(sprokit::invalid_replication_exception,
+                   pipeline->add_process(process),
+                   "adding a process with no replicas");
+}
+
+IMPLEMENT_TEST(replicas_not_replicable)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("take_number");
+
+  sprokit::process::name_t const proc_name = sprokit::process::name_t("name");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value(sprokit::process::config_replicas, "2");
+
+  sprokit::process_t const process = create_process(proc_type, proc_name, conf);
+
+  sprokit::pipeline_t const pipeline = create_pipeline();
+
+  EXPECT_EXCEPTION(sprokit::invalid_replication_exception,
+                   pipeline->add_process(process),
+                   "replicating a process which is not replicable");
+}
+
+IMPLEMENT_TEST(replicas_expand)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("pass");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_name = sprokit::process::name_t("name");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value(sprokit::process::config_replicas, "3");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const process = create_process(proc_type, proc_name, conf);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipeline = create_pipeline();
+
+  pipeline->add_process(processu);
+  pipeline->add_process(process);
+  pipeline->add_process(processd);
+
+  sprokit::process::names_t const clusters = pipeline->cluster_names();
+
+  if ((clusters.size() != 1) || (clusters[0] != proc_name))
+  {
+    TEST_ERROR("The replicated process was not turned into a cluster");
+  }
+
+  // The neighbors, the distribute and collate processes, and the replicas.
+  sprokit::process::names_t const names = pipeline->process_names();
+
+  if (names.size() != 7)
+  {
+    TEST_ERROR("The replicas were not added to the pipeline: "
+               "Expected: 7 "
+               "Received: " << names.size());
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    sprokit::process::name_t const replica_name = proc_name + "/replica" + boost::lexical_cast<std::string>(i);
+
+    sprokit::process_t const replica = pipeline->process_by_name(replica_name);
+
+    if (replica->type() != proc_type)
+    {
+      TEST_ERROR("A replica does not have the type of the original process");
+    }
+  }
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_name = sprokit::process::port_t("pass");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_name, port_name);
+  pipeline->connect(proc_name, port_name,
+                    proc_named, port_named);
+
+  pipeline->setup_pipeline();
+}
+
+IMPLEMENT_TEST(memory_budget)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("multiplication");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu1 = sprokit::process::name_t("upstream1");
+  sprokit::process::name_t const proc_nameu2 = sprokit::process::name_t("upstream2");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  sprokit::process_t const processu1 = create_process(proc_typeu, proc_nameu1);
+  sprokit::process_t const processu2 = create_process(proc_typeu, proc_nameu2);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+  sprokit::process_t const processt = create_process(proc_typet, proc_namet);
+
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value("_memory_budget", "1");
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(config);
+
+  pipeline->add_process(processu1);
+  pipeline->add_process(processu2);
+  pipeline->add_process(processd);
+  pipeline->add_process(processt);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_named1 = sprokit::process::port_t("factor1");
+  sprokit::process::port_t const port_named2 = sprokit::process::port_t("factor2");
+  sprokit::process::port_t const port_namedo = sprokit::process::port_t("product");
+  sprokit::process::port_t const port_namet = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu1, port_nameu,
+                    proc_named, port_named1);
+  pipeline->connect(proc_nameu2, port_nameu,
+                    proc_named, port_named2);
+  pipeline->connect(proc_named, port_namedo,
+                    proc_namet, port_namet);
+
+  pipeline->setup_pipeline();
+
+  sprokit::edge_t const edge1 = pipeline->input_edge_for_port(proc_named, port_named1);
+  sprokit::edge_t const edge2 = pipeline->input_edge_for_port(proc_named, port_named2);
+
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(sprokit::stamp::increment_t(1));
+  sprokit::edge_datum_t const edat = sprokit::edge_datum_t(sprokit::datum::new_datum(int(1)), stamp);
+
+  edge1->push_datum(edat);
+
+  if (!edge1->buffered_bytes())
+  {
+    TEST_ERROR("An edge in a pipeline with a memory budget did not count its memory");
+  }
+
+  if (!edge1->full_of_data())
+  {
+    TEST_ERROR("An edge holding data is not full when the pipeline memory budget is exhausted");
+  }
+
+  if (!edge2->try_push_datum(edat))
+  {
+    TEST_ERROR("An empty edge did not accept data when the pipeline memory budget is exhausted");
+  }
+
+  if (edge2->try_push_datum(edat))
+  {
+    TEST_ERROR("Edges in a pipeline do not share its memory budget");
+  }
+}
+
 sprokit::process_t
 create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config)
 {
@@ -31,14 +31,22 @@
 #include <test_common.h>
 
 #include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
 #include <sprokit/pipeline/edge.h>
 #include <sprokit/pipeline/modules.h>
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/process.h>
 #include <sprokit/pipeline/process_exception.h>
 #include <sprokit/pipeline/process_registry.h>
+#include <sprokit/pipeline/stamp.h>
 
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 #define TEST_ARGS ()
 
@@ -56,6 +64,8 @@ main(int argc, char* argv[])
 
 static sprokit::process_t create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name = sprokit::process::name_t(), sprokit::config_t const& conf = sprokit::config::empty_config());
 static sprokit::edge_t create_edge();
+static void record_step(size_t* steps, bool* complete, bool proc_complete);
+static void step_times(sprokit::process_t const& process, size_t count);
 
 class remove_ports_process
   : public sprokit::process
@@ -74,6 +84,50 @@ class remove_ports_process
     static port_type_t const output_port;
 };
 
+class handle_process
+  : public sprokit::process
+{
+  public:
+    handle_process(sprokit::config_t const& config);
+    ~handle_process();
+
+    sprokit::datum_t grab_input(port_handle const& handle) const;
+    void push_output(port_handle const& handle, sprokit::datum_t const& dat) const;
+    port_handle resolve_input(port_t const& port);
+    port_handle resolve_output(port_t const& port);
+
+    port_handle input;
+    port_handle output;
+
+    static port_t const port_input;
+    static port_t const port_output;
+  protected:
+    void _init();
+    void _step();
+};
+
+class gated_process
+  : public sprokit::process
+{
+  public:
+    gated_process(sprokit::config_t const& config);
+    ~gated_process();
+
+    void wait_for_step();
+    void open_gate();
+
+    static port_t const port_input;
+    static port_t const port_output;
+  protected:
+    void _step();
+    properties_t _properties() const;
+  private:
+    boost::mutex mut;
+    boost::condition_variable cond;
+    bool stepping;
+    bool open;
+};
+
 class null_config_process
   : public sprokit::process
 {
@@ -210,17 +264,578 @@ IMPLEMENT_TEST(step_before_configure)
                    "stepping before configuring");
 }
 
-IMPLEMENT_TEST(step_before_init)
-{
-  sprokit::process::type_t const proc_type = sprokit::process::type_t("orphan");
+IMPLEMENT_TEST(step_before_init)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("orphan");
+
+  sprokit::process_t const process = create_process(proc_type);
+
+  process->configure();
+
+  EXPECT_EXCEPTION(sprokit::uninitialized_exception,
+                   process->step(),
+                   "stepping before initialization");
+}
+
+IMPLEMENT_TEST(step_callback)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("tunable");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("tunable", "tunable");
+  conf->set_value("non_tunable", "non_tunable");
+
+  sprokit::process_t const process = create_process(proc_type, sprokit::process::name_t(), conf);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipe->add_process(process);
+  pipe->setup_pipeline();
+
+  size_t steps = 0;
+  bool complete = false;
+
+  process->set_step_callback(boost::bind(&record_step, &steps, &complete, _1));
+
+  if (process->is_complete())
+  {
+    TEST_ERROR("The process is complete before being stepped");
+  }
+
+  process->step();
+
+  if (steps != 1)
+  {
+    TEST_ERROR("The step callback was called " << steps << " times "
+               "rather than once");
+  }
+
+  if (!complete)
+  {
+    TEST_ERROR("The step callback was not told that the process completed");
+  }
+
+  if (!process->is_complete())
+  {
+    TEST_ERROR("The process is not complete after being stepped");
+  }
+
+  process->set_step_callback(sprokit::process::step_callback_t());
+
+  process->step();
+
+  if (steps != 1)
+  {
+    TEST_ERROR("The step callback was called after being removed");
+  }
+}
+
+IMPLEMENT_TEST(ready_before_init)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("orphan");
+
+  sprokit::process_t const process = create_process(proc_type);
+
+  process->configure();
+
+  EXPECT_EXCEPTION(sprokit::uninitialized_exception,
+                   process->ready(),
+                   "querying readiness before initialization");
+}
+
+IMPLEMENT_TEST(try_step)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::config_t const pipe_conf = sprokit::config::empty_config();
+
+  pipe_conf->set_value("_edge:capacity", "1");
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(pipe_conf);
+
+  sprokit::process::port_t const portu = sprokit::process::port_t("number");
+  sprokit::process::port_t const portd = sprokit::process::port_t("sink");
+
+  pipe->add_process(processu);
+  pipe->add_process(processd);
+
+  pipe->connect(proc_nameu, portu,
+                proc_named, portd);
+
+  pipe->setup_pipeline();
+
+  if (processd->try_step())
+  {
+    TEST_ERROR("A process stepped without input data");
+  }
+
+  if (!processu->try_step())
+  {
+    TEST_ERROR("A process with space in its output did not step");
+  }
+
+  if (processu->ready())
+  {
+    TEST_ERROR("A process with a full output is ready");
+  }
+
+  if (processu->try_step())
+  {
+    TEST_ERROR("A process stepped into a full output");
+  }
+
+  if (!processd->try_step())
+  {
+    TEST_ERROR("A process with input data did not step");
+  }
+
+  if (!processu->ready())
+  {
+    TEST_ERROR("A process is not ready after its output was drained");
+  }
+}
+
+IMPLEMENT_TEST(not_reentrant_by_default)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("orphan");
+
+  sprokit::process_t const process = create_process(proc_type);
+
+  process->configure();
+  process->init();
+
+  if (process->is_reentrant())
+  {
+    TEST_ERROR("A process is reentrant without asking to be");
+  }
+}
+
+IMPLEMENT_TEST(reentrant_step)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typem = sprokit::process::type_t("multiplication");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu1 = sprokit::process::name_t("upstream1");
+  sprokit::process::name_t const proc_nameu2 = sprokit::process::name_t("upstream2");
+  sprokit::process::name_t const proc_namem = sprokit::process::name_t("multiply");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  size_t const threads = 4;
+  size_t const steps_per_thread = 25;
+  size_t const total = threads * steps_per_thread;
+
+  sprokit::config_t const confu = sprokit::config::empty_config();
+
+  confu->set_value("start", "0");
+  confu->set_value("end", boost::lexical_cast<sprokit::config::value_t>(total));
+
+  sprokit::process_t const processu1 = create_process(proc_typeu, proc_nameu1, confu);
+  sprokit::process_t const processu2 = create_process(proc_typeu, proc_nameu2, confu);
+  sprokit::process_t const processm = create_process(proc_typem, proc_namem);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipe->add_process(processu1);
+  pipe->add_process(processu2);
+  pipe->add_process(processm);
+  pipe->add_process(processd);
+
+  sprokit::process::port_t const port_number = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_product = sprokit::process::port_t("product");
+  sprokit::process::port_t const port_sink = sprokit::process::port_t("sink");
+
+  pipe->connect(proc_nameu1, port_number,
+                proc_namem, sprokit::process::port_t("factor1"));
+  pipe->connect(proc_nameu2, port_number,
+                proc_namem, sprokit::process::port_t("factor2"));
+  pipe->connect(proc_namem, port_product,
+                proc_named, port_sink);
+
+  pipe->setup_pipeline();
+
+  if (!processm->is_reentrant())
+  {
+    TEST_ERROR("A process which removed the non-reentrant property is not reentrant");
+  }
+
+  step_times(processu1, total);
+  step_times(processu2, total);
+
+  boost::thread_group group;
+
+  for (size_t i = 0; i < threads; ++i)
+  {
+    group.create_thread(boost::bind(&step_times, processm, steps_per_thread));
+  }
+
+  group.join_all();
+
+  sprokit::edge_t const edge = pipe->edge_for_connection(proc_namem, port_product,
+                                                         proc_named, port_sink);
+
+  if (edge->datum_count() != total)
+  {
+    TEST_ERROR("The reentrant process pushed " << edge->datum_count() << " data "
+               "rather than " << total);
+  }
+
+  sprokit::stamp_t last_stamp;
+
+  for (size_t i = 0; edge->has_data() && (i < total); ++i)
+  {
+    sprokit::edge_datum_t const edat = edge->get_datum();
+    int32_t const expect = int32_t(i * i);
+    int32_t const product = edat.datum->get_datum<int32_t>();
+
+    if (product != expect)
+    {
+      TEST_ERROR("Step " << i << " of a reentrant process pushed " << product << " "
+                 "rather than " << expect);
+    }
+
+    if (last_stamp && !(*last_stamp < *edat.stamp))
+    {
+      TEST_ERROR("A reentrant process pushed stamps out of order");
+    }
+
+    last_stamp = edat.stamp;
+  }
+}
+
+IMPLEMENT_TEST(reentrant_reserves_outputs)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_nameg = sprokit::process::name_t("gated");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::config_t const gated_conf = sprokit::config::empty_config();
+
+  gated_conf->set_value(sprokit::process::config_name, proc_nameg);
+
+  boost::shared_ptr<gated_process> const processg = boost::make_shared<gated_process>(gated_conf);
+
+  sprokit::config_t const pipe_conf = sprokit::config::empty_config();
+
+  pipe_conf->set_value("_edge_by_conn:downstream:down:sink:capacity", "1");
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(pipe_conf);
+
+  sprokit::process::port_t const portu = sprokit::process::port_t("number");
+  sprokit::process::port_t const portd = sprokit::process::port_t("sink");
+
+  pipe->add_process(processu);
+  pipe->add_process(processg);
+  pipe->add_process(processd);
+
+  pipe->connect(proc_nameu, portu,
+                proc_nameg, gated_process::port_input);
+  pipe->connect(proc_nameg, gated_process::port_output,
+                proc_named, portd);
+
+  pipe->setup_pipeline();
+
+  if (!processg->is_reentrant())
+  {
+    TEST_ERROR("A process which removed the non-reentrant property is not reentrant");
+  }
+
+  step_times(processu, 2);
+
+  sprokit::edge_t const edge = pipe->edge_for_connection(proc_nameg, gated_process::port_output,
+                                                         proc_named, portd);
+
+  boost::thread thread = boost::thread(boost::bind(&sprokit::process::step, processg));
+
+  processg->wait_for_step();
+
+  // The output edge is still empty, but its only place belongs to the step
+  // which has not pushed yet.
+  if (processg->ready())
+  {
+    TEST_ERROR("A reentrant process is ready while a staged step holds the output space");
+  }
+
+  processg->open_gate();
+
+  thread.join();
+
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("The staged step did not push its output");
+  }
+
+  edge->get_datum();
+
+  if (!processg->ready())
+  {
+    TEST_ERROR("A reentrant process is not ready after its staged step finished");
+  }
+}
+
+IMPLEMENT_TEST(statistics)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("tunable");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("tunable", "tunable");
+  conf->set_value("non_tunable", "non_tunable");
+
+  sprokit::process_t const process = create_process(proc_type, sprokit::process::name_t(), conf);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipe->add_process(process);
+  pipe->setup_pipeline();
+
+  // The first step completes the process; the second does not call _step.
+  process->step();
+  process->step();
+
+  sprokit::process_statistics const stats = process->statistics();
+
+  sprokit::statistic_t timed_steps = 0;
+
+  for (size_t i = 0; i < sprokit::duration_histogram::bucket_count; ++i)
+  {
+    timed_steps += stats.step_wall_histogram.buckets[i];
+  }
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  if (stats.steps != 2)
+  {
+    TEST_ERROR("The process counted " << stats.steps << " steps rather than 2");
+  }
+
+  if (timed_steps != 1)
+  {
+    TEST_ERROR("The process timed " << timed_steps << " steps rather than 1");
+  }
+#else
+  if (stats.steps || timed_steps)
+  {
+    TEST_ERROR("Statistics were collected without instrumentation");
+  }
+#endif
+}
+
+IMPLEMENT_TEST(heartbeat_when_connected)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("tunable");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("tunable", "tunable");
+  conf->set_value("non_tunable", "non_tunable");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, conf);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  sprokit::process::port_t const portu = sprokit::process::port_heartbeat;
+  sprokit::process::port_t const portd = sprokit::process::port_t("sink");
+
+  pipe->add_process(processu);
+  pipe->add_process(processd);
+
+  pipe->connect(proc_nameu, portu,
+                proc_named, portd);
+
+  pipe->setup_pipeline();
+
+  processu->step();
+
+  sprokit::edge_t const edge = pipe->edge_for_connection(proc_nameu, portu,
+                                                         proc_named, portd);
+
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("A connected heartbeat port did not receive a datum for the step");
+  }
+
+  sprokit::edge_datum_t const edat = edge->get_datum();
+
+  if (edat.datum->type() != sprokit::datum::complete)
+  {
+    TEST_ERROR("The heartbeat did not report that the process completed");
+  }
+}
+
+IMPLEMENT_TEST(port_handles)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("handles");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  int32_t const start = 7;
+
+  conf->set_value("start", boost::lexical_cast<sprokit::config::value_t>(start));
+  conf->set_value("end", boost::lexical_cast<sprokit::config::value_t>(start + 10));
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, conf);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::config_t const handle_conf = sprokit::config::empty_config();
+
+  handle_conf->set_value(sprokit::process::config_name, proc_namet);
+
+  sprokit::process_t const processt = boost::make_shared<handle_process>(handle_conf);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  sprokit::process::port_t const portu = sprokit::process::port_t("number");
+  sprokit::process::port_t const portd = sprokit::process::port_t("sink");
+
+  pipe->add_process(processu);
+  pipe->add_process(processt);
+  pipe->add_process(processd);
+
+  pipe->connect(proc_nameu, portu,
+                proc_namet, handle_process::port_input);
+  pipe->connect(proc_namet, handle_process::port_output,
+                proc_named, portd);
+
+  pipe->setup_pipeline();
+
+  processu->step();
+  processt->step();
+
+  sprokit::edge_t const edge = pipe->edge_for_connection(proc_namet, handle_process::port_output,
+                                                         proc_named, portd);
+
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("Pushing through a port handle did not reach the edge");
+  }
+
+  sprokit::edge_datum_t const edat = edge->get_datum();
+
+  int32_t const value = edat.datum->get_datum<int32_t>();
+
+  if (value != start)
+  {
+    TEST_ERROR("The datum passed through port handles was " << value << " "
+               "rather than " << start);
+  }
+
+  if (!edat.stamp)
+  {
+    TEST_ERROR("The datum pushed through a port handle was not stamped");
+  }
+}
+
+IMPLEMENT_TEST(port_handle_errors)
+{
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  boost::shared_ptr<handle_process> const process = boost::make_shared<handle_process>(conf);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipe->add_process(process);
+  pipe->setup_pipeline();
+
+  if (!process->input.is_valid() || !process->output.is_valid())
+  {
+    TEST_ERROR("Resolved port handles are not valid");
+  }
+
+  sprokit::process::port_handle const unresolved;
+
+  if (unresolved.is_valid())
+  {
+    TEST_ERROR("A default port handle is valid");
+  }
+
+  EXPECT_EXCEPTION(sprokit::invalid_port_handle_exception,
+                   process->grab_input(unresolved),
+                   "grabbing with an unresolved handle");
+
+  EXPECT_EXCEPTION(sprokit::invalid_port_handle_exception,
+                   process->grab_input(process->output),
+                   "grabbing with an output port handle");
+
+  EXPECT_EXCEPTION(sprokit::invalid_port_handle_exception,
+                   process->push_output(process->input, sprokit::datum::empty_datum()),
+                   "pushing with an input port handle");
+
+  EXPECT_EXCEPTION(sprokit::missing_connection_exception,
+                   process->grab_input(process->input),
+                   "grabbing from an unconnected port handle");
+
+  EXPECT_EXCEPTION(sprokit::no_such_port_exception,
+                   process->resolve_input(sprokit::process::port_t("no_such_port")),
+                   "resolving a non-existent input port");
+
+  EXPECT_EXCEPTION(sprokit::no_such_port_exception,
+                   process->resolve_output(sprokit::process::port_t("no_such_port")),
+                   "resolving a non-existent output port");
+
+  // Pushing to an unconnected port is not an error.
+  process->push_output(process->output, sprokit::datum::empty_datum());
+
+  pipe->reset();
+
+  EXPECT_EXCEPTION(sprokit::invalid_port_handle_exception,
+                   process->grab_input(process->input),
+                   "grabbing with a handle after a reset");
+}
+
+IMPLEMENT_TEST(port_handle_connect_after_init)
+{
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  boost::shared_ptr<handle_process> const process = boost::make_shared<handle_process>(conf);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipe->add_process(process);
+  pipe->setup_pipeline();
+
+  sprokit::edge_t const edge = create_edge();
+
+  process->connect_output_port(handle_process::port_output, edge);
 
-  sprokit::process_t const process = create_process(proc_type);
+  process->push_output(process->output, sprokit::datum::empty_datum());
 
-  process->configure();
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("Pushing through a port handle did not reach an edge "
+               "connected after the handle was resolved");
+  }
 
-  EXPECT_EXCEPTION(sprokit::uninitialized_exception,
-                   process->step(),
-                   "stepping before initialization");
+  sprokit::edge_datum_t const edat = edge->get_datum();
+
+  if (!edat.stamp)
+  {
+    TEST_ERROR("The datum pushed through a port handle was not stamped");
+  }
 }
 
 IMPLEMENT_TEST(set_static_input_type)
@@ -518,6 +1133,268 @@ IMPLEMENT_TEST(add_output_port_after_type_pin)
   }
 }
 
+IMPLEMENT_TEST(requery_output_ports_before_type_pin)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("distribute");
+
+  sprokit::process::port_t const status = sprokit::process::port_t("status/");
+  sprokit::process::port_t const src = sprokit::process::port_t("src/");
+  sprokit::process::port_t const dist = sprokit::process::port_t("dist/");
+
+  sprokit::process::port_t const tag = sprokit::process::port_t("test");
+
+  sprokit::process::port_type_t const port_type = sprokit::process::port_type_t("type");
+
+  sprokit::process_t const process = create_process(proc_type);
+
+  (void)process->output_port_info(status + tag);
+
+  size_t const num_groups = 8;
+
+  // Query each port more than once before pinning the type.
+  for (size_t i = 0; i < 2 * num_groups; ++i)
+  {
+    sprokit::process::port_t const group = "/" + boost::lexical_cast<sprokit::process::port_t>(i % num_groups);
+
+    (void)process->output_port_info(dist + tag + group);
+  }
+
+  if (!process->set_input_port_type(src + tag, port_type))
+  {
+    TEST_ERROR("Could not set the source port type");
+  }
+
+  for (size_t i = 0; i < num_groups; ++i)
+  {
+    sprokit::process::port_t const group = "/" + boost::lexical_cast<sprokit::process::port_t>(i);
+
+    sprokit::process::port_info_t const info = process->output_port_info(dist + tag + group);
+
+    if (info->type != port_type)
+    {
+      TEST_ERROR("The output port " << group << " was not set to the new type");
+    }
+  }
+}
+
+IMPLEMENT_TEST(distribute_unknown_mode)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("distribute");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("mode", "unknown");
+
+  sprokit::process_t const process = create_process(proc_type, sprokit::process::name_t(), conf);
+
+  EXPECT_EXCEPTION(sprokit::invalid_configuration_value_exception,
+                   process->configure(),
+                   "configuring with an unknown distribution mode");
+}
+
+static void test_distribute_mode(sprokit::config::value_t const& mode);
+
+IMPLEMENT_TEST(distribute_shortest_queue)
+{
+  test_distribute_mode("shortest_queue");
+}
+
+IMPLEMENT_TEST(distribute_first_free)
+{
+  test_distribute_mode("first_free");
+}
+
+IMPLEMENT_TEST(collate_unknown_mode)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("collate");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("mode", "unknown");
+
+  sprokit::process_t const process = create_process(proc_type, sprokit::process::name_t(), conf);
+
+  EXPECT_EXCEPTION(sprokit::invalid_configuration_value_exception,
+                   process->configure(),
+                   "configuring with an unknown collation mode");
+}
+
+IMPLEMENT_TEST(collate_empty_reorder_window)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("collate");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("mode", "reorder");
+  conf->set_value("reorder_window", "0");
+
+  sprokit::process_t const process = create_process(proc_type, sprokit::process::name_t(), conf);
+
+  EXPECT_EXCEPTION(sprokit::invalid_configuration_value_exception,
+                   process->configure(),
+                   "configuring with an empty reorder window");
+}
+
+IMPLEMENT_TEST(collate_reorder)
+{
+  sprokit::process::name_t const num_name = sprokit::process::name_t("num");
+  sprokit::process::name_t const dist_name = sprokit::process::name_t("dist");
+  sprokit::process::name_t const pass_a_name = sprokit::process::name_t("pass_a");
+  sprokit::process::name_t const pass_b_name = sprokit::process::name_t("pass_b");
+  sprokit::process::name_t const coll_name = sprokit::process::name_t("coll");
+  sprokit::process::name_t const sink_name = sprokit::process::name_t("sink");
+
+  sprokit::config_t const coll_conf = sprokit::config::empty_config();
+
+  coll_conf->set_value("mode", "reorder");
+
+  sprokit::process_t const num = create_process("numbers", num_name);
+  sprokit::process_t const dist = create_process("distribute", dist_name);
+  sprokit::process_t const pass_a = create_process("pass", pass_a_name);
+  sprokit::process_t const pass_b = create_process("pass", pass_b_name);
+  sprokit::process_t const coll = create_process("collate", coll_name, coll_conf);
+  sprokit::process_t const sink = create_process("sink", sink_name);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipeline->add_process(num);
+  pipeline->add_process(dist);
+  pipeline->add_process(pass_a);
+  pipeline->add_process(pass_b);
+  pipeline->add_process(coll);
+  pipeline->add_process(sink);
+
+  pipeline->connect(dist_name, "status/test",
+                    coll_name, "status/test");
+  pipeline->connect(num_name, "number",
+                    dist_name, "src/test");
+  pipeline->connect(dist_name, "dist/test/a",
+                    pass_a_name, "pass");
+  pipeline->connect(dist_name, "dist/test/b",
+                    pass_b_name, "pass");
+  pipeline->connect(pass_a_name, "pass",
+                    coll_name, "coll/test/a");
+  pipeline->connect(pass_b_name, "pass",
+                    coll_name, "coll/test/b");
+  pipeline->connect(coll_name, "res/test",
+                    sink_name, "sink");
+
+  pipeline->setup_pipeline();
+
+  sprokit::edge_t const b_edge = pipeline->output_edges_for_port(pass_b_name, "pass")[0];
+  sprokit::edge_t const res_edge = pipeline->output_edges_for_port(coll_name, "res/test")[0];
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    num->step();
+    dist->step();
+  }
+
+  // The second branch finishes both of its data first.
+  pass_b->step();
+  pass_b->step();
+  pass_a->step();
+
+  coll->step();
+
+  // Results up to the missing one are sent; later ones are held back.
+  if (res_edge->datum_count() != 2)
+  {
+    TEST_ERROR("Collated " << res_edge->datum_count() << " results rather than 2");
+  }
+
+  if (b_edge->has_data())
+  {
+    TEST_ERROR("A result which had arrived was not taken into the reorder window");
+  }
+
+  pass_a->step();
+
+  coll->step();
+
+  for (int32_t i = 0; i < 4; ++i)
+  {
+    sprokit::edge_datum_t const edat = res_edge->get_datum();
+    int32_t const value = edat.datum->get_datum<int32_t>();
+
+    if (value != i)
+    {
+      TEST_ERROR("Collated " << value << " rather than " << i);
+    }
+  }
+}
+
+IMPLEMENT_TEST(sync_through_dropping_edge)
+{
+  sprokit::process::name_t const num1_name = sprokit::process::name_t("num1");
+  sprokit::process::name_t const num2_name = sprokit::process::name_t("num2");
+  sprokit::process::name_t const mult_name = sprokit::process::name_t("mult");
+  sprokit::process::name_t const sink_name = sprokit::process::name_t("sink");
+
+  sprokit::config_t const pipe_conf = sprokit::config::empty_config();
+
+  pipe_conf->set_value("_edge_by_conn:mult:down:factor2:capacity", "1");
+  pipe_conf->set_value("_edge_by_conn:mult:down:factor2:overflow_policy", "drop_oldest");
+
+  sprokit::process_t const num1 = create_process("numbers", num1_name);
+  sprokit::process_t const num2 = create_process("numbers", num2_name);
+  sprokit::process_t const mult = create_process("multiplication", mult_name);
+  sprokit::process_t const sink = create_process("sink", sink_name);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(pipe_conf);
+
+  pipeline->add_process(num1);
+  pipeline->add_process(num2);
+  pipeline->add_process(mult);
+  pipeline->add_process(sink);
+
+  pipeline->connect(num1_name, "number",
+                    mult_name, "factor1");
+  pipeline->connect(num2_name, "number",
+                    mult_name, "factor2");
+  pipeline->connect(mult_name, "product",
+                    sink_name, "sink");
+
+  pipeline->setup_pipeline();
+
+  sprokit::edge_t const product_edge = pipeline->output_edges_for_port(mult_name, "product")[0];
+
+  // The edge into the second factor drops all but the last of these.
+  step_times(num1, 3);
+  step_times(num2, 3);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    mult->step();
+
+    sprokit::datum::type_t const type = product_edge->get_datum().datum->type();
+
+    if (type == sprokit::datum::error)
+    {
+      TEST_ERROR("Inputs lost synchronization when an edge dropped data");
+
+      return;
+    }
+    else if (type != sprokit::datum::empty)
+    {
+      TEST_ERROR("Dropped data did not arrive as an empty datum");
+    }
+  }
+
+  mult->step();
+
+  sprokit::datum_t const dat = product_edge->get_datum().datum;
+
+  if (dat->type() != sprokit::datum::data)
+  {
+    TEST_ERROR("The process did not compute a result from data which was kept");
+  }
+  else if (dat->get_datum<int32_t>() != 4)
+  {
+    TEST_ERROR("The process computed " << dat->get_datum<int32_t>() << " rather than 4");
+  }
+}
+
 IMPLEMENT_TEST(set_untagged_flow_dependent_port)
 {
   sprokit::process::type_t const proc_type = sprokit::process::type_t("tagged_flow_dependent");
@@ -880,6 +1757,189 @@ create_edge()
   return edge;
 }
 
+void
+record_step(size_t* steps, bool* complete, bool proc_complete)
+{
+  ++*steps;
+  *complete = proc_complete;
+}
+
+void
+step_times(sprokit::process_t const& process, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    process->step();
+  }
+}
+
+sprokit::process::port_t const handle_process::port_input = port_t("input");
+sprokit::process::port_t const handle_process::port_output = port_t("output");
+
+handle_process
+::handle_process(sprokit::config_t const& config)
+  : sprokit::process(config)
+  , input()
+  , output()
+{
+  declare_input_port(
+    port_input,
+    "integer",
+    port_flags_t(),
+    port_description_t("input port"));
+  declare_output_port(
+    port_output,
+    "integer",
+    port_flags_t(),
+    port_description_t("output port"));
+}
+
+handle_process
+::~handle_process()
+{
+}
+
+sprokit::datum_t
+handle_process
+::grab_input(port_handle const& handle) const
+{
+  return grab_datum_from_port(handle);
+}
+
+void
+handle_process
+::push_output(port_handle const& handle, sprokit::datum_t const& dat) const
+{
+  push_datum_to_port(handle, dat);
+}
+
+sprokit::process::port_handle
+handle_process
+::resolve_input(port_t const& port)
+{
+  return input_port_handle(port);
+}
+
+sprokit::process::port_handle
+handle_process
+::resolve_output(port_t const& port)
+{
+  return output_port_handle(port);
+}
+
+void
+handle_process
+::_init()
+{
+  input = input_port_handle(port_input);
+  output = output_port_handle(port_output);
+
+  process::_init();
+}
+
+void
+handle_process
+::_step()
+{
+  push_to_port_as<int32_t>(output, grab_from_port_as<int32_t>(input));
+
+  process::_step();
+}
+
+sprokit::process::port_t const gated_process::port_input = port_t("input");
+sprokit::process::port_t const gated_process::port_output = port_t("output");
+
+gated_process
+::gated_process(sprokit::config_t const& config)
+  : sprokit::process(config)
+  , mut()
+  , cond()
+  , stepping(false)
+  , open(false)
+{
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_input_port(
+    port_input,
+    "integer",
+    required,
+    port_description_t("input port"));
+  declare_output_port(
+    port_output,
+    "integer",
+    required,
+    port_description_t("output port"));
+}
+
+gated_process
+::~gated_process()
+{
+}
+
+void
+gated_process
+::wait_for_step()
+{
+  boost::mutex::scoped_lock lock(mut);
+
+  while (!stepping)
+  {
+    cond.wait(lock);
+  }
+}
+
+void
+gated_process
+::open_gate()
+{
+  {
+    boost::mutex::scoped_lock const lock(mut);
+
+    (void)lock;
+
+    open = true;
+  }
+
+  cond.notify_all();
+}
+
+void
+gated_process
+::_step()
+{
+  sprokit::datum_t const dat = grab_datum_from_port(port_input);
+
+  {
+    boost::mutex::scoped_lock lock(mut);
+
+    stepping = true;
+
+    cond.notify_all();
+
+    while (!open)
+    {
+      cond.wait(lock);
+    }
+  }
+
+  push_datum_to_port(port_output, dat);
+
+  process::_step();
+}
+
+sprokit::process::properties_t
+gated_process
+::_properties() const
+{
+  properties_t consts = process::_properties();
+
+  consts.erase(property_no_reentrancy);
+
+  return consts;
+}
+
 null_config_process
 ::null_config_process(sprokit::config_t const& /*config*/)
   : sprokit::process(sprokit::config_t())
@@ -981,3 +2041,101 @@ ::_remove_output_port(port_t const& port)
 {
   remove_output_port(port);
 }
+
+void
+test_distribute_mode(sprokit::config::value_t const& mode)
+{
+  sprokit::process::name_t const num_name = sprokit::process::name_t("num");
+  sprokit::process::name_t const dist_name = sprokit::process::name_t("dist");
+  sprokit::process::name_t const pass_a_name = sprokit::process::name_t("pass_a");
+  sprokit::process::name_t const pass_b_name = sprokit::process::name_t("pass_b");
+  sprokit::process::name_t const coll_name = sprokit::process::name_t("coll");
+  sprokit::process::name_t const sink_name = sprokit::process::name_t("sink");
+
+  sprokit::config_t const dist_conf = sprokit::config::empty_config();
+
+  dist_conf->set_value("mode", mode);
+
+  sprokit::process_t const num = create_process("numbers", num_name);
+  sprokit::process_t const dist = create_process("distribute", dist_name, dist_conf);
+  sprokit::process_t const pass_a = create_process("pass", pass_a_name);
+  sprokit::process_t const pass_b = create_process("pass", pass_b_name);
+  sprokit::process_t const coll = create_process("collate", coll_name);
+  sprokit::process_t const sink = create_process("sink", sink_name);
+
+  sprokit::config_t const pipe_conf = sprokit::config::empty_config();
+
+  pipe_conf->set_value("_edge" + sprokit::config::block_sep + sprokit::edge::config_capacity, "2");
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(pipe_conf);
+
+  pipeline->add_process(num);
+  pipeline->add_process(dist);
+  pipeline->add_process(pass_a);
+  pipeline->add_process(pass_b);
+  pipeline->add_process(coll);
+  pipeline->add_process(sink);
+
+  pipeline->connect(dist_name, "status/test",
+                    coll_name, "status/test");
+  pipeline->connect(num_name, "number",
+                    dist_name, "src/test");
+  pipeline->connect(dist_name, "dist/test/a",
+                    pass_a_name, "pass");
+  pipeline->connect(dist_name, "dist/test/b",
+                    pass_b_name, "pass");
+  pipeline->connect(pass_a_name, "pass",
+                    coll_name, "coll/test/a");
+  pipeline->connect(pass_b_name, "pass",
+                    coll_name, "coll/test/b");
+  pipeline->connect(coll_name, "res/test",
+                    sink_name, "sink");
+
+  pipeline->setup_pipeline();
+
+  sprokit::edge_t const a_edge = pipeline->output_edges_for_port(dist_name, "dist/test/a")[0];
+  sprokit::edge_t const b_edge = pipeline->output_edges_for_port(dist_name, "dist/test/b")[0];
+  sprokit::edge_t const res_edge = pipeline->output_edges_for_port(coll_name, "res/test")[0];
+
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(1);
+  sprokit::edge_datum_t const edat = sprokit::edge_datum_t(sprokit::datum::new_datum<int32_t>(-1), stamp);
+
+  // Fill the first group's edge so that only the second has space.
+  a_edge->push_datum(edat);
+  a_edge->push_datum(edat);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    num->step();
+    dist->step();
+  }
+
+  if (a_edge->datum_count() != 2)
+  {
+    TEST_ERROR("Data was sent to the full output");
+  }
+
+  if (b_edge->datum_count() != 2)
+  {
+    TEST_ERROR("Data was not sent to the output with space");
+  }
+
+  // The collation must follow the distribution rather than taking turns.
+  for (int32_t i = 0; i < 2; ++i)
+  {
+    pass_b->step();
+    coll->step();
+
+    int32_t const value = res_edge->get_datum().datum->get_datum<int32_t>();
+
+    if (value != i)
+    {
+      TEST_ERROR("Collated " << value << " rather than " << i);
+    }
+  }
+
+  if (res_edge->has_data())
+  {
+    TEST_ERROR("More data was collated than was distributed");
+  }
+}
@@ -39,6 +39,8 @@
 
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+
 #define TEST_ARGS ()
 
 DECLARE_TEST_MAP();
@@ -158,6 +160,39 @@ IMPLEMENT_TEST(unknown_types)
                    "requesting an non-existent process type");
 }
 
+static void load_deferred_process();
+static size_t deferred_loads = 0;
+
+IMPLEMENT_TEST(deferred_types)
+{
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::type_t const deferred_process = sprokit::process::type_t("deferred_process");
+
+  reg->register_deferred_process(deferred_process, load_deferred_process);
+
+  sprokit::process::types_t const types = reg->types();
+
+  if (std::find(types.begin(), types.end(), deferred_process) == types.end())
+  {
+    TEST_ERROR("A deferred type is not listed as available");
+  }
+
+  if (deferred_loads)
+  {
+    TEST_ERROR("A deferred type was loaded before it was used");
+  }
+
+  reg->create_process(deferred_process, sprokit::process::name_t());
+  reg->create_process(deferred_process, sprokit::process::name_t());
+
+  if (deferred_loads != 1)
+  {
+    TEST_ERROR("A deferred type was loaded " << deferred_loads << " times "
+               "instead of once");
+  }
+}
+
 IMPLEMENT_TEST(module_marking)
 {
   sprokit::process_registry_t const reg = sprokit::process_registry::self();
@@ -214,3 +249,15 @@ null_process(sprokit::config_t const& /*config*/)
 {
   return sprokit::process_t();
 }
+
+void
+load_deferred_process()
+{
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::type_t const deferred_process = sprokit::process::type_t("deferred_process");
+
+  reg->register_process(deferred_process, sprokit::process_registry::description_t(), null_process);
+
+  ++deferred_loads;
+}
@@ -31,13 +31,21 @@
 #include <test_common.h>
 
 #include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/edge.h>
 #include <sprokit/pipeline/modules.h>
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/process.h>
 #include <sprokit/pipeline/process_registry.h>
 #include <sprokit/pipeline/scheduler.h>
+#include <sprokit/pipeline/scheduler_exception.h>
 #include <sprokit/pipeline/scheduler_registry.h>
 
+#include <boost/chrono/duration.hpp>
+// XXX(boost): 1.50.0
+#if BOOST_VERSION < 105000
+#include <boost/date_time/posix_time/posix_time.hpp>
+#endif
+#include <boost/thread/thread.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
@@ -75,6 +83,20 @@ main(int argc, char* argv[])
 static sprokit::process_t create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config = sprokit::config::empty_config());
 static sprokit::pipeline_t create_pipeline();
 
+class slow_pass_process
+  : public sprokit::process
+{
+  public:
+    slow_pass_process(sprokit::config_t const& config);
+    ~slow_pass_process();
+
+    static port_t const port_input;
+    static port_t const port_output;
+  protected:
+    void _step();
+    properties_t _properties() const;
+};
+
 IMPLEMENT_TEST(simple_pipeline)
 {
   sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
@@ -623,6 +645,253 @@ IMPLEMENT_TEST(frequency_pipeline)
   }
 }
 
+IMPLEMENT_TEST(replicated_pipeline)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("multiplication");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("print_number");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  std::string const output_path = "test-run-replicated_pipeline-" + scheduler_type + "-print_number.txt";
+
+  int32_t const start_value = 10;
+  int32_t const end_value = 50;
+
+  size_t const replicas = 3;
+
+  {
+    sprokit::config_t const configu = sprokit::config::empty_config();
+
+    sprokit::config::key_t const start_key = sprokit::config::key_t("start");
+    sprokit::config::key_t const end_key = sprokit::config::key_t("end");
+
+    sprokit::config::value_t const start_num = boost::lexical_cast<sprokit::config::value_t>(start_value);
+    sprokit::config::value_t const end_num = boost::lexical_cast<sprokit::config::value_t>(end_value);
+
+    configu->set_value(start_key, start_num);
+    configu->set_value(end_key, end_num);
+
+    sprokit::config_t const configd = sprokit::config::empty_config();
+
+    sprokit::config::value_t const replicas_value = boost::lexical_cast<sprokit::config::value_t>(replicas);
+
+    configd->set_value(sprokit::process::config_replicas, replicas_value);
+
+    sprokit::config_t const configt = sprokit::config::empty_config();
+
+    sprokit::config::key_t const output_key = sprokit::config::key_t("output");
+    sprokit::config::value_t const output_value = sprokit::config::value_t(output_path);
+
+    configt->set_value(output_key, output_value);
+
+    sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+    sprokit::process_t const processd = create_process(proc_typed, proc_named, configd);
+    sprokit::process_t const processt = create_process(proc_typet, proc_namet, configt);
+
+    sprokit::pipeline_t const pipeline = create_pipeline();
+
+    pipeline->add_process(processu);
+    pipeline->add_process(processd);
+    pipeline->add_process(processt);
+
+    sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+    sprokit::process::port_t const port_named1 = sprokit::process::port_t("factor1");
+    sprokit::process::port_t const port_named2 = sprokit::process::port_t("factor2");
+    sprokit::process::port_t const port_namedo = sprokit::process::port_t("product");
+    sprokit::process::port_t const port_namet = sprokit::process::port_t("number");
+
+    pipeline->connect(proc_nameu, port_nameu,
+                      proc_named, port_named1);
+    pipeline->connect(proc_nameu, port_nameu,
+                      proc_named, port_named2);
+    pipeline->connect(proc_named, port_namedo,
+                      proc_namet, port_namet);
+
+    pipeline->setup_pipeline();
+
+    sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+    // The synchronous scheduler cannot run the distribute and collate processes
+    // which feed the replicas.
+    if (scheduler_type == "sync")
+    {
+      EXPECT_EXCEPTION(sprokit::incompatible_pipeline_exception,
+                       reg->create_scheduler(scheduler_type, pipeline),
+                       "running a replicated process with the sync scheduler");
+
+      return;
+    }
+
+    sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline);
+
+    scheduler->start();
+    scheduler->wait();
+  }
+
+  std::ifstream fin(output_path.c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the output file");
+  }
+
+  std::string line;
+
+  for (int32_t i = start_value; i < end_value; ++i)
+  {
+    if (!std::getline(fin, line))
+    {
+      TEST_ERROR("Failed to read a line from the file");
+    }
+
+    if (sprokit::config::value_t(line) != boost::lexical_cast<sprokit::config::value_t>(i * i))
+    {
+      TEST_ERROR("Did not get expected value: "
+                 "Expected: " << i * i << " "
+                 "Received: " << line);
+    }
+  }
+
+  if (std::getline(fin, line))
+  {
+    TEST_ERROR("More results than expected in the file");
+  }
+
+  if (!fin.eof())
+  {
+    TEST_ERROR("Not at end of file");
+  }
+}
+
+IMPLEMENT_TEST(reentrant_chain_pipeline)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("print_number");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namep1 = sprokit::process::name_t("first");
+  sprokit::process::name_t const proc_namep2 = sprokit::process::name_t("second");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  std::string const output_path = "test-run-reentrant_chain_pipeline-" + scheduler_type + "-print_number.txt";
+
+  int32_t const start_value = 0;
+  int32_t const end_value = 100;
+
+  {
+    sprokit::config_t const configu = sprokit::config::empty_config();
+
+    sprokit::config::key_t const start_key = sprokit::config::key_t("start");
+    sprokit::config::key_t const end_key = sprokit::config::key_t("end");
+
+    sprokit::config::value_t const start_num = boost::lexical_cast<sprokit::config::value_t>(start_value);
+    sprokit::config::value_t const end_num = boost::lexical_cast<sprokit::config::value_t>(end_value);
+
+    configu->set_value(start_key, start_num);
+    configu->set_value(end_key, end_num);
+
+    sprokit::config_t const configp1 = sprokit::config::empty_config();
+    sprokit::config_t const configp2 = sprokit::config::empty_config();
+
+    configp1->set_value(sprokit::process::config_name, proc_namep1);
+    configp2->set_value(sprokit::process::config_name, proc_namep2);
+
+    sprokit::config_t const configt = sprokit::config::empty_config();
+
+    sprokit::config::key_t const output_key = sprokit::config::key_t("output");
+    sprokit::config::value_t const output_value = sprokit::config::value_t(output_path);
+
+    configt->set_value(output_key, output_value);
+
+    sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+    sprokit::process_t const processp1 = boost::make_shared<slow_pass_process>(configp1);
+    sprokit::process_t const processp2 = boost::make_shared<slow_pass_process>(configp2);
+    sprokit::process_t const processt = create_process(proc_typet, proc_namet, configt);
+
+    // The edges feeding the reentrant processes are deep enough for several
+    // of their steps to be in flight at once, but the terminal process only
+    // has room for a single datum, so those steps contend for the space.
+    sprokit::config_t const pipe_conf = sprokit::config::empty_config();
+
+    pipe_conf->set_value("_edge:capacity", "4");
+    pipe_conf->set_value("_edge_by_conn:terminal:down:number:capacity", "1");
+
+    sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(pipe_conf);
+
+    pipeline->add_process(processu);
+    pipeline->add_process(processp1);
+    pipeline->add_process(processp2);
+    pipeline->add_process(processt);
+
+    sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+    sprokit::process::port_t const port_namet = sprokit::process::port_t("number");
+
+    pipeline->connect(proc_nameu, port_nameu,
+                      proc_namep1, slow_pass_process::port_input);
+    pipeline->connect(proc_namep1, slow_pass_process::port_output,
+                      proc_namep2, slow_pass_process::port_input);
+    pipeline->connect(proc_namep2, slow_pass_process::port_output,
+                      proc_namet, port_namet);
+
+    pipeline->setup_pipeline();
+
+    if (!processp1->is_reentrant() || !processp2->is_reentrant())
+    {
+      TEST_ERROR("The pass processes are not reentrant");
+    }
+
+    // Enough workers for both reentrant processes to have several steps in
+    // flight while the terminal process still needs a worker to drain them.
+    sprokit::config_t const sched_conf = sprokit::config::empty_config();
+
+    sched_conf->set_value("num_threads", "5");
+
+    sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+    sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline, sched_conf);
+
+    scheduler->start();
+    scheduler->wait();
+  }
+
+  std::ifstream fin(output_path.c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the output file");
+  }
+
+  std::string line;
+
+  for (int32_t i = start_value; i < end_value; ++i)
+  {
+    if (!std::getline(fin, line))
+    {
+      TEST_ERROR("Failed to read a line from the file");
+    }
+
+    if (sprokit::config::value_t(line) != boost::lexical_cast<sprokit::config::value_t>(i))
+    {
+      TEST_ERROR("Did not get expected value: "
+                 "Expected: " << i << " "
+                 "Received: " << line);
+    }
+  }
+
+  if (std::getline(fin, line))
+  {
+    TEST_ERROR("More results than expected in the file");
+  }
+
+  if (!fin.eof())
+  {
+    TEST_ERROR("Not at end of file");
+  }
+}
+
 sprokit::process_t
 create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config)
 {
@@ -639,3 +908,61 @@ create_pipeline()
 {
   return boost::make_shared<sprokit::pipeline>();
 }
+
+sprokit::process::port_t const slow_pass_process::port_input = port_t("input");
+sprokit::process::port_t const slow_pass_process::port_output = port_t("output");
+
+slow_pass_process
+::slow_pass_process(sprokit::config_t const& config)
+  : sprokit::process(config)
+{
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_input_port(
+    port_input,
+    "integer",
+    required,
+    port_description_t("The input port."));
+  declare_output_port(
+    port_output,
+    "integer",
+    required,
+    port_description_t("The output port."));
+}
+
+slow_pass_process
+::~slow_pass_process()
+{
+}
+
+void
+slow_pass_process
+::_step()
+{
+  sprokit::edge_datum_t const edat = grab_from_port(port_input);
+
+  // Give the other steps in flight a chance to run.
+  // XXX(boost): 1.50.0
+#if BOOST_VERSION < 105000
+  boost::this_thread::sleep(boost::posix_time::milliseconds(2));
+#else
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(2));
+#endif
+
+  push_datum_to_port(port_output, edat.datum);
+
+  process::_step();
+}
+
+sprokit::process::properties_t
+slow_pass_process
+::_properties() const
+{
+  properties_t consts = process::_properties();
+
+  consts.erase(property_no_reentrancy);
+
+  return consts;
+}
@@ -35,11 +35,14 @@
 #include <sprokit/pipeline/modules.h>
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/pipeline_exception.h>
+#include <sprokit/pipeline/process_cluster.h>
 #include <sprokit/pipeline/process_registry.h>
 #include <sprokit/pipeline/scheduler.h>
 #include <sprokit/pipeline/scheduler_exception.h>
 #include <sprokit/pipeline/scheduler_registry.h>
+#include <sprokit/pipeline/utils.h>
 
+#include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 
 #define TEST_ARGS ()
@@ -64,6 +67,7 @@ class null_scheduler
     virtual ~null_scheduler();
 
     void reset_pipeline() const;
+    sprokit::cpu_ids_t affinity_for(sprokit::process::name_t const& name) const;
   protected:
     void _start();
     void _wait();
@@ -200,6 +204,22 @@ IMPLEMENT_TEST(wait_before_start_scheduler)
                    "waiting on a scheduler before it is started");
 }
 
+TEST_PROPERTY(ENVIRONMENT, SPROKIT_STATISTICS_PATH=@CMAKE_CURRENT_BINARY_DIR@/no_such_directory/statistics.json)
+IMPLEMENT_TEST(statistics_write_failure)
+{
+  sprokit::scheduler_t const sched = create_minimal_scheduler();
+
+  sched->start();
+
+#ifdef SPROKIT_ENABLE_INSTRUMENTATION
+  EXPECT_EXCEPTION(sprokit::statistics_write_exception,
+                   sched->wait(),
+                   "writing statistics to a path which cannot be created");
+#else
+  sched->wait();
+#endif
+}
+
 IMPLEMENT_TEST(stop_before_start_scheduler)
 {
   sprokit::scheduler_t const sched = create_minimal_scheduler();
@@ -243,6 +263,100 @@ IMPLEMENT_TEST(restart)
   sched->start();
 }
 
+IMPLEMENT_TEST(cpu_list)
+{
+  sprokit::cpu_ids_opt_t const cpus = sprokit::parse_cpu_list("8, 0-2,1");
+
+  sprokit::cpu_ids_t expected;
+
+  expected.push_back(0);
+  expected.push_back(1);
+  expected.push_back(2);
+  expected.push_back(8);
+
+  if (!cpus || (*cpus != expected))
+  {
+    TEST_ERROR("A processor list was not parsed as expected");
+  }
+
+  char const* const invalid[] = {"", "a", "-1", "3-1", "0--2", "1,,2", "70000"};
+
+  BOOST_FOREACH (char const* const list, invalid)
+  {
+    if (sprokit::parse_cpu_list(list))
+    {
+      TEST_ERROR("An invalid processor list was accepted: " << list);
+    }
+  }
+}
+
+IMPLEMENT_TEST(invalid_affinity)
+{
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>();
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("affinity:name", "3-1");
+
+  EXPECT_EXCEPTION(sprokit::invalid_affinity_exception,
+                   boost::make_shared<null_scheduler>(pipe, conf),
+                   "passing an invalid processor list to a scheduler");
+}
+
+class affinity_cluster
+  : public sprokit::process_cluster
+{
+  public:
+    affinity_cluster(sprokit::config_t const& conf);
+    ~affinity_cluster();
+};
+
+IMPLEMENT_TEST(affinity)
+{
+  sprokit::load_known_modules();
+
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::name_t const cluster_name = sprokit::process::name_t("cluster");
+
+  sprokit::config_t const cluster_conf = sprokit::config::empty_config();
+
+  cluster_conf->set_value(sprokit::process::config_name, cluster_name);
+
+  sprokit::process_t const proc = reg->create_process("orphan", "name");
+  sprokit::process_t const other = reg->create_process("orphan", "other");
+  sprokit::process_t const cluster = boost::make_shared<affinity_cluster>(cluster_conf);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>();
+
+  pipe->add_process(proc);
+  pipe->add_process(other);
+  pipe->add_process(cluster);
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("affinity", "0");
+  conf->set_value("affinity:name", "1-2");
+  conf->set_value("affinity:cluster", "3");
+
+  boost::shared_ptr<null_scheduler> const sched = boost::make_shared<null_scheduler>(pipe, conf);
+
+  if (sched->affinity_for("name") != sprokit::parse_cpu_list("1-2"))
+  {
+    TEST_ERROR("The affinity for a process was not used");
+  }
+
+  if (sched->affinity_for("other") != sprokit::parse_cpu_list("0"))
+  {
+    TEST_ERROR("The default affinity was not used for a process");
+  }
+
+  if (sched->affinity_for("cluster/child") != sprokit::parse_cpu_list("3"))
+  {
+    TEST_ERROR("The affinity for a cluster was not used for its process");
+  }
+}
+
 sprokit::scheduler_t
 create_scheduler(sprokit::scheduler_registry::type_t const& type)
 {
@@ -296,6 +410,13 @@ ::reset_pipeline() const
   pipeline()->setup_pipeline();
 }
 
+sprokit::cpu_ids_t
+null_scheduler
+::affinity_for(sprokit::process::name_t const& name) const
+{
+  return affinity(name);
+}
+
 void
 null_scheduler
 ::_start()
@@ -347,3 +468,15 @@ null_pipeline_scheduler
 ::~null_pipeline_scheduler()
 {
 }
+
+affinity_cluster
+::affinity_cluster(sprokit::config_t const& conf)
+  : sprokit::process_cluster(conf)
+{
+  add_process("child", "orphan");
+}
+
+affinity_cluster
+::~affinity_cluster()
+{
+}
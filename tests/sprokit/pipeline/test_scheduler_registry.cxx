@@ -41,6 +41,8 @@
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 
+#include <algorithm>
+
 #define TEST_ARGS ()
 
 DECLARE_TEST_MAP();
@@ -181,6 +183,45 @@ IMPLEMENT_TEST(unknown_types)
                    "requesting an non-existent scheduler type");
 }
 
+static void load_deferred_scheduler();
+static size_t deferred_loads = 0;
+
+IMPLEMENT_TEST(deferred_types)
+{
+  sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+  sprokit::scheduler_registry::type_t const deferred_scheduler = sprokit::scheduler_registry::type_t("deferred_scheduler");
+
+  reg->register_deferred_scheduler(deferred_scheduler, load_deferred_scheduler);
+
+  sprokit::scheduler_registry::types_t const types = reg->types();
+
+  if (std::find(types.begin(), types.end(), deferred_scheduler) == types.end())
+  {
+    TEST_ERROR("A deferred type is not listed as available");
+  }
+
+  if (deferred_loads)
+  {
+    TEST_ERROR("A deferred type was loaded before it was used");
+  }
+
+  if (reg->description(deferred_scheduler) != "deferred")
+  {
+    TEST_ERROR("The description of a deferred type was not loaded");
+  }
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>();
+
+  reg->create_scheduler(deferred_scheduler, pipe);
+
+  if (deferred_loads != 1)
+  {
+    TEST_ERROR("A deferred type was loaded " << deferred_loads << " times "
+               "instead of once");
+  }
+}
+
 IMPLEMENT_TEST(module_marking)
 {
   sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
@@ -207,3 +248,15 @@ null_scheduler(sprokit::pipeline_t const& /*pipeline*/, sprokit::config_t const&
 {
   return sprokit::scheduler_t();
 }
+
+void
+load_deferred_scheduler()
+{
+  sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+  sprokit::scheduler_registry::type_t const deferred_scheduler = sprokit::scheduler_registry::type_t("deferred_scheduler");
+
+  reg->register_scheduler(deferred_scheduler, sprokit::scheduler_registry::description_t("deferred"), null_scheduler);
+
+  ++deferred_loads;
+}
@@ -38,10 +38,15 @@
 #include <sprokit/pipeline/config.h>
 #include <sprokit/pipeline/modules.h>
 
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/variant.hpp>
 
 #include <algorithm>
+#include <iterator>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include <cstddef>
@@ -459,6 +464,146 @@ IMPLEMENT_TEST(connect_output_with_slash)
   v.expect(0, 0, 1, 0);
 }
 
+static size_t cache_file_count(sprokit::path_t const& cache_dir);
+static bool replace_keeping_cached_hash(sprokit::path_t const& cache_dir, sprokit::path_t const& fname);
+
+IMPLEMENT_TEST(cache_include)
+{
+  sprokit::path_t const dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  sprokit::path_t const cache_dir = dir / "cache";
+  sprokit::path_t const include_file = dir / ("include" + pipe_ext);
+  sprokit::path_t const included_file = dir / ("config_block" + pipe_ext);
+
+  boost::filesystem::create_directories(dir);
+
+  boost::filesystem::copy_file(pipe_file.parent_path() / include_file.filename(), include_file);
+  boost::filesystem::copy_file(pipe_file.parent_path() / included_file.filename(), included_file);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    // Once the cache exists, the source no longer parses, so the last load
+    // must be served from the cache.
+    if ((i == 2) && !replace_keeping_cached_hash(cache_dir, include_file))
+    {
+      TEST_ERROR("The hash of the pipeline was not found in the cache");
+    }
+
+    sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks_from_file(include_file, cache_dir);
+
+    test_visitor v;
+
+    std::for_each(blocks.begin(), blocks.end(), boost::apply_visitor(v));
+
+    v.expect(1, 0, 0, 0);
+
+    if (cache_file_count(cache_dir) != 1)
+    {
+      TEST_ERROR("The pipeline was not cached");
+    }
+  }
+
+  boost::filesystem::remove_all(dir);
+}
+
+IMPLEMENT_TEST(cache_include_changed)
+{
+  (void)pipe_file;
+
+  sprokit::path_t const dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  sprokit::path_t const cache_dir = dir / "cache";
+  sprokit::path_t const main_file = dir / ("main" + pipe_ext);
+  sprokit::path_t const included_file = dir / ("included" + pipe_ext);
+
+  boost::filesystem::create_directories(dir);
+
+  {
+    boost::filesystem::ofstream fout(main_file);
+
+    fout << "!include included" << pipe_ext << std::endl;
+  }
+
+  {
+    boost::filesystem::ofstream fout(included_file);
+
+    fout << "config block" << std::endl;
+    fout << "  :key value" << std::endl;
+  }
+
+  sprokit::load_pipe_blocks_from_file(main_file, cache_dir);
+
+  {
+    boost::filesystem::ofstream fout(included_file);
+
+    fout << "process name" << std::endl;
+    fout << "  :: type" << std::endl;
+  }
+
+  sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks_from_file(main_file, cache_dir);
+
+  test_visitor v;
+
+  std::for_each(blocks.begin(), blocks.end(), boost::apply_visitor(v));
+
+  v.expect(0, 1, 0, 0);
+
+  boost::filesystem::remove_all(dir);
+}
+
+IMPLEMENT_TEST(cache_cluster)
+{
+  sprokit::path_t const dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  sprokit::path_t const cache_dir = dir / "cache";
+  sprokit::path_t const cluster_file = dir / ("cluster_all" + pipe_ext);
+
+  boost::filesystem::create_directories(dir);
+
+  boost::filesystem::copy_file(pipe_file.parent_path() / cluster_file.filename(), cluster_file);
+
+  sprokit::cluster_blocks const blocks = sprokit::load_cluster_blocks_from_file(cluster_file);
+
+  sprokit::load_cluster_blocks_from_file(cluster_file, cache_dir);
+
+  // The source no longer parses, so this load must be served from the cache.
+  if (!replace_keeping_cached_hash(cache_dir, cluster_file))
+  {
+    TEST_ERROR("The hash of the cluster was not found in the cache");
+  }
+
+  sprokit::cluster_blocks const cached_blocks = sprokit::load_cluster_blocks_from_file(cluster_file, cache_dir);
+
+  if (cache_file_count(cache_dir) != 1)
+  {
+    TEST_ERROR("The cluster was not cached");
+  }
+
+  test_visitor v;
+
+  std::for_each(cached_blocks.begin(), cached_blocks.end(), boost::apply_visitor(v));
+
+  v.expect(0, 0, 0, 1);
+
+  sprokit::cluster_pipe_block const& block = boost::get<sprokit::cluster_pipe_block>(blocks[0]);
+  sprokit::cluster_pipe_block const& cached_block = boost::get<sprokit::cluster_pipe_block>(cached_blocks[0]);
+
+  if (block.type != cached_block.type)
+  {
+    TEST_ERROR("The type of the cached cluster does not match");
+  }
+
+  if (block.description != cached_block.description)
+  {
+    TEST_ERROR("The description of the cached cluster does not match");
+  }
+
+  if (block.subblocks.size() != cached_block.subblocks.size())
+  {
+    TEST_ERROR("The cached cluster has " << cached_block.subblocks.size() << " "
+               "subblocks rather than " << block.subblocks.size());
+  }
+
+  boost::filesystem::remove_all(dir);
+}
+
 test_visitor
 ::test_visitor()
   : config_count(0)
@@ -603,3 +748,86 @@ ::print_char(block_type_t type)
 
   std::cerr << c;
 }
+
+size_t
+cache_file_count(sprokit::path_t const& cache_dir)
+{
+  boost::system::error_code ec;
+
+  if (!boost::filesystem::is_directory(cache_dir, ec))
+  {
+    return 0;
+  }
+
+  return size_t(std::distance(boost::filesystem::directory_iterator(cache_dir), boost::filesystem::directory_iterator()));
+}
+
+static boost::uint64_t fnv1a_file(sprokit::path_t const& fname);
+
+bool
+replace_keeping_cached_hash(sprokit::path_t const& cache_dir, sprokit::path_t const& fname)
+{
+  boost::uint64_t const old_hash = fnv1a_file(fname);
+
+  {
+    boost::filesystem::ofstream fout(fname);
+
+    fout << "this is not a pipeline" << std::endl;
+  }
+
+  boost::uint64_t const new_hash = fnv1a_file(fname);
+
+  // Cache files record the hash of each dependency in native byte order.
+  std::string const old_bytes(reinterpret_cast<char const*>(&old_hash), sizeof(old_hash));
+  std::string const new_bytes(reinterpret_cast<char const*>(&new_hash), sizeof(new_hash));
+
+  bool found = false;
+
+  boost::filesystem::directory_iterator const end;
+
+  for (boost::filesystem::directory_iterator i(cache_dir); i != end; ++i)
+  {
+    std::string data;
+
+    {
+      boost::filesystem::ifstream fin(i->path(), std::ios_base::in | std::ios_base::binary);
+
+      data.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    }
+
+    std::string::size_type const pos = data.find(old_bytes);
+
+    if (pos == std::string::npos)
+    {
+      continue;
+    }
+
+    data.replace(pos, new_bytes.size(), new_bytes);
+
+    boost::filesystem::ofstream fout(i->path(), std::ios_base::out | std::ios_base::binary);
+
+    fout.write(data.data(), data.size());
+
+    found = true;
+  }
+
+  return found;
+}
+
+boost::uint64_t
+fnv1a_file(sprokit::path_t const& fname)
+{
+  boost::filesystem::ifstream fin(fname, std::ios_base::in | std::ios_base::binary);
+
+  std::string const data((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+  boost::uint64_t hash = 0xcbf29ce484222325ULL;
+
+  for (std::string::const_iterator i = data.begin(); i != data.end(); ++i)
+  {
+    hash ^= static_cast<unsigned char>(*i);
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}